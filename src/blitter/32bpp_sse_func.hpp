@@ -202,6 +202,70 @@ INTERNAL_LINKAGE inline __m128i AdjustBrightnessOfTwoPixels([[maybe_unused]] __m
 #endif
 }
 
+#if (SSE_VERSION >= 5)
+/* The AVX2 functions below handle 8 pixels at once. Unpacking and packing work within
+ * each of the two 128 bit lanes, so they do the same as their SSE counterparts do for
+ * 2 pixels, four times over, and the pixels end up in their original order.
+ */
+
+/* Alpha blend 4 pixels of which the channels have been expanded into uint16. */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i AlphaBlendExpandedPixels(__m256i srcAB, __m256i dstAB, const __m256i &distribution_mask, const __m256i &alpha_mask)
+{
+	__m256i alphaMaskAB = _mm256_cmpgt_epi16(srcAB, _mm256_setzero_si256()); // (alpha > 0) ? 0xFFFF : 0
+	__m256i alphaAB = _mm256_sub_epi16(srcAB, alphaMaskAB);                  // if (alpha > 0) a++;
+	alphaAB = _mm256_shuffle_epi8(alphaAB, distribution_mask);
+
+	srcAB = _mm256_sub_epi16(srcAB, dstAB);     //    (r - Cr)
+	srcAB = _mm256_mullo_epi16(srcAB, alphaAB); //  a*(r - Cr)
+	srcAB = _mm256_srli_epi16(srcAB, 8);        //  a*(r - Cr)/256
+	srcAB = _mm256_add_epi16(srcAB, dstAB);     //  a*(r - Cr)/256 + Cr
+
+	alphaMaskAB = _mm256_and_si256(alphaMaskAB, alpha_mask); // set non alpha fields to 0
+	return _mm256_or_si256(srcAB, alphaMaskAB);              // set alpha fields to 0xFFFF if src alpha was > 0
+}
+
+/* Alpha blend 8 pixels, like AlphaBlendTwoPixels(). */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i AlphaBlendEightPixels(__m256i src, __m256i dst, const __m256i &distribution_mask, const __m256i &clear_hi, const __m256i &alpha_mask)
+{
+	__m256i lo = AlphaBlendExpandedPixels(_mm256_unpacklo_epi8(src, _mm256_setzero_si256()), _mm256_unpacklo_epi8(dst, _mm256_setzero_si256()), distribution_mask, alpha_mask);
+	__m256i hi = AlphaBlendExpandedPixels(_mm256_unpackhi_epi8(src, _mm256_setzero_si256()), _mm256_unpackhi_epi8(dst, _mm256_setzero_si256()), distribution_mask, alpha_mask);
+
+	/* Wipe the high bytes to keep the low bytes when packing, as the blending leaves garbage in them. */
+	return _mm256_packus_epi16(_mm256_and_si256(lo, clear_hi), _mm256_and_si256(hi, clear_hi));
+}
+
+/* Darken 8 pixels, like DarkenTwoPixels(). */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i DarkenEightPixels(__m256i src, __m256i dst, const __m256i &distribution_mask, const __m256i &tr_nom_base)
+{
+	__m256i alphaLo = _mm256_shuffle_epi8(_mm256_unpacklo_epi8(src, _mm256_setzero_si256()), distribution_mask);
+	__m256i alphaHi = _mm256_shuffle_epi8(_mm256_unpackhi_epi8(src, _mm256_setzero_si256()), distribution_mask);
+	__m256i nomLo = _mm256_sub_epi16(tr_nom_base, _mm256_srli_epi16(alphaLo, 2));
+	__m256i nomHi = _mm256_sub_epi16(tr_nom_base, _mm256_srli_epi16(alphaHi, 2));
+	__m256i dstLo = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, _mm256_setzero_si256()), nomLo), 8);
+	__m256i dstHi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, _mm256_setzero_si256()), nomHi), 8);
+	return _mm256_packus_epi16(dstLo, dstHi);
+}
+
+/* Get a mask of the 8 pixels that are not fully transparent. */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m256i VisibleEightPixels(__m256i src)
+{
+	__m256i transparent = _mm256_cmpeq_epi32(_mm256_srli_epi32(src, 24), _mm256_setzero_si256());
+	return _mm256_xor_si256(transparent, _mm256_set1_epi32(-1));
+}
+
+/* Narrow a mask of 8 pixels to a mask of 8 uint16, e.g. for the animation buffer. */
+GNU_TARGET(SSE_TARGET)
+INTERNAL_LINKAGE inline __m128i NarrowEightPixelMask(__m256i mask)
+{
+	__m256i packed = _mm256_packs_epi32(mask, mask); // Each lane has its 4 uint16 twice.
+	return _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, 0x08));
+}
+#endif /* SSE_VERSION >= 5 */
+
 #if FULL_ANIMATION == 0
 /**
  * Draws a sprite to a (screen) buffer. It is templated to allow faster operation.
@@ -219,6 +283,8 @@ inline void Blitter_32bppSSE2::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 inline void Blitter_32bppSSSE3::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+inline void Blitter_32bppAVX2::Draw(const Blitter::BlitterParams *bp, ZoomLevel zoom)
 #endif
 {
 	const uint8_t * const remap = bp->remap;
@@ -255,6 +321,13 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 	#define DARKEN_PARAM_2      tr_nom_base
 #endif
 	const __m128i tr_nom_base = TRANSPARENT_NOM_BASE;
+#if (SSE_VERSION >= 5)
+	const __m256i a_cm_8        = _mm256_broadcastsi128_si256(ALPHA_CONTROL_MASK);
+	const __m256i clear_hi_8    = _mm256_broadcastsi128_si256(CLEAR_HIGH_BYTE_MASK);
+	const __m256i alpha_and_8   = _mm256_broadcastsi128_si256(ALPHA_AND_MASK);
+	const __m256i tr_nom_base_8 = _mm256_broadcastsi128_si256(TRANSPARENT_NOM_BASE);
+	const __m128i m_mask        = _mm_set1_epi16(0x00FF);
+#endif
 
 	for (int y = bp->height; y != 0; y--) {
 		Colour *dst = dst_line;
@@ -277,7 +350,18 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 		switch (mode) {
 			default:
 				if (!translucent) {
+#if (SSE_VERSION >= 5)
+					for (uint x = (uint) effective_width / 8; x > 0; x--) {
+						__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+						__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+						_mm256_storeu_si256((__m256i*) dst, _mm256_blendv_epi8(dstABCD, srcABCD, VisibleEightPixels(srcABCD)));
+						src += 8;
+						dst += 8;
+					}
+					for (uint x = (uint) effective_width % 8; x > 0; x--) {
+#else
 					for (uint x = (uint) effective_width; x > 0; x--) {
+#endif
 						if (src->a) *dst = *src;
 						src++;
 						dst++;
@@ -285,7 +369,18 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 					break;
 				}
 
+#if (SSE_VERSION >= 5)
+				for (uint x = (uint) effective_width / 8; x > 0; x--) {
+					__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+					__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+					_mm256_storeu_si256((__m256i*) dst, AlphaBlendEightPixels(srcABCD, dstABCD, a_cm_8, clear_hi_8, alpha_and_8));
+					src += 8;
+					dst += 8;
+				}
+				for (uint x = ((uint) effective_width % 8) / 2; x > 0; x--) {
+#else
 				for (uint x = (uint) effective_width / 2; x > 0; x--) {
+#endif
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i*) dst, AlphaBlendTwoPixels(srcABCD, dstABCD, ALPHA_BLEND_PARAM_1, ALPHA_BLEND_PARAM_2, ALPHA_BLEND_PARAM_3));
@@ -303,6 +398,19 @@ inline void Blitter_32bppSSE4::Draw(const Blitter::BlitterParams *bp, ZoomLevel
 			case BM_COLOUR_REMAP:
 #if (SSE_VERSION >= 3)
 				for (uint x = (uint) effective_width / 2; x > 0; x--) {
+#if (SSE_VERSION >= 5)
+					/* Blend 8 pixels at once when there is nothing to remap in them. */
+					if (x >= 4 && _mm_test_all_zeros(_mm_loadu_si128((const __m128i*) src_mv), m_mask)) {
+						__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+						__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+						_mm256_storeu_si256((__m256i*) dst, AlphaBlendEightPixels(srcABCD, dstABCD, a_cm_8, clear_hi_8, alpha_and_8));
+						dst += 8;
+						src += 8;
+						src_mv += 8;
+						x -= 3; // The loop itself counts the fourth pair.
+						continue;
+					}
+#endif
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					uint32_t mvX2 = *((uint32_t *) const_cast<MapValue *>(src_mv));
@@ -384,7 +492,18 @@ bmcr_alpha_blend_single:
 
 			case BM_TRANSPARENT:
 				/* Make the current colour a bit more black, so it looks like this image is transparent. */
+#if (SSE_VERSION >= 5)
+				for (uint x = (uint) bp->width / 8; x > 0; x--) {
+					__m256i srcABCD = _mm256_loadu_si256((const __m256i*) src);
+					__m256i dstABCD = _mm256_loadu_si256((__m256i*) dst);
+					_mm256_storeu_si256((__m256i*) dst, DarkenEightPixels(srcABCD, dstABCD, a_cm_8, tr_nom_base_8));
+					src += 8;
+					dst += 8;
+				}
+				for (uint x = ((uint) bp->width % 8) / 2; x > 0; x--) {
+#else
 				for (uint x = (uint) bp->width / 2; x > 0; x--) {
+#endif
 					__m128i srcABCD = _mm_loadl_epi64((const __m128i*) src);
 					__m128i dstABCD = _mm_loadl_epi64((__m128i*) dst);
 					_mm_storel_epi64((__m128i *) dst, DarkenTwoPixels(srcABCD, dstABCD, DARKEN_PARAM_1, DARKEN_PARAM_2));
@@ -461,6 +580,8 @@ void Blitter_32bppSSE2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomL
 void Blitter_32bppSSSE3::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #elif (SSE_VERSION == 4)
 void Blitter_32bppSSE4::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
+#elif (SSE_VERSION == 5)
+void Blitter_32bppAVX2::Draw(Blitter::BlitterParams *bp, BlitterMode mode, ZoomLevel zoom)
 #endif
 {
 	switch (mode) {
@@ -0,0 +1,612 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file blitbench.cpp Benchmark and check of the blitters.
+ *
+ * A fixed set of generated sprites, and optionally the sprites of GRF files loaded
+ * via the sprite loader, is encoded for every blitter, and then drawn at every zoom
+ * level in every blitter mode into a buffer in memory. What is drawn is compared
+ * with what the simple blitter of the same colour depth draws, and the time the
+ * drawing takes is measured. Both are reported as JSON, so the blitters, e.g. the
+ * SSE4 and AVX2 variants of the same blitter, can be compared by scripts.
+ */
+
+#include "../stdafx.h"
+#include "../debug.h"
+#include "../fileio_func.h"
+#include "../gfx_func.h"
+#include "../rev.h"
+#include "../settings_type.h"
+#include "../spritecache.h"
+#include "../spritecache_internal.h"
+#include "../spriteloader/sprite_file_type.hpp"
+#include "../zoom_func.h"
+#include "../core/random_func.hpp"
+#include "factory.hpp"
+#include "blitbench.h"
+
+#include "../3rdparty/nlohmann/json.hpp"
+
+#include "../safeguards.h"
+
+BlitterBenchmark _blitter_benchmark;
+
+/** The blitters that are benchmarked when none are requested; the ones that are not available are skipped. */
+static const std::string_view _default_blitters[] = {
+	"8bpp-simple",
+	"8bpp-optimized",
+	"32bpp-simple",
+	"32bpp-optimized",
+	"32bpp-sse2",
+	"32bpp-ssse3",
+	"32bpp-sse4",
+	"32bpp-avx2",
+	"32bpp-anim",
+	"32bpp-sse2-anim",
+	"32bpp-sse4-anim",
+	"32bpp-avx2-anim",
+};
+
+/** The blitter modes, with their names for reporting. */
+static const std::pair<BlitterMode, std::string_view> _bench_modes[] = {
+	{ BM_NORMAL,            "normal" },
+	{ BM_COLOUR_REMAP,      "colour_remap" },
+	{ BM_TRANSPARENT,       "transparent" },
+	{ BM_TRANSPARENT_REMAP, "transparent_remap" },
+	{ BM_CRASH_REMAP,       "crash_remap" },
+	{ BM_BLACK_REMAP,       "black_remap" },
+};
+
+static const int BENCH_BUFFER_WIDTH = 1024;  ///< Width of the buffer the sprites are drawn into.
+static const int BENCH_BUFFER_HEIGHT = 1024; ///< Height of the buffer the sprites are drawn into.
+static const uint BENCH_POSITIONS = 64;      ///< Number of different positions every sprite is drawn at.
+
+/** The kinds of pixels of the generated sprites. */
+enum BenchSpriteKind {
+	BSK_OPAQUE,      ///< Only fully opaque and fully transparent pixels, like most ground tiles.
+	BSK_TRANSLUCENT, ///< Translucent pixels, like anti-aliased edges of buildings.
+	BSK_REMAP,       ///< Company colours, which are remapped.
+	BSK_ANIMATED,    ///< Colours of the animated part of the palette, like water.
+};
+
+/** Description of a generated sprite; the sizes are those at the highest zoom level. */
+struct BenchSprite {
+	std::string_view name; ///< Name of the sprite, for reporting.
+	uint16_t width;        ///< Width of the sprite.
+	uint16_t height;       ///< Height of the sprite.
+	BenchSpriteKind kind;  ///< The kind of pixels of the sprite.
+};
+
+/** The sprites that are drawn. */
+static const BenchSprite _bench_sprites[] = {
+	{ "ground",   256, 124, BSK_OPAQUE },
+	{ "building", 256, 320, BSK_TRANSLUCENT },
+	{ "vehicle",  128,  96, BSK_REMAP },
+	{ "water",    256, 124, BSK_ANIMATED },
+};
+
+/** The sprites of a GRF file that was loaded into the sprite cache. */
+struct BenchGrf {
+	std::string name;  ///< Name of the GRF file, for reporting.
+	SpriteID first;    ///< The first sprite of the GRF file in the sprite cache.
+	SpriteID end;      ///< One past the last sprite of the GRF file in the sprite cache.
+};
+
+/** The GRF files that have been loaded. */
+static std::vector<BenchGrf> _bench_grfs;
+
+/** A sprite, encoded for the benchmarked blitter and for the reference blitter. */
+struct EncodedBenchSprite {
+	UniquePtrSpriteAllocator allocator; ///< Owner of the sprite encoded for the benchmarked blitter.
+	const Sprite *sprite = nullptr;     ///< The sprite encoded for the benchmarked blitter.
+	std::array<UniquePtrSpriteAllocator, ZOOM_LVL_END> reference_allocators{}; ///< Owners of the sprites encoded for the reference blitter.
+	std::array<const Sprite *, ZOOM_LVL_END> reference{}; ///< The sprite encoded for the reference blitter, for every zoom level.
+};
+
+/** Sprites that are drawn, and reported on, together. */
+struct EncodedBenchSpriteSet {
+	std::string name; ///< Name of the set, for reporting.
+	std::vector<std::unique_ptr<EncodedBenchSprite>> sprites; ///< The sprites of the set.
+};
+
+/**
+ * Encoder handing the sprites to the benchmarked blitter, that also encodes them for
+ * the reference blitter. The simple blitters make the other zoom levels by skipping
+ * pixels of the highest zoom level instead of using the zoom levels the sprite loader
+ * made, so each zoom level is given to the reference blitter as a sprite of its own;
+ * that way both blitters draw the same pixels.
+ */
+class BenchSpriteEncoder : public SpriteEncoder {
+	Blitter *blitter;           ///< The benchmarked blitter.
+	Blitter *reference;         ///< The reference blitter.
+	EncodedBenchSprite &target; ///< Where to store the sprites encoded for the reference blitter.
+
+public:
+	/**
+	 * Create the encoder.
+	 * @param blitter The benchmarked blitter.
+	 * @param reference The reference blitter.
+	 * @param target Where to store the sprites encoded for the reference blitter.
+	 */
+	BenchSpriteEncoder(Blitter *blitter, Blitter *reference, EncodedBenchSprite &target) : blitter(blitter), reference(reference), target(target)
+	{
+	}
+
+	bool Is32BppSupported() override
+	{
+		return this->blitter->Is32BppSupported();
+	}
+
+	uint GetSpriteAlignment() override
+	{
+		return this->blitter->GetSpriteAlignment();
+	}
+
+	Sprite *Encode(const SpriteLoader::SpriteCollection &sprite, SpriteAllocator &allocator) override
+	{
+		for (ZoomLevel zoom = ZOOM_LVL_MIN; zoom <= ZOOM_LVL_MAX; zoom++) {
+			SpriteLoader::SpriteCollection single;
+			single[ZOOM_LVL_MIN] = sprite[zoom];
+			this->target.reference[zoom] = this->reference->Encode(single, this->target.reference_allocators[zoom]);
+		}
+		return this->blitter->Encode(sprite, allocator);
+	}
+};
+
+/**
+ * Generate the pixels of a sprite at the highest zoom level; the other zoom levels
+ * are made from it the way the sprite cache does that.
+ * @param desc The sprite to generate.
+ * @param palette Whether to generate a sprite with only palette colours, for 8 bpp blitters.
+ * @param[out] sprite Where to generate the sprite into.
+ */
+static void MakeBenchSprite(const BenchSprite &desc, bool palette, SpriteLoader::SpriteCollection &sprite)
+{
+	SpriteLoader::Sprite &s = sprite[ZOOM_LVL_MIN];
+	s.width = desc.width;
+	s.height = desc.height;
+	s.x_offs = 0;
+	s.y_offs = 0;
+	s.type = SpriteType::Normal;
+	if (palette) {
+		s.colours = SCC_PAL;
+	} else {
+		s.colours = (desc.kind == BSK_REMAP || desc.kind == BSK_ANIMATED) ? SCC_RGB | SCC_ALPHA | SCC_PAL : SCC_RGB | SCC_ALPHA;
+	}
+	s.AllocateData(ZOOM_LVL_MIN, static_cast<size_t>(s.width) * s.height);
+
+	/* The same seed for every blitter, so they all draw exactly the same. */
+	Randomizer random;
+	random.SetSeed(desc.width * desc.height + desc.kind);
+
+	const int64_t w = s.width;
+	const int64_t h = s.height;
+	SpriteLoader::CommonPixel *pixel = s.data;
+	for (int64_t y = 0; y < h; y++) {
+		for (int64_t x = 0; x < w; x++, pixel++) {
+			/* Tiles are diamonds, vehicles are ellipses and buildings are rectangles. */
+			bool inside;
+			switch (desc.kind) {
+				case BSK_TRANSLUCENT: inside = x >= 8 && x < w - 8 && y >= 8; break;
+				case BSK_REMAP: inside = (2 * x + 1 - w) * (2 * x + 1 - w) * h * h + (2 * y + 1 - h) * (2 * y + 1 - h) * w * w <= w * w * h * h; break;
+				default: inside = std::abs(2 * x + 1 - w) * h + std::abs(2 * y + 1 - h) * w <= w * h; break;
+			}
+			if (!inside) continue;
+
+			if (palette) {
+				/* Palette sprites have no translucency, and every pixel has a colour of the palette. */
+				pixel->a = 255;
+				pixel->m = 1 + random.Next(255);
+			} else {
+				pixel->r = random.Next(256);
+				pixel->g = random.Next(256);
+				pixel->b = random.Next(256);
+				pixel->a = 255;
+			}
+			switch (desc.kind) {
+				case BSK_OPAQUE: break;
+
+				case BSK_TRANSLUCENT:
+					if (palette) break;
+					if (x < 24 || x >= w - 24 || y < 24 || random.Next(16) == 0) pixel->a = random.Next(256);
+					break;
+
+				case BSK_REMAP:
+					if (random.Next(3) == 0) pixel->m = 0xC6 + random.Next(8);
+					break;
+
+				case BSK_ANIMATED:
+					if (random.Next(2) == 0) pixel->m = PALETTE_ANIM_START + random.Next(PALETTE_ANIM_SIZE);
+					break;
+			}
+		}
+	}
+}
+
+/**
+ * Make the remap used by the blitter modes that need one: company colours are
+ * changed into another company colour, and all other colours stay the same.
+ * @return The remap.
+ */
+static std::array<uint8_t, 256> MakeBenchRemap()
+{
+	std::array<uint8_t, 256> remap;
+	for (uint i = 0; i < remap.size(); i++) remap[i] = i;
+	for (uint i = 0; i < 8; i++) remap[0xC6 + i] = 0x46 + i;
+	return remap;
+}
+
+/**
+ * Load the sprites of a GRF file into the sprite cache, the way the base graphics are loaded.
+ * @param filename The GRF file.
+ * @return True iff the GRF file could be loaded.
+ */
+static bool LoadBenchGrf(const std::string &filename)
+{
+	if (!FioCheckFileExists(filename, NO_DIRECTORY)) {
+		Debug(sprite, 0, "Cannot load '{}'; it does not exist", filename);
+		return false;
+	}
+
+	SpriteID first = _bench_grfs.empty() ? 0 : _bench_grfs.back().end;
+	SpriteFile &file = OpenCachedSpriteFile(filename, NO_DIRECTORY, false);
+
+	uint8_t container_ver = file.GetContainerVersion();
+	if (container_ver == 0) {
+		Debug(sprite, 0, "Cannot load '{}'; it is not a GRF file", filename);
+		return false;
+	}
+	ReadGRFSpriteOffsets(file);
+	if (container_ver >= 2 && file.ReadByte() != 0) {
+		Debug(sprite, 0, "Cannot load '{}'; its compression format is not supported", filename);
+		return false;
+	}
+
+	SpriteID end = first;
+	for (uint sprite_id = 0; end < MAX_SPRITES && LoadNextSprite(end, file, sprite_id); sprite_id++) end++;
+	Debug(sprite, 1, "Loaded {} sprites of '{}'", end - first, filename);
+
+	auto name_begin = filename.find_last_of(PATHSEPCHAR);
+	_bench_grfs.emplace_back(filename.substr(name_begin == std::string::npos ? 0 : name_begin + 1), first, end);
+	return true;
+}
+
+/**
+ * Encode all sprites that are drawn for a blitter.
+ * @param blitter The benchmarked blitter.
+ * @param reference The blitter to compare with.
+ * @return The sets of sprites: every generated sprite is a set of its own, and all sprites of a GRF file form a set.
+ */
+static std::vector<EncodedBenchSpriteSet> EncodeBenchSprites(Blitter *blitter, Blitter *reference)
+{
+	std::vector<EncodedBenchSpriteSet> sets;
+
+	for (const BenchSprite &desc : _bench_sprites) {
+		EncodedBenchSpriteSet &set = sets.emplace_back();
+		set.name = desc.name;
+
+		auto &encoded = set.sprites.emplace_back(std::make_unique<EncodedBenchSprite>());
+		BenchSpriteEncoder encoder(blitter, reference, *encoded);
+
+		SpriteLoader::SpriteCollection collection;
+		MakeBenchSprite(desc, blitter->GetScreenDepth() == 8, collection);
+		if (!ResizeSprites(collection, 1U << ZOOM_LVL_MIN, &encoder)) {
+			Debug(driver, 0, "Cannot make the zoom levels of sprite '{}'", desc.name);
+			_blitter_benchmark.failed = true;
+			sets.pop_back();
+			continue;
+		}
+		encoded->sprite = encoder.Encode(collection, encoded->allocator);
+	}
+
+	for (const BenchGrf &grf : _bench_grfs) {
+		EncodedBenchSpriteSet &set = sets.emplace_back();
+		set.name = grf.name;
+
+		for (SpriteID id = grf.first; id < grf.end; id++) {
+			if (GetSpriteType(id) != SpriteType::Normal) continue;
+
+			auto encoded = std::make_unique<EncodedBenchSprite>();
+			BenchSpriteEncoder encoder(blitter, reference, *encoded);
+			encoded->sprite = static_cast<const Sprite *>(GetRawSprite(id, SpriteType::Normal, &encoded->allocator, &encoder));
+
+			/* Sprites are drawn without clipping, so they have to fit in the buffer. */
+			if (encoded->sprite->width > BENCH_BUFFER_WIDTH || encoded->sprite->height > BENCH_BUFFER_HEIGHT) continue;
+			set.sprites.push_back(std::move(encoded));
+		}
+		if (set.sprites.empty()) sets.pop_back();
+	}
+
+	return sets;
+}
+
+/** A sprite to draw, and where to draw it. */
+struct BenchDraw {
+	const EncodedBenchSprite *sprite; ///< The sprite to draw.
+	Point position;                   ///< Where to draw the sprite.
+};
+
+/**
+ * Determine where the sprites of a set are drawn.
+ * @param set The sprites.
+ * @param zoom The zoom level they are drawn at.
+ * @return The sprites in the order they are drawn, each at several positions.
+ */
+static std::vector<BenchDraw> MakeBenchDraws(const EncodedBenchSpriteSet &set, ZoomLevel zoom)
+{
+	/* The same positions for every blitter, so they all draw exactly the same. */
+	Randomizer random;
+	random.SetSeed(zoom);
+
+	std::vector<BenchDraw> draws;
+	for (uint i = 0; i < BENCH_POSITIONS; i++) {
+		for (const auto &sprite : set.sprites) {
+			int x = random.Next(BENCH_BUFFER_WIDTH - UnScaleByZoom(sprite->sprite->width, zoom) + 1);
+			int y = random.Next(BENCH_BUFFER_HEIGHT - UnScaleByZoom(sprite->sprite->height, zoom) + 1);
+			draws.emplace_back(sprite.get(), Point{ x, y });
+		}
+	}
+	return draws;
+}
+
+/**
+ * Draw a sprite into the buffer #_screen points to.
+ * @param blitter The blitter to draw with.
+ * @param sprite The sprite, encoded by \a blitter.
+ * @param zoom The zoom level to draw at.
+ * @param mode The blitter mode to draw in.
+ * @param remap The remap for the modes that need one.
+ * @param position Where to draw the sprite.
+ * @return The number of drawn pixels.
+ */
+static uint64_t DrawBenchSprite(Blitter *blitter, const Sprite *sprite, ZoomLevel zoom, BlitterMode mode, const uint8_t *remap, Point position)
+{
+	Blitter::BlitterParams bp;
+	bp.sprite = sprite->data;
+	bp.remap = remap;
+	bp.skip_left = 0;
+	bp.skip_top = 0;
+	bp.width = UnScaleByZoom(sprite->width, zoom);
+	bp.height = UnScaleByZoom(sprite->height, zoom);
+	bp.sprite_width = sprite->width;
+	bp.sprite_height = sprite->height;
+	bp.left = position.x;
+	bp.top = position.y;
+	bp.dst = _screen.dst_ptr;
+	bp.pitch = _screen.pitch;
+
+	blitter->Draw(&bp, mode, zoom);
+	return static_cast<uint64_t>(bp.width) * bp.height;
+}
+
+/**
+ * Fill part of the buffer #_screen points to with colours, so blending has to do some actual work.
+ * The colours only depend on the position in the buffer, so the same part can be filled again.
+ * @param depth The colour depth of the buffer.
+ * @param left The left of the part to fill.
+ * @param top The top of the part to fill.
+ * @param width The width of the part to fill.
+ * @param height The height of the part to fill.
+ */
+static void FillBenchBuffer(uint8_t depth, int left, int top, int width, int height)
+{
+	for (int y = top; y < top + height; y++) {
+		for (int x = left; x < left + width; x++) {
+			uint32_t colour = static_cast<uint32_t>((y * _screen.pitch + x) * 0x9E3779B1);
+			if (depth == 8) {
+				static_cast<uint8_t *>(_screen.dst_ptr)[y * _screen.pitch + x] = colour >> 24;
+			} else {
+				static_cast<uint32_t *>(_screen.dst_ptr)[y * _screen.pitch + x] = 0xFF000000 | colour >> 8;
+			}
+		}
+	}
+}
+
+/**
+ * Compare what a blitter draws with what the reference blitter draws.
+ * For 32 bpp blitters every colour channel may differ by the tolerance, as the
+ * blitters use different ways of rounding when blending; 8 bpp blitters have to
+ * draw the same palette colours.
+ * @param blitter The benchmarked blitter.
+ * @param reference The blitter to compare with.
+ * @param draws The sprites to draw, and where to draw them.
+ * @param zoom The zoom level to draw at.
+ * @param mode The blitter mode to draw in.
+ * @param remap The remap for the modes that need one.
+ * @param[out] result Where to add the number of different pixels, and the largest difference, to.
+ * @return True iff no pixel differs by more than the tolerance.
+ */
+static bool CheckDraw(Blitter *blitter, Blitter *reference, std::span<const BenchDraw> draws, ZoomLevel zoom, BlitterMode mode, const uint8_t *remap, nlohmann::json &result)
+{
+	const uint8_t depth = blitter->GetScreenDepth();
+	const size_t bytes_per_pixel = depth / 8;
+	const uint8_t *buffer = static_cast<const uint8_t *>(_screen.dst_ptr);
+
+	uint64_t different_pixels = 0;
+	uint max_difference = 0;
+	std::vector<uint8_t> drawn;
+
+	for (const BenchDraw &draw : draws) {
+		int left = draw.position.x;
+		int top = draw.position.y;
+		int width = UnScaleByZoom(draw.sprite->sprite->width, zoom);
+		int height = UnScaleByZoom(draw.sprite->sprite->height, zoom);
+
+		/* Draw with the benchmarked blitter, and keep what it drew. */
+		FillBenchBuffer(depth, left, top, width, height);
+		DrawBenchSprite(blitter, draw.sprite->sprite, zoom, mode, remap, draw.position);
+		drawn.clear();
+		for (int y = top; y < top + height; y++) {
+			const uint8_t *line = buffer + (y * _screen.pitch + left) * bytes_per_pixel;
+			drawn.insert(drawn.end(), line, line + width * bytes_per_pixel);
+		}
+
+		/* Draw the same with the reference blitter, and compare. */
+		FillBenchBuffer(depth, left, top, width, height);
+		DrawBenchSprite(reference, draw.sprite->reference[zoom], ZOOM_LVL_MIN, mode, remap, draw.position);
+		const uint8_t *src = drawn.data();
+		for (int y = top; y < top + height; y++) {
+			const uint8_t *line = buffer + (y * _screen.pitch + left) * bytes_per_pixel;
+			for (int x = 0; x < width; x++) {
+				uint difference = 0;
+				for (size_t i = 0; i < bytes_per_pixel; i++, src++, line++) {
+					difference = std::max<uint>(difference, std::abs(*src - *line));
+				}
+				if (difference == 0) continue;
+
+				if (depth == 8) difference = UINT8_MAX;
+				different_pixels++;
+				max_difference = std::max(max_difference, difference);
+			}
+		}
+	}
+
+	result["different_pixels"] = different_pixels;
+	result["max_difference"] = max_difference;
+	return max_difference <= _blitter_benchmark.tolerance;
+}
+
+/**
+ * Measure how long drawing sprites takes.
+ * @param blitter The blitter to draw with.
+ * @param draws The sprites to draw, encoded by \a blitter; they are drawn in turn.
+ * @param zoom The zoom level to draw at.
+ * @param mode The blitter mode to draw in.
+ * @param remap The remap for the modes that need one.
+ * @param[out] result Where to add the results of the measurement to.
+ */
+static void MeasureDraw(Blitter *blitter, const std::vector<BenchDraw> &draws, ZoomLevel zoom, BlitterMode mode, const uint8_t *remap, nlohmann::json &result)
+{
+	uint64_t pixels = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (uint i = 0; i < _blitter_benchmark.iterations; i++) {
+		const BenchDraw &draw = draws[i % draws.size()];
+		pixels += DrawBenchSprite(blitter, draw.sprite->sprite, zoom, mode, remap, draw.position);
+	}
+	double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	result["pixels"] = pixels;
+	result["total_ms"] = total_ms;
+	result["megapixels_per_second"] = total_ms > 0 ? pixels / total_ms / 1000 : 0;
+}
+
+/**
+ * Benchmark and check a single blitter with all sprites, zoom levels and blitter modes.
+ * @param name The name of the blitter.
+ * @param[out] results Where to add the results to.
+ */
+static void BenchmarkBlitter(std::string_view name, nlohmann::json &results)
+{
+	Blitter *blitter = BlitterFactory::SelectBlitter(name);
+	if (blitter == nullptr || blitter->GetScreenDepth() == 0 || blitter->NeedsAnimationBuffer()) {
+		/* The animation buffer of e.g. the 40bpp blitter belongs to the video driver, and there is none. */
+		Debug(driver, 0, "Cannot benchmark blitter '{}'; it is not available, or it needs a video driver", name);
+		_blitter_benchmark.failed = true;
+		return;
+	}
+
+	/* What the blitter draws is compared with the simple blitter of the same colour depth. */
+	std::string_view reference_name = blitter->GetScreenDepth() == 8 ? "8bpp-simple" : "32bpp-simple";
+	BlitterFactory *reference_factory = BlitterFactory::GetBlitterFactory(reference_name);
+	if (reference_factory == nullptr) {
+		Debug(driver, 0, "Cannot check blitter '{}'; the reference blitter '{}' is not available", name, reference_name);
+		_blitter_benchmark.failed = true;
+		return;
+	}
+	std::unique_ptr<Blitter> reference(reference_factory->CreateInstance());
+
+	std::vector<uint8_t> buffer(static_cast<size_t>(BENCH_BUFFER_WIDTH) * BENCH_BUFFER_HEIGHT * blitter->GetScreenDepth() / 8);
+	_screen.dst_ptr = buffer.data();
+	_screen.left = 0;
+	_screen.top = 0;
+	_screen.width = BENCH_BUFFER_WIDTH;
+	_screen.height = BENCH_BUFFER_HEIGHT;
+	_screen.pitch = BENCH_BUFFER_WIDTH;
+	_screen.zoom = ZOOM_LVL_NORMAL;
+	blitter->PostResize();
+	FillBenchBuffer(blitter->GetScreenDepth(), 0, 0, BENCH_BUFFER_WIDTH, BENCH_BUFFER_HEIGHT);
+
+	const std::array<uint8_t, 256> remap = MakeBenchRemap();
+	const std::vector<EncodedBenchSpriteSet> sets = EncodeBenchSprites(blitter, reference.get());
+
+	for (const EncodedBenchSpriteSet &set : sets) {
+		for (ZoomLevel zoom = ZOOM_LVL_MIN; zoom <= ZOOM_LVL_MAX; zoom++) {
+			const std::vector<BenchDraw> draws = MakeBenchDraws(set, zoom);
+
+			for (const auto &[mode, mode_name] : _bench_modes) {
+				Debug(driver, 1, "Benchmarking blitter '{}' with sprite '{}', zoom level {}, mode {}", name, set.name, zoom, mode_name);
+
+				nlohmann::json result;
+				result["blitter"] = name;
+				result["sprite"] = set.name;
+				result["zoom"] = zoom;
+				result["mode"] = mode_name;
+
+				/* The first draws are of every sprite once. The reference blitter itself is not checked; it makes the zoom
+				 * levels by skipping pixels. In transparent mode the simple 32bpp blitter darkens every visible pixel the
+				 * same, whereas the other blitters darken semi-transparent pixels less, so those only get reported. */
+				bool check = name != reference_name && (mode != BM_TRANSPARENT || blitter->GetScreenDepth() == 8);
+				if (!CheckDraw(blitter, reference.get(), std::span(draws).first(set.sprites.size()), zoom, mode, remap.data(), result) && check) {
+					Debug(driver, 0, "Blitter '{}' draws sprite '{}' at zoom level {} in mode {} differently than '{}': {} pixels differ, by at most {}",
+							name, set.name, zoom, mode_name, reference_name, result["different_pixels"].get<uint64_t>(), result["max_difference"].get<uint>());
+					_blitter_benchmark.failed = true;
+				}
+				if (!_blitter_benchmark.check_only) MeasureDraw(blitter, draws, zoom, mode, remap.data(), result);
+
+				results.push_back(std::move(result));
+			}
+		}
+	}
+
+	_screen.dst_ptr = nullptr;
+}
+
+/** Run the benchmark requested in #_blitter_benchmark, and write the results. */
+void RunBlitterBenchmark()
+{
+	/* All zoom levels are drawn, so the blitters have to encode all of them. */
+	_settings_client.gui.zoom_min = ZOOM_LVL_MIN;
+	_settings_client.gui.zoom_max = ZOOM_LVL_MAX;
+	_settings_client.gui.sprite_zoom_min = ZOOM_LVL_MIN;
+
+	/* The sprite cache sizes itself for the current blitter, so there has to be one. */
+	BlitterFactory::SelectBlitter("null");
+	GfxInitSpriteMem();
+	for (const std::string &grf : _blitter_benchmark.grfs) {
+		if (!LoadBenchGrf(grf)) _blitter_benchmark.failed = true;
+	}
+
+	nlohmann::json results = nlohmann::json::array();
+	if (_blitter_benchmark.blitters.empty()) {
+		for (std::string_view name : _default_blitters) {
+			if (BlitterFactory::GetBlitterFactory(name) != nullptr) BenchmarkBlitter(name, results);
+		}
+	} else {
+		for (const std::string &name : _blitter_benchmark.blitters) BenchmarkBlitter(name, results);
+	}
+
+	nlohmann::json benchmark;
+	benchmark["version"] = std::string(_openttd_revision);
+	benchmark["iterations"] = _blitter_benchmark.check_only ? 0 : _blitter_benchmark.iterations;
+	benchmark["tolerance"] = _blitter_benchmark.tolerance;
+	benchmark["results"] = std::move(results);
+
+	std::string output = benchmark.dump(1, '\t');
+	if (_blitter_benchmark.output.empty()) {
+		fmt::print("{}\n", output);
+		return;
+	}
+
+	auto f = FileHandle::Open(_blitter_benchmark.output, "w");
+	if (!f.has_value()) {
+		Debug(misc, 0, "Cannot open {} to write the benchmark results to", _blitter_benchmark.output);
+		_blitter_benchmark.failed = true;
+		return;
+	}
+	fmt::print(*f, "{}\n", output);
+}
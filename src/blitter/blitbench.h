@@ -0,0 +1,28 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file blitbench.h Benchmark of the blitters. */
+
+#ifndef BLITTER_BLITBENCH_H
+#define BLITTER_BLITBENCH_H
+
+/** What to benchmark, as requested by the openttd_blitbench tool. */
+struct BlitterBenchmark {
+	std::vector<std::string> blitters; ///< The blitters to benchmark; all available blitters when empty.
+	std::vector<std::string> grfs;     ///< GRF files whose sprites are drawn as well as the generated sprites.
+	std::string output;                ///< The file to write the results to; the standard output when empty.
+	uint iterations = 1000;            ///< How often a sprite is drawn per measurement.
+	uint tolerance = 2;                ///< How much a colour channel may differ from what the reference blitter draws.
+	bool check_only = false;           ///< Whether to only compare with the reference blitter, and not measure.
+	bool failed = false;               ///< Whether any of the blitters could not be benchmarked, or draws differently.
+};
+
+extern BlitterBenchmark _blitter_benchmark;
+
+void RunBlitterBenchmark();
+
+#endif /* BLITTER_BLITBENCH_H */
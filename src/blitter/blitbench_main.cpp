@@ -0,0 +1,117 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file blitbench_main.cpp Main entry for the blitter benchmark, openttd_blitbench. */
+
+#include "../stdafx.h"
+#include "../crashlog.h"
+#include "../fileio_func.h"
+#include "../palette_func.h"
+#include "../core/format.hpp"
+#include "../misc/getoptdata.h"
+#include "../string_func.h"
+#include "blitbench.h"
+
+#include <charconv>
+#include <filesystem>
+
+#include "../safeguards.h"
+
+/** Options of openttd_blitbench. */
+static const OptionData _options[] = {
+	{ .type = ODF_HAS_VALUE, .id = 'b', .shortname = 'b' },
+	{ .type = ODF_NO_VALUE, .id = 'c', .shortname = 'c' },
+	{ .type = ODF_HAS_VALUE, .id = 'g', .shortname = 'g' },
+	{ .type = ODF_NO_VALUE, .id = 'h', .shortname = 'h' },
+	{ .type = ODF_HAS_VALUE, .id = 'n', .shortname = 'n' },
+	{ .type = ODF_HAS_VALUE, .id = 'o', .shortname = 'o' },
+	{ .type = ODF_HAS_VALUE, .id = 't', .shortname = 't' },
+};
+
+/** Show the usage of openttd_blitbench. */
+static void ShowUsage()
+{
+	fmt::print(stderr,
+		"Usage: openttd_blitbench [options]\n"
+		"  -b blitter      = Benchmark this blitter, e.g. '32bpp-avx2';\n"
+		"                    may be given multiple times, default all blitters\n"
+		"  -c              = Only check the blitters draw the same as the simple\n"
+		"                    blitters, do not measure how fast they are\n"
+		"  -g grf          = Draw the sprites of 'grf' as well as the generated ones;\n"
+		"                    may be given multiple times\n"
+		"  -n iterations   = Draw this many sprites per measurement (default 1000)\n"
+		"  -o file         = Write the results to 'file' instead of the standard output\n"
+		"  -t tolerance    = Allow colour channels to differ this much from what\n"
+		"                    the simple 32 bpp blitter draws (default 2)\n"
+		"  -h              = Show this help\n");
+}
+
+int CDECL main(int argc, char *argv[])
+{
+	/* Make sure our arguments contain only valid UTF-8 characters. */
+	for (int i = 0; i < argc; i++) StrMakeValidInPlace(argv[i]);
+
+	CrashLog::InitialiseCrashLog();
+
+	GetOptData mgo(std::span(argv, argc).subspan(1), _options);
+	int i;
+	while ((i = mgo.GetOpt()) != -1) {
+		switch (i) {
+			case 'b':
+				_blitter_benchmark.blitters.emplace_back(mgo.opt);
+				break;
+
+			case 'c':
+				_blitter_benchmark.check_only = true;
+				break;
+
+			case 'g':
+				/* The GRF files are loaded by their full path, like the savegames of openttd_savebench. */
+				_blitter_benchmark.grfs.push_back(FS2OTTD(std::filesystem::absolute(OTTD2FS(mgo.opt))));
+				break;
+
+			case 'n': {
+				std::string_view value = mgo.opt;
+				auto [end, err] = std::from_chars(value.data(), value.data() + value.size(), _blitter_benchmark.iterations);
+				if (err != std::errc() || end != value.data() + value.size() || _blitter_benchmark.iterations == 0) {
+					ShowUsage();
+					return 1;
+				}
+				break;
+			}
+
+			case 'o':
+				_blitter_benchmark.output = mgo.opt;
+				break;
+
+			case 't': {
+				std::string_view value = mgo.opt;
+				auto [end, err] = std::from_chars(value.data(), value.data() + value.size(), _blitter_benchmark.tolerance);
+				if (err != std::errc() || end != value.data() + value.size()) {
+					ShowUsage();
+					return 1;
+				}
+				break;
+			}
+
+			default:
+				ShowUsage();
+				return i == 'h' ? 0 : 1;
+		}
+	}
+
+	if (!mgo.arguments.empty()) {
+		ShowUsage();
+		return 1;
+	}
+
+	/* The blitters do not need a game, only the palette; the search paths are needed to open the GRF files. */
+	DeterminePaths(argv[0], true);
+	GfxInitPalettes();
+	RunBlitterBenchmark();
+	return _blitter_benchmark.failed ? 1 : 0;
+}
@@ -46,13 +46,13 @@ void ottd_cpuid(int info[4], int type)
 			/* It is safe to write "=r" for (info[1]) as in case that PIC is enabled for i386,
 			 * the compiler will not choose EBX as target register (but something else).
 			 */
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #else
 	__asm__ __volatile__ (
 			"cpuid           \n\t"
 			: "=a" (info[0]), "=b" (info[1]), "=c" (info[2]), "=d" (info[3])
-			: "a" (type)
+			: "a" (type), "c" (0)
 	);
 #endif /* i386 PIC */
 }
@@ -91,3 +91,38 @@ bool HasCPUIDFlag(uint type, uint index, uint bit)
 	ottd_cpuid(cpu_info, type);
 	return HasBit(cpu_info[index], bit);
 }
+
+/**
+ * Read the XCR0 register, which tells which register states the operating system saves.
+ * @return The value of XCR0; only valid when the CPU has OSXSAVE.
+ */
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+static uint64_t ReadXCR0()
+{
+	return _xgetbv(0);
+}
+#elif defined(__x86_64__) || defined(__i386)
+static uint64_t ReadXCR0()
+{
+	uint32_t eax, edx;
+	__asm__ __volatile__ (
+			"xgetbv          \n\t"
+			: "=a" (eax), "=d" (edx)
+			: "c" (0)
+	);
+	return (uint64_t)edx << 32 | eax;
+}
+#endif
+
+bool HasAVX2()
+{
+#if (defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))) || defined(__x86_64__) || defined(__i386)
+	/* The CPU has to support AVX and XGETBV, before the operating system support can be checked. */
+	if (!HasCPUIDFlag(1, 2, 27) || !HasCPUIDFlag(1, 2, 28) || !HasCPUIDFlag(7, 1, 5)) return false;
+
+	/* The operating system has to save both the XMM and the YMM registers. */
+	return (ReadXCR0() & 0x6) == 0x6;
+#else
+	return false;
+#endif
+}
@@ -26,4 +26,11 @@ void ottd_cpuid(int info[4], int type);
  */
 bool HasCPUIDFlag(uint type, uint index, uint bit);
 
+/**
+ * Check whether AVX2 instructions can be used, i.e. whether the CPU has them
+ * and the operating system saves the AVX registers when switching threads.
+ * @return True iff AVX2 is available.
+ */
+bool HasAVX2();
+
 #endif /* CPU_H */
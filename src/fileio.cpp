@@ -945,6 +945,8 @@ void DeterminePaths(const char *exe, bool only_local_path)
 	_secrets_file = config_dir + "secrets.cfg";
 	extern std::string _favs_file;
 	_favs_file = config_dir + "favs.cfg";
+	extern std::string _md5sum_cache_file;
+	_md5sum_cache_file = config_dir + "md5sum_cache.cfg";
 
 #ifdef USE_XDG
 	if (config_dir == config_home) {
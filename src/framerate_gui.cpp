@@ -24,6 +24,7 @@
 #include "game/game_instance.hpp"
 #include "timer/timer.h"
 #include "timer/timer_window.h"
+#include "spritecache.h"
 
 #include "widgets/framerate_widget.h"
 
@@ -68,13 +69,16 @@ namespace {
 		/** Start time for current accumulation cycle */
 		TimingMeasurement acc_timestamp;
 
+		/** Time left out of the current cycle, see PerformancePause */
+		TimingMeasurement excluded;
+
 		/**
 		 * Initialize a data element with an expected collection rate
 		 * @param expected_rate
 		 * Expected number of cycles per second of the performance element. Use 1 if unknown or not relevant.
 		 * The rate is used for highlighting slow-running elements in the GUI.
 		 */
-		explicit PerformanceData(double expected_rate) : expected_rate(expected_rate), next_index(0), prev_index(0), num_valid(0) { }
+		explicit PerformanceData(double expected_rate) : expected_rate(expected_rate), next_index(0), prev_index(0), num_valid(0), excluded(0) { }
 
 		/** Collect a complete measurement, given start and ending times for a processing block */
 		void Add(TimingMeasurement start_time, TimingMeasurement end_time)
@@ -245,6 +249,8 @@ PerformanceMeasurer::PerformanceMeasurer(PerformanceElement elem)
 
 	this->elem = elem;
 	this->start_time = GetPerformanceTimer();
+	/* PFE_SOUND is measured from the mixer thread, and never paused. */
+	if (elem != PFE_SOUND) _pf_data[elem].excluded = 0;
 }
 
 /** Finish a cycle of a measured element and store the measurement taken. */
@@ -273,7 +279,7 @@ PerformanceMeasurer::~PerformanceMeasurer()
 		_sound_perf_pending.store(true, std::memory_order_release);
 		return;
 	}
-	_pf_data[this->elem].Add(this->start_time, GetPerformanceTimer());
+	_pf_data[this->elem].Add(this->start_time, GetPerformanceTimer() - _pf_data[this->elem].excluded);
 }
 
 /** Set the rate of expected cycles per second of a performance element. */
@@ -301,6 +307,25 @@ void PerformanceMeasurer::SetExpectedRate(double rate)
 }
 
 
+/**
+ * Begin leaving time out of the current cycle of a measured element.
+ * @param elem The element that is waiting
+ */
+PerformancePause::PerformancePause(PerformanceElement elem)
+{
+	assert(elem < PFE_MAX && elem != PFE_SOUND);
+
+	this->elem = elem;
+	this->start_time = GetPerformanceTimer();
+}
+
+/** Finish leaving time out of the current cycle of a measured element. */
+PerformancePause::~PerformancePause()
+{
+	_pf_data[this->elem].excluded += GetPerformanceTimer() - this->start_time;
+}
+
+
 /**
  * Begin measuring one block of the accumulating value.
  * @param elem The element to be measured
@@ -384,6 +409,7 @@ static constexpr NWidgetPart _framerate_window_widgets[] = {
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_GAMELOOP), SetDataTip(STR_FRAMERATE_RATE_GAMELOOP, STR_FRAMERATE_RATE_GAMELOOP_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_DRAWING),  SetDataTip(STR_FRAMERATE_RATE_BLITTER,  STR_FRAMERATE_RATE_BLITTER_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_RATE_FACTOR),   SetDataTip(STR_FRAMERATE_SPEED_FACTOR,  STR_FRAMERATE_SPEED_FACTOR_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
+			NWidget(WWT_TEXT, COLOUR_GREY, WID_FRW_SPRITE_CACHE),  SetDataTip(STR_FRAMERATE_SPRITE_CACHE,  STR_FRAMERATE_SPRITE_CACHE_TOOLTIP), SetFill(1, 0), SetResize(1, 0),
 		EndContainer(),
 	EndContainer(),
 	NWidget(NWID_HORIZONTAL),
@@ -445,6 +471,7 @@ struct FramerateWindow : Window {
 	CachedDecimal speed_gameloop;           ///< cached game loop speed factor
 	CachedDecimal times_shortterm[PFE_MAX]; ///< cached short term average times
 	CachedDecimal times_longterm[PFE_MAX];  ///< cached long term average times
+	SpriteCacheStats sprite_cache;          ///< cached statistics of the sprite cache
 
 	static constexpr int MIN_ELEMENTS = 5;      ///< smallest number of elements to display
 
@@ -486,6 +513,7 @@ struct FramerateWindow : Window {
 		if (this->small) return; // in small mode, this is everything needed
 
 		this->rate_drawing.SetRate(_pf_data[PFE_DRAWING].GetRate(), _settings_client.gui.refresh_rate);
+		this->sprite_cache = GetSpriteCacheStats();
 
 		int new_active = 0;
 		for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
@@ -534,6 +562,13 @@ struct FramerateWindow : Window {
 			case WID_FRW_RATE_FACTOR:
 				this->speed_gameloop.InsertDParams(0);
 				break;
+			case WID_FRW_SPRITE_CACHE:
+				SetDParam(0, this->sprite_cache.used);
+				SetDParam(1, this->sprite_cache.budget);
+				SetDParam(2, this->sprite_cache.hits);
+				SetDParam(3, this->sprite_cache.misses);
+				SetDParam(4, this->sprite_cache.evictions);
+				break;
 			case WID_FRW_INFO_DATA_POINTS:
 				SetDParam(0, NUM_FRAMERATE_POINTS);
 				break;
@@ -560,6 +595,14 @@ struct FramerateWindow : Window {
 				SetDParam(1, 2);
 				size = GetStringBoundingBox(STR_FRAMERATE_SPEED_FACTOR);
 				break;
+			case WID_FRW_SPRITE_CACHE:
+				SetDParamMaxValue(0, 1000ULL * 1024 * 1024);
+				SetDParamMaxValue(1, 1000ULL * 1024 * 1024);
+				SetDParamMaxDigits(2, 7);
+				SetDParamMaxDigits(3, 7);
+				SetDParamMaxDigits(4, 7);
+				size = GetStringBoundingBox(STR_FRAMERATE_SPRITE_CACHE);
+				break;
 
 			case WID_FRW_TIMES_NAMES: {
 				size.width = 0;
@@ -1099,6 +1142,30 @@ void ConPrintFramerate()
 	if (!printed_anything) {
 		IConsolePrint(CC_ERROR, "No performance measurements have been taken yet.");
 	}
+
+	const SpriteCacheStats &sprite_cache = GetSpriteCacheStats();
+	IConsolePrint(TC_SILVER, "Sprite cache: {} of {} KiB used ({} KiB allocated), {} hits, {} misses, {} evictions",
+		sprite_cache.used / 1024, sprite_cache.budget / 1024, sprite_cache.allocated / 1024,
+		sprite_cache.hits, sprite_cache.misses, sprite_cache.evictions);
+}
+
+/**
+ * Get the current measurements of a performance element, e.g. for reporting them to the admin network.
+ * @param elem The performance element to get the measurements of.
+ * @param[out] rate The current rate of the element in cycles per second.
+ * @param[out] short_term Average cycle duration over the last few data points, in milliseconds.
+ * @param[out] long_term Average cycle duration over all kept data points, in milliseconds.
+ * @return False when there are no measurements for this element.
+ */
+bool GetPerformanceMeasurement(PerformanceElement elem, double &rate, double &short_term, double &long_term)
+{
+	auto &pf = _pf_data[elem];
+	if (pf.num_valid == 0) return false;
+
+	rate = pf.GetRate();
+	short_term = pf.GetAverageDurationMilliseconds(8);
+	long_term = pf.GetAverageDurationMilliseconds(NUM_FRAMERATE_POINTS);
+	return true;
 }
 
 /**
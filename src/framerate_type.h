@@ -100,6 +100,19 @@ public:
 	static void Paused(PerformanceElement elem);
 };
 
+/**
+ * RAII class for leaving a period out of the current cycle of an element measured with PerformanceMeasurer.
+ * Construct an object where the processing of the element waits for something that is not part of it,
+ * such as the game loop letting the drawing happen in the middle of a game tick.
+ */
+class PerformancePause {
+	PerformanceElement elem;
+	TimingMeasurement start_time;
+public:
+	PerformancePause(PerformanceElement elem);
+	~PerformancePause();
+};
+
 /**
  * RAII class for measuring multi-step elements of performance.
  * At the beginning of a frame, call Reset on the element, then construct an object in the scope where
@@ -122,5 +135,6 @@ public:
 
 void ShowFramerateWindow();
 void ProcessPendingPerformanceMeasurements();
+bool GetPerformanceMeasurement(PerformanceElement elem, double &rate, double &short_term, double &long_term);
 
 #endif /* FRAMERATE_TYPE_H */
@@ -51,7 +51,7 @@ PauseMode _pause_mode;
 GameSessionStats _game_session_stats; ///< Statistics about the current session.
 
 static uint8_t _stringwidth_table[FS_END][224]; ///< Cache containing width of often used characters. @see GetCharacterWidth()
-DrawPixelInfo *_cur_dpi;
+thread_local DrawPixelInfo *_cur_dpi; ///< The area being drawn to; every thread drawing sprites has its own.
 
 static void GfxMainBlitterViewport(const Sprite *sprite, int x, int y, BlitterMode mode, const SubSprite *sub = nullptr, SpriteID sprite_id = SPR_CURSOR_MOUSE);
 static void GfxMainBlitter(const Sprite *sprite, int x, int y, BlitterMode mode, const SubSprite *sub = nullptr, SpriteID sprite_id = SPR_CURSOR_MOUSE, ZoomLevel zoom = ZOOM_LVL_MIN);
@@ -71,14 +71,22 @@ int _gui_scale_cfg;                         ///< GUI scale in config.
  * @ingroup dirty
  */
 static Rect _invalid_rect;
-static const uint8_t *_colour_remap_ptr;
-static uint8_t _string_colourremap[3]; ///< Recoloursprite for stringdrawing. The grf loader ensures that #SpriteType::Font sprites only use colours 0 to 2.
+static thread_local const uint8_t *_colour_remap_ptr;
+static thread_local uint8_t _string_colourremap[3]; ///< Recoloursprite for stringdrawing. The grf loader ensures that #SpriteType::Font sprites only use colours 0 to 2.
 
 static const uint DIRTY_BLOCK_HEIGHT   = 8;
 static const uint DIRTY_BLOCK_WIDTH    = 64;
 
-static uint _dirty_bytes_per_line = 0;
-static uint8_t *_dirty_blocks = nullptr;
+using DirtyBlockBits = uint64_t; ///< Part of a bitmap of dirty blocks, with one bit per block.
+static const uint DIRTY_BLOCK_BITS = std::numeric_limits<DirtyBlockBits>::digits; ///< Number of blocks in #DirtyBlockBits.
+
+static uint _dirty_block_columns = 0;    ///< Number of columns of dirty blocks on the screen.
+static uint _dirty_block_lines = 0;      ///< Number of lines of dirty blocks on the screen.
+static uint _dirty_bits_per_line = 0;    ///< Number of #DirtyBlockBits of each line of #_dirty_blocks.
+static std::vector<DirtyBlockBits> _dirty_blocks;        ///< Bitmap of the blocks that have to be redrawn, line by line.
+static std::vector<DirtyBlockBits> _dirty_lines;         ///< Bitmap of the lines of #_dirty_blocks that have dirty blocks, so clean lines are skipped quickly.
+static std::vector<DirtyBlockBits> _dirty_column_breaks; ///< Bitmap of the columns of blocks where a viewport begins or ends; areas to redraw are split there.
+static std::vector<DirtyBlockBits> _dirty_line_breaks;   ///< Bitmap of the lines of blocks where a viewport begins or ends; areas to redraw are split there.
 extern uint _dirty_block_colour;
 
 void GfxScroll(int left, int top, int width, int height, int xo, int yo)
@@ -976,6 +984,64 @@ void DrawSpriteViewport(SpriteID img, PaletteID pal, int x, int y, const SubSpri
 	}
 }
 
+/**
+ * Get the recolour sprite #DrawSpriteViewport uses for drawing a sprite.
+ * @param img Image number to draw.
+ * @param pal Palette to use.
+ * @param[out] recolour The recolour sprite.
+ * @return True iff a recolour sprite is used.
+ */
+static bool GetSpriteViewportRecolour(SpriteID img, PaletteID pal, SpriteID &recolour)
+{
+	if (!HasBit(img, PALETTE_MODIFIER_TRANSPARENT) && (pal == PAL_NONE || HasBit(pal, PALETTE_TEXT_RECOLOUR))) return false;
+
+	recolour = GB(pal, 0, PALETTE_WIDTH);
+	return true;
+}
+
+/**
+ * Load the sprites #DrawSpriteViewport needs for drawing a sprite into the sprite cache.
+ * @param img Image number to draw.
+ * @param pal Palette to use.
+ */
+void PreloadSpriteViewport(SpriteID img, PaletteID pal)
+{
+	GetSprite(GB(img, 0, SPRITE_WIDTH), SpriteType::Normal);
+
+	SpriteID recolour;
+	if (GetSpriteViewportRecolour(img, pal, recolour)) GetNonSprite(recolour, SpriteType::Recolour);
+}
+
+/**
+ * Check whether all sprites #DrawSpriteViewport needs for drawing a sprite are in the sprite cache.
+ * @param img Image number to draw.
+ * @param pal Palette to use.
+ * @return True iff drawing the sprite does not need to load any sprites.
+ */
+bool IsSpriteViewportCached(SpriteID img, PaletteID pal)
+{
+	if (!IsSpriteCached(GB(img, 0, SPRITE_WIDTH), SpriteType::Normal)) return false;
+
+	SpriteID recolour;
+	return !GetSpriteViewportRecolour(img, pal, recolour) || IsSpriteCached(recolour, SpriteType::Recolour);
+}
+
+/**
+ * Request the sprites #DrawSpriteViewport needs for drawing a sprite, without waiting for sprites
+ * that are loaded in the background. See #RequestSprite.
+ * @param img Image number to draw.
+ * @param pal Palette to use.
+ * @return True iff all sprites are in the sprite cache, so the sprite can be drawn.
+ */
+bool RequestSpriteViewport(SpriteID img, PaletteID pal)
+{
+	/* Recolour sprites are always loaded right away; do that first, so it cannot push the sprite itself out of the cache. */
+	SpriteID recolour;
+	if (GetSpriteViewportRecolour(img, pal, recolour)) GetNonSprite(recolour, SpriteType::Recolour);
+
+	return RequestSprite(GB(img, 0, SPRITE_WIDTH), SpriteType::Normal);
+}
+
 /**
  * Draw a sprite, not in a viewport
  * @param img  Image number to draw
@@ -1267,8 +1333,13 @@ void GetBroadestDigit(uint *front, uint *next, FontSize size)
 
 void ScreenSizeChanged()
 {
-	_dirty_bytes_per_line = CeilDiv(_screen.width, DIRTY_BLOCK_WIDTH);
-	_dirty_blocks = ReallocT<uint8_t>(_dirty_blocks, static_cast<size_t>(_dirty_bytes_per_line) * CeilDiv(_screen.height, DIRTY_BLOCK_HEIGHT));
+	_dirty_block_columns = CeilDiv(_screen.width, DIRTY_BLOCK_WIDTH);
+	_dirty_block_lines = CeilDiv(_screen.height, DIRTY_BLOCK_HEIGHT);
+	_dirty_bits_per_line = CeilDiv(_dirty_block_columns, DIRTY_BLOCK_BITS);
+	_dirty_blocks.assign(static_cast<size_t>(_dirty_bits_per_line) * _dirty_block_lines, 0);
+	_dirty_lines.assign(CeilDiv(_dirty_block_lines, DIRTY_BLOCK_BITS), 0);
+	_dirty_column_breaks.assign(CeilDiv(_dirty_block_columns + 1, DIRTY_BLOCK_BITS), 0);
+	_dirty_line_breaks.assign(CeilDiv(_dirty_block_lines + 1, DIRTY_BLOCK_BITS), 0);
 
 	/* check the dirty rect */
 	if (_invalid_rect.right >= _screen.width) _invalid_rect.right = _screen.width;
@@ -1387,8 +1458,113 @@ void RedrawScreenRect(int left, int top, int right, int bottom)
 	VideoDriver::GetInstance()->MakeDirty(left, top, right - left, bottom - top);
 }
 
+/**
+ * Get the mask of a range of blocks within a #DirtyBlockBits.
+ * @param first The first block of the range.
+ * @param last The last block of the range, inclusive.
+ * @return The mask.
+ */
+static inline DirtyBlockBits GetDirtyBlockMask(uint first, uint last)
+{
+	assert(first <= last && last < DIRTY_BLOCK_BITS);
+	return (~DirtyBlockBits{0} >> (DIRTY_BLOCK_BITS - 1 - last)) & (~DirtyBlockBits{0} << first);
+}
+
+/**
+ * Set a range of bits of a bitmap of blocks.
+ * @param bitmap The bitmap.
+ * @param first The first block of the range.
+ * @param last The last block of the range, inclusive.
+ */
+static void SetDirtyBlockBits(DirtyBlockBits *bitmap, uint first, uint last)
+{
+	for (uint i = first / DIRTY_BLOCK_BITS; i <= last / DIRTY_BLOCK_BITS; i++) {
+		uint from = std::max(first, i * DIRTY_BLOCK_BITS) - i * DIRTY_BLOCK_BITS;
+		uint to = std::min(last, i * DIRTY_BLOCK_BITS + DIRTY_BLOCK_BITS - 1) - i * DIRTY_BLOCK_BITS;
+		bitmap[i] |= GetDirtyBlockMask(from, to);
+	}
+}
+
+/**
+ * Fill the gaps of single clean blocks between dirty blocks; drawing such a
+ * block costs less than drawing the blocks around it as separate areas.
+ * @param bits The dirty blocks.
+ * @return The dirty blocks, with the gaps filled.
+ */
+static inline DirtyBlockBits BridgeDirtyBlocks(DirtyBlockBits bits)
+{
+	return bits | ((bits << 1) & (bits >> 1));
+}
+
+/**
+ * Mark where the viewports begin and end in the bitmaps of columns and lines of blocks
+ * where areas to redraw are split. Keeping areas within a viewport avoids combining the
+ * expensive drawing of a viewport with that of other windows.
+ */
+static void UpdateDirtyBlockBreaks()
+{
+	std::fill(_dirty_column_breaks.begin(), _dirty_column_breaks.end(), 0);
+	std::fill(_dirty_line_breaks.begin(), _dirty_line_breaks.end(), 0);
+
+	auto set_break = [](std::vector<DirtyBlockBits> &breaks, uint count, int block) {
+		if (block > 0 && static_cast<uint>(block) < count) SetDirtyBlockBits(breaks.data(), block, block);
+	};
+
+	for (const Window *w : Window::Iterate()) {
+		const Viewport *vp = w->viewport;
+		if (vp == nullptr) continue;
+
+		set_break(_dirty_column_breaks, _dirty_block_columns, vp->left / static_cast<int>(DIRTY_BLOCK_WIDTH));
+		set_break(_dirty_column_breaks, _dirty_block_columns, CeilDiv(static_cast<uint>(std::max(vp->left + vp->width, 0)), DIRTY_BLOCK_WIDTH));
+		set_break(_dirty_line_breaks, _dirty_block_lines, vp->top / static_cast<int>(DIRTY_BLOCK_HEIGHT));
+		set_break(_dirty_line_breaks, _dirty_block_lines, CeilDiv(static_cast<uint>(std::max(vp->top + vp->height, 0)), DIRTY_BLOCK_HEIGHT));
+	}
+}
+
+/**
+ * Take the area to redraw that starts at a dirty block, and mark its blocks clean.
+ * The area is grown to the right over the dirty blocks of the line, and then downwards
+ * for as long as the lines below have the same blocks dirty. It is not grown beyond
+ * where a viewport begins or ends, nor beyond the blocks of a single #DirtyBlockBits.
+ * @param line The line of the dirty block.
+ * @param index Index of the #DirtyBlockBits of the dirty block within the line.
+ * @param first Index of the dirty block within the #DirtyBlockBits.
+ * @return The area in screen coordinates.
+ */
+static Rect TakeDirtyArea(uint line, uint index, uint first)
+{
+	DirtyBlockBits *bits = &_dirty_blocks[line * _dirty_bits_per_line + index];
+
+	/* Stop at the first break after the first block. */
+	uint last = first + std::countr_one(*bits >> first) - 1;
+	if (last > first) {
+		DirtyBlockBits breaks = _dirty_column_breaks[index] & GetDirtyBlockMask(first + 1, last);
+		if (breaks != 0) last = FindFirstBit(breaks) - 1;
+	}
+
+	DirtyBlockBits mask = GetDirtyBlockMask(first, last);
+	*bits &= ~mask;
+
+	uint bottom = line + 1;
+	while (bottom < _dirty_block_lines && !HasBit(_dirty_line_breaks[bottom / DIRTY_BLOCK_BITS], bottom % DIRTY_BLOCK_BITS)) {
+		bits += _dirty_bits_per_line;
+		if ((*bits & mask) != mask) break;
+		*bits &= ~mask;
+		bottom++;
+	}
+
+	return {
+		static_cast<int>((index * DIRTY_BLOCK_BITS + first) * DIRTY_BLOCK_WIDTH),
+		static_cast<int>(line * DIRTY_BLOCK_HEIGHT),
+		static_cast<int>((index * DIRTY_BLOCK_BITS + last + 1) * DIRTY_BLOCK_WIDTH),
+		static_cast<int>(bottom * DIRTY_BLOCK_HEIGHT)
+	};
+}
+
 /**
  * Repaints the rectangle blocks which are marked as 'dirty'.
+ * Lines without dirty blocks are skipped via #_dirty_lines, and within a
+ * line the dirty blocks are found a #DirtyBlockBits at a time.
  *
  * @see AddDirtyBlock
  *
@@ -1396,77 +1572,52 @@ void RedrawScreenRect(int left, int top, int right, int bottom)
  */
 void DrawDirtyBlocks()
 {
-	uint8_t *b = _dirty_blocks;
-	const int w = Align(_screen.width,  DIRTY_BLOCK_WIDTH);
-	const int h = Align(_screen.height, DIRTY_BLOCK_HEIGHT);
-	int x;
-	int y;
-
-	y = 0;
-	do {
-		x = 0;
-		do {
-			if (*b != 0) {
-				int left;
-				int top;
-				int right = x + DIRTY_BLOCK_WIDTH;
-				int bottom = y;
-				uint8_t *p = b;
-				int h2;
-
-				/* First try coalescing downwards */
-				do {
-					*p = 0;
-					p += _dirty_bytes_per_line;
-					bottom += DIRTY_BLOCK_HEIGHT;
-				} while (bottom != h && *p != 0);
-
-				/* Try coalescing to the right too. */
-				h2 = (bottom - y) / DIRTY_BLOCK_HEIGHT;
-				assert(h2 > 0);
-				p = b;
-
-				while (right != w) {
-					uint8_t *p2 = ++p;
-					int i = h2;
-					/* Check if a full line of dirty flags is set. */
-					do {
-						if (!*p2) goto no_more_coalesc;
-						p2 += _dirty_bytes_per_line;
-					} while (--i != 0);
-
-					/* Wohoo, can combine it one step to the right!
-					 * Do that, and clear the bits. */
-					right += DIRTY_BLOCK_WIDTH;
-
-					i = h2;
-					p2 = p;
-					do {
-						*p2 = 0;
-						p2 += _dirty_bytes_per_line;
-					} while (--i != 0);
-				}
-				no_more_coalesc:
-
-				left = x;
-				top = y;
-
-				if (left   < _invalid_rect.left  ) left   = _invalid_rect.left;
-				if (top    < _invalid_rect.top   ) top    = _invalid_rect.top;
-				if (right  > _invalid_rect.right ) right  = _invalid_rect.right;
-				if (bottom > _invalid_rect.bottom) bottom = _invalid_rect.bottom;
+	UpdateDirtyBlockBreaks();
+
+	/* Fill the gaps before taking any areas, so blocks that have been drawn already are not filled in again. */
+	for (uint i = 0; i < _dirty_lines.size(); i++) {
+		for (uint l : SetBitIterator(_dirty_lines[i])) {
+			uint line = i * DIRTY_BLOCK_BITS + l;
+			for (uint index = 0; index < _dirty_bits_per_line; index++) {
+				DirtyBlockBits &bits = _dirty_blocks[line * _dirty_bits_per_line + index];
+				bits = BridgeDirtyBlocks(bits);
+			}
+		}
+	}
 
-				if (left < right && top < bottom) {
-					RedrawScreenRect(left, top, right, bottom);
+	for (uint i = 0; i < _dirty_lines.size(); i++) {
+		/* Lines might be marked dirty again while drawing; those are drawn the next time. */
+		DirtyBlockBits lines = _dirty_lines[i];
+		_dirty_lines[i] = 0;
+
+		for (uint l : SetBitIterator(lines)) {
+			uint line = i * DIRTY_BLOCK_BITS + l;
+			for (uint index = 0; index < _dirty_bits_per_line; index++) {
+				/* Blocks before the last area might be marked dirty again while drawing; those are drawn the next time. */
+				uint next = 0;
+				while (next < DIRTY_BLOCK_BITS) {
+					DirtyBlockBits bits = _dirty_blocks[line * _dirty_bits_per_line + index] & (~DirtyBlockBits{0} << next);
+					if (bits == 0) break;
+
+					Rect r = TakeDirtyArea(line, index, FindFirstBit(bits));
+					next = r.right / DIRTY_BLOCK_WIDTH - index * DIRTY_BLOCK_BITS;
+
+					r.left = std::max(r.left, _invalid_rect.left);
+					r.top = std::max(r.top, _invalid_rect.top);
+					r.right = std::min(r.right, _invalid_rect.right);
+					r.bottom = std::min(r.bottom, _invalid_rect.bottom);
+
+					if (r.left < r.right && r.top < r.bottom) {
+						RedrawScreenRect(r.left, r.top, r.right, r.bottom);
+					}
 				}
-
 			}
-		} while (b++, (x += DIRTY_BLOCK_WIDTH) != w);
-	} while (b += -(int)(w / DIRTY_BLOCK_WIDTH) + _dirty_bytes_per_line, (y += DIRTY_BLOCK_HEIGHT) != h);
+		}
+	}
 
 	++_dirty_block_colour;
-	_invalid_rect.left = w;
-	_invalid_rect.top = h;
+	_invalid_rect.left = _screen.width;
+	_invalid_rect.top = _screen.height;
 	_invalid_rect.right = 0;
 	_invalid_rect.bottom = 0;
 }
@@ -1485,10 +1636,6 @@ void DrawDirtyBlocks()
  */
 void AddDirtyBlock(int left, int top, int right, int bottom)
 {
-	uint8_t *b;
-	int width;
-	int height;
-
 	if (left < 0) left = 0;
 	if (top < 0) top = 0;
 	if (right > _screen.width) right = _screen.width;
@@ -1501,23 +1648,15 @@ void AddDirtyBlock(int left, int top, int right, int bottom)
 	if (right  > _invalid_rect.right ) _invalid_rect.right  = right;
 	if (bottom > _invalid_rect.bottom) _invalid_rect.bottom = bottom;
 
-	left /= DIRTY_BLOCK_WIDTH;
-	top  /= DIRTY_BLOCK_HEIGHT;
-
-	b = _dirty_blocks + top * _dirty_bytes_per_line + left;
+	uint first = left / DIRTY_BLOCK_WIDTH;
+	uint last = (right - 1) / DIRTY_BLOCK_WIDTH;
+	uint top_line = top / DIRTY_BLOCK_HEIGHT;
+	uint bottom_line = (bottom - 1) / DIRTY_BLOCK_HEIGHT;
 
-	width  = ((right  - 1) / DIRTY_BLOCK_WIDTH)  - left + 1;
-	height = ((bottom - 1) / DIRTY_BLOCK_HEIGHT) - top  + 1;
-
-	assert(width > 0 && height > 0);
-
-	do {
-		int i = width;
-
-		do b[--i] = 0xFF; while (i != 0);
-
-		b += _dirty_bytes_per_line;
-	} while (--height != 0);
+	for (uint line = top_line; line <= bottom_line; line++) {
+		SetDirtyBlockBits(&_dirty_blocks[line * _dirty_bits_per_line], first, last);
+	}
+	SetDirtyBlockBits(_dirty_lines.data(), top_line, bottom_line);
 }
 
 /**
@@ -1528,6 +1667,8 @@ void AddDirtyBlock(int left, int top, int right, int bottom)
  */
 void MarkWholeScreenDirty()
 {
+	/* Whatever changed might change how any tile looks, e.g. transparency or company colours. */
+	ClearTileDrawCache();
 	AddDirtyBlock(0, 0, _screen.width, _screen.height);
 }
 
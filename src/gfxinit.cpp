@@ -18,6 +18,7 @@
 #include "video/video_driver.hpp"
 #include "window_func.h"
 #include "palette_func.h"
+#include "md5sum_cache.h"
 
 /* The type of set we're replacing */
 #define SET_TYPE "graphics"
@@ -274,9 +275,11 @@ static bool SwitchNewGRFBlitter()
 		{ "8bpp-optimized",  2,  8,  8,  8,  8 },
 		{ "40bpp-anim",      2,  8, 32,  8, 32 },
 #ifdef WITH_SSE
+		{ "32bpp-avx2",      0, 32, 32,  8, 32 },
 		{ "32bpp-sse4",      0, 32, 32,  8, 32 },
 		{ "32bpp-ssse3",     0, 32, 32,  8, 32 },
 		{ "32bpp-sse2",      0, 32, 32,  8, 32 },
+		{ "32bpp-avx2-anim", 1, 32, 32,  8, 32 },
 		{ "32bpp-sse4-anim", 1, 32, 32,  8, 32 },
 #endif
 		{ "32bpp-optimized", 0,  8, 32,  8, 32 },
@@ -435,23 +438,28 @@ void GraphicsSet::CopyCompatibleConfig(const GraphicsSet &src)
  */
 MD5File::ChecksumResult MD5File::CheckMD5(Subdirectory subdir, size_t max_size) const
 {
-	size_t size;
-	auto f = FioFOpenFile(this->filename, "rb", subdir, &size);
-	if (!f.has_value()) return CR_NO_FILE;
+	MD5Hash digest;
+	bool found = GetCachedMD5Sum(this->filename, subdir, digest, [this, subdir, max_size](MD5Hash &md5sum) {
+		size_t size;
+		auto f = FioFOpenFile(this->filename, "rb", subdir, &size);
+		if (!f.has_value()) return false;
 
-	size = std::min(size, max_size);
+		size = std::min(size, max_size);
 
-	Md5 checksum;
-	uint8_t buffer[1024];
-	MD5Hash digest;
-	size_t len;
+		Md5 checksum;
+		uint8_t buffer[1024];
+		size_t len;
 
-	while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, *f)) != 0 && size != 0) {
-		size -= len;
-		checksum.Append(buffer, len);
-	}
+		while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, *f)) != 0 && size != 0) {
+			size -= len;
+			checksum.Append(buffer, len);
+		}
+
+		checksum.Finish(md5sum);
+		return true;
+	}, max_size);
+	if (!found) return CR_NO_FILE;
 
-	checksum.Finish(digest);
 	return this->hash == digest ? CR_MATCH : CR_MISMATCH;
 }
 
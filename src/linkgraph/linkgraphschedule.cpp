@@ -17,6 +17,7 @@
 #include "../command_func.h"
 #include "../network/network.h"
 #include "../misc_cmd.h"
+#include "../video/video_driver.hpp"
 
 #include "../safeguards.h"
 
@@ -71,6 +72,14 @@ void LinkGraphSchedule::JoinNext()
 	LinkGraphJob *next = this->running.front();
 	if (!next->IsScheduledToBeJoined()) return;
 	this->running.pop_front();
+
+	/* The job only works on its own copy of the link graph, so drawing may happen while waiting for it. */
+	VideoDriver *driver = VideoDriver::GetInstance();
+	while (driver != nullptr && !next->IsJobCompleted()) {
+		driver->GameLoopDrawPoint();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
 	LinkGraphID id = next->LinkGraphIndex();
 	delete next; // implicitly joins the thread
 	if (LinkGraph::IsValidID(id)) {
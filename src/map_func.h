@@ -290,6 +290,26 @@ public:
 		return Map::size;
 	}
 
+	/**
+	 * Get the memory of the base tile-array, to save or load it as a whole.
+	 * @note The layout of the memory depends on the byte order of the architecture.
+	 * @return The memory of the base tile-array.
+	 */
+	static inline std::span<uint8_t> GetBaseTileMemory()
+	{
+		return {reinterpret_cast<uint8_t *>(Tile::base_tiles), Map::size * sizeof(Tile::TileBase)};
+	}
+
+	/**
+	 * Get the memory of the extended tile-array, to save or load it as a whole.
+	 * @note The layout of the memory depends on the byte order of the architecture.
+	 * @return The memory of the extended tile-array.
+	 */
+	static inline std::span<uint8_t> GetExtendedTileMemory()
+	{
+		return {reinterpret_cast<uint8_t *>(Tile::extended_tiles), Map::size * sizeof(Tile::TileExtended)};
+	}
+
 	/**
 	 * Gets the maximum X coordinate within the map, including MP_VOID
 	 * @return the maximum X coordinate
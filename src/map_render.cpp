@@ -0,0 +1,52 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file map_render.cpp Rendering images of the map of savegames without a GUI. */
+
+#include "stdafx.h"
+#include "debug.h"
+#include "fileio_type.h"
+#include "newgrf_config.h"
+#include "openttd.h"
+#include "screenshot.h"
+#include "window_func.h"
+#include "saveload/saveload.h"
+#include "map_render.h"
+
+#include "safeguards.h"
+
+MapRender _map_render;
+
+extern bool SafeLoad(const std::string &filename, SaveLoadOperation fop, DetailedFileType dft, GameMode newgm, Subdirectory subdir, std::shared_ptr<struct LoadFilter> lf);
+
+/**
+ * Render the map of the savegame requested in #_map_render. The game has to be fully
+ * initialised, including the NewGRF scan, before the savegame can be loaded.
+ */
+void RunMapRender()
+{
+	ResetGRFConfig(true);
+	ResetWindowSystem();
+	if (!SafeLoad(_map_render.savegame, SLO_LOAD, DFT_GAME_FILE, GM_NORMAL, NO_DIRECTORY, nullptr)) {
+		Debug(misc, 0, "Cannot load {}", _map_render.savegame);
+		_map_render.failed = true;
+		return;
+	}
+
+	if (!_map_render.image.empty()) {
+		Debug(misc, 1, "Rendering the map of {} to {}", _map_render.savegame, _map_render.image);
+		if (!MakeWorldImage(_map_render.image, _map_render.zoom)) {
+			Debug(misc, 0, "Cannot write {}", _map_render.image);
+			_map_render.failed = true;
+		}
+	}
+
+	if (!_map_render.tiles.empty()) {
+		Debug(misc, 1, "Rendering the map tiles of {} to {}", _map_render.savegame, _map_render.tiles);
+		if (!MakeWorldTiles(_map_render.tiles, _map_render.zoom)) _map_render.failed = true;
+	}
+}
@@ -0,0 +1,28 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file map_render.h Rendering images of the map of savegames without a GUI. */
+
+#ifndef MAP_RENDER_H
+#define MAP_RENDER_H
+
+#include "zoom_type.h"
+
+/** What to render, as requested by the openttd_render tool. */
+struct MapRender {
+	std::string savegame;  ///< The savegame to render the map of; nothing is rendered when empty.
+	std::string image;     ///< File to write an image of the whole map to; no image is written when empty.
+	std::string tiles;     ///< Directory to write a pyramid of map tiles to; no tiles are written when empty.
+	ZoomLevel zoom = ZOOM_LVL_WORLD_SCREENSHOT; ///< Zoom level of the image, and of the most detailed level of the tiles.
+	bool failed = false;   ///< Whether loading the savegame or writing any of the output failed.
+};
+
+extern MapRender _map_render;
+
+void RunMapRender();
+
+#endif /* MAP_RENDER_H */
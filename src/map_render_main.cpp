@@ -0,0 +1,125 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file map_render_main.cpp Main entry for rendering the map of a savegame without a GUI, openttd_render. */
+
+#include "stdafx.h"
+#include "openttd.h"
+#include "crashlog.h"
+#include "core/format.hpp"
+#include "core/random_func.hpp"
+#include "misc/getoptdata.h"
+#include "string_func.h"
+#include "map_render.h"
+
+#include <charconv>
+#include <filesystem>
+#include <time.h>
+
+#include "safeguards.h"
+
+/** Options of openttd_render. */
+static const OptionData _options[] = {
+	{ .type = ODF_HAS_VALUE, .id = 'b', .shortname = 'b' },
+	{ .type = ODF_HAS_VALUE, .id = 'c', .shortname = 'c' },
+	{ .type = ODF_NO_VALUE, .id = 'h', .shortname = 'h' },
+	{ .type = ODF_HAS_VALUE, .id = 'o', .shortname = 'o' },
+	{ .type = ODF_HAS_VALUE, .id = 't', .shortname = 't' },
+	{ .type = ODF_HAS_VALUE, .id = 'z', .shortname = 'z' },
+};
+
+/** Show the usage of openttd_render. */
+static void ShowUsage()
+{
+	fmt::print(stderr,
+		"Usage: openttd_render [options] savegame\n"
+		"  -b blitter      = Render with this blitter (default 32bpp-optimized)\n"
+		"  -c config_file  = Use 'config_file' instead of 'openttd.cfg'\n"
+		"  -o file         = Write an image of the whole map to 'file';\n"
+		"                    its extension selects the format, e.g. 'png'\n"
+		"  -t directory    = Write a pyramid of 256x256 map tiles to 'directory',\n"
+		"                    as 'directory/level/x/y.png' like slippy maps use\n"
+		"  -z zoom         = Zoom level of the image, and of the most detailed tiles;\n"
+		"                    0 (zoomed in 4x) to 5 (zoomed out 8x), default 2\n"
+		"  -h              = Show this help\n");
+}
+
+/**
+ * Make a path absolute, as the game may change its working directory.
+ * @param path The path.
+ * @return The absolute path.
+ */
+static std::string MakeAbsolute(const char *path)
+{
+	return FS2OTTD(std::filesystem::absolute(OTTD2FS(path)));
+}
+
+int CDECL main(int argc, char *argv[])
+{
+	/* Make sure our arguments contain only valid UTF-8 characters. */
+	for (int i = 0; i < argc; i++) StrMakeValidInPlace(argv[i]);
+
+	CrashLog::InitialiseCrashLog();
+
+	SetRandomSeed(time(nullptr));
+
+	std::string blitter = "32bpp-optimized";
+	std::vector<std::string> arguments = { argv[0], "-s", "null", "-m", "null" };
+
+	GetOptData mgo(std::span(argv, argc).subspan(1), _options);
+	int i;
+	while ((i = mgo.GetOpt()) != -1) {
+		switch (i) {
+			case 'b':
+				blitter = mgo.opt;
+				break;
+
+			case 'c':
+				arguments.insert(arguments.end(), { "-c", mgo.opt });
+				break;
+
+			case 'o':
+				_map_render.image = MakeAbsolute(mgo.opt);
+				break;
+
+			case 't':
+				_map_render.tiles = MakeAbsolute(mgo.opt);
+				break;
+
+			case 'z': {
+				std::string_view value = mgo.opt;
+				int zoom;
+				auto [end, err] = std::from_chars(value.data(), value.data() + value.size(), zoom);
+				if (err != std::errc() || end != value.data() + value.size() || zoom < ZOOM_LVL_MIN || zoom > ZOOM_LVL_MAX) {
+					ShowUsage();
+					return 1;
+				}
+				_map_render.zoom = static_cast<ZoomLevel>(zoom);
+				break;
+			}
+
+			default:
+				ShowUsage();
+				return i == 'h' ? 0 : 1;
+		}
+	}
+
+	if (mgo.arguments.size() != 1 || (_map_render.image.empty() && _map_render.tiles.empty())) {
+		ShowUsage();
+		return 1;
+	}
+	_map_render.savegame = MakeAbsolute(mgo.arguments[0]);
+
+	/* Run the game without screen, sound and music; the null video driver renders the map once everything is loaded. */
+	arguments.insert(arguments.end(), { "-v", fmt::format("null:ticks=1,blitter={}", blitter) });
+
+	std::vector<char *> openttd_arguments;
+	for (std::string &argument : arguments) openttd_arguments.push_back(argument.data());
+
+	int ret = openttd_main(openttd_arguments);
+	return (ret == 0 && _map_render.failed) ? 1 : ret;
+}
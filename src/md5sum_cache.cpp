@@ -0,0 +1,185 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file md5sum_cache.cpp Persistent cache of the MD5 sums of NewGRFs and base set files.
+ *
+ * Calculating the MD5 sums means reading every NewGRF and base set file completely, on every
+ * start and rescan. The cache stores the MD5 sums keyed by the full path of the file and the
+ * number of bytes from its start that were hashed, together with the size and modification time
+ * of the file, so unchanged files do not need to be read.
+ * Files inside tars are not cached, as they have no modification time of their own.
+ */
+
+#include "stdafx.h"
+#include "debug.h"
+#include "fileio_func.h"
+#include "ini_type.h"
+#include "string_func.h"
+#include "md5sum_cache.h"
+
+#include <charconv>
+#include <filesystem>
+#include <mutex>
+
+#include "safeguards.h"
+
+/** File the MD5 sum cache is stored in. */
+std::string _md5sum_cache_file;
+
+/** Name of the group in the cache file. */
+static const std::string_view MD5SUM_CACHE_GROUP = "md5sums";
+
+/** A cached MD5 sum of a file. */
+struct MD5SumCacheEntry {
+	uintmax_t size; ///< Size of the file when the MD5 sum was calculated.
+	int64_t mtime; ///< Modification time of the file when the MD5 sum was calculated.
+	MD5Hash md5sum; ///< The MD5 sum of the file.
+};
+
+static std::mutex _md5sum_cache_mutex; ///< Mutex protecting the cache, as MD5 sums are calculated from multiple threads.
+/** Key of a cached MD5 sum: the full path of the file, and the maximum number of bytes from its start that were hashed. */
+using MD5SumCacheKey = std::pair<std::string, size_t>;
+
+static std::map<MD5SumCacheKey, MD5SumCacheEntry> _md5sum_cache; ///< The cached MD5 sums, by full path and hashed length.
+static bool _md5sum_cache_loaded = false; ///< Whether the cache file has been loaded.
+static bool _md5sum_cache_dirty = false; ///< Whether the cache has changed since loading.
+
+/**
+ * Parse a single cache entry, formatted as "<md5sum> <size> <mtime> <max_size>".
+ * @param value The value of the ini item.
+ * @param[out] entry The entry to fill.
+ * @param[out] max_size The maximum number of bytes from the start of the file that were hashed.
+ * @return True iff the value was valid.
+ */
+static bool ParseMD5SumCacheEntry(std::string_view value, MD5SumCacheEntry &entry, size_t &max_size)
+{
+	if (value.size() < MD5_HASH_BYTES * 2 + 1) return false;
+	if (!ConvertHexToBytes(value.substr(0, MD5_HASH_BYTES * 2), entry.md5sum)) return false;
+	value.remove_prefix(MD5_HASH_BYTES * 2 + 1);
+
+	const char *end = value.data() + value.size();
+	auto [size_end, size_err] = std::from_chars(value.data(), end, entry.size);
+	if (size_err != std::errc() || size_end == end || *size_end != ' ') return false;
+
+	auto [mtime_end, mtime_err] = std::from_chars(size_end + 1, end, entry.mtime);
+	if (mtime_err != std::errc() || mtime_end == end || *mtime_end != ' ') return false;
+
+	auto [max_size_end, max_size_err] = std::from_chars(mtime_end + 1, end, max_size);
+	if (max_size_err != std::errc() || max_size_end != end) return false;
+
+	return true;
+}
+
+/** Load the cache from disk, if that has not been done yet. Must be called with the mutex held. */
+static void LoadMD5SumCache()
+{
+	if (_md5sum_cache_loaded) return;
+	_md5sum_cache_loaded = true;
+
+	if (_md5sum_cache_file.empty()) return;
+
+	IniFile ini;
+	ini.LoadFromDisk(_md5sum_cache_file, NO_DIRECTORY);
+
+	const IniGroup *group = ini.GetGroup(MD5SUM_CACHE_GROUP);
+	if (group == nullptr) return;
+
+	for (const IniItem &item : group->items) {
+		MD5SumCacheEntry entry;
+		size_t max_size;
+		if (!item.value.has_value() || !ParseMD5SumCacheEntry(*item.value, entry, max_size)) continue;
+		_md5sum_cache[{item.name, max_size}] = entry;
+	}
+
+	Debug(misc, 3, "Loaded {} cached MD5 sums", _md5sum_cache.size());
+}
+
+/**
+ * Get the size and modification time of a file.
+ * @param path The full path to the file.
+ * @param[out] size The size of the file.
+ * @param[out] mtime The modification time of the file.
+ * @return True iff the file exists and both could be determined.
+ */
+static bool GetFileSizeAndTime(const std::string &path, uintmax_t &size, int64_t &mtime)
+{
+	std::error_code ec;
+	std::filesystem::path fs_path(OTTD2FS(path));
+
+	size = std::filesystem::file_size(fs_path, ec);
+	if (ec) return false;
+
+	auto time = std::filesystem::last_write_time(fs_path, ec);
+	if (ec) return false;
+
+	mtime = static_cast<int64_t>(time.time_since_epoch().count());
+	return true;
+}
+
+/**
+ * Get the MD5 sum of a file, from the cache when the file did not change since it was cached.
+ * Otherwise the MD5 sum is calculated and stored in the cache.
+ * This function may be called from multiple threads at the same time.
+ * @param filename The name of the file.
+ * @param subdir The subdirectory to look for the file in.
+ * @param[out] md5sum The MD5 sum of the file.
+ * @param calculate Function to calculate the MD5 sum when it is not cached.
+ * @param max_size The maximum number of bytes from the start of the file \a calculate hashes.
+ * @return True iff the MD5 sum is known.
+ */
+bool GetCachedMD5Sum(const std::string &filename, Subdirectory subdir, MD5Hash &md5sum, const MD5SumCalculator &calculate, size_t max_size)
+{
+	std::string path = FioFindFullPath(subdir, filename);
+	uintmax_t size;
+	int64_t mtime;
+	if (path.empty() || !GetFileSizeAndTime(path, size, mtime)) return calculate(md5sum);
+
+	{
+		std::lock_guard<std::mutex> lock(_md5sum_cache_mutex);
+		LoadMD5SumCache();
+
+		auto it = _md5sum_cache.find({path, max_size});
+		if (it != _md5sum_cache.end() && it->second.size == size && it->second.mtime == mtime) {
+			md5sum = it->second.md5sum;
+			return true;
+		}
+	}
+
+	if (!calculate(md5sum)) return false;
+
+	std::lock_guard<std::mutex> lock(_md5sum_cache_mutex);
+	_md5sum_cache[{path, max_size}] = { size, mtime, md5sum };
+	_md5sum_cache_dirty = true;
+	return true;
+}
+
+/**
+ * Save the cache to disk when it changed. Entries of files that no longer
+ * exist are dropped from the cache.
+ */
+void SaveMD5SumCache()
+{
+	std::lock_guard<std::mutex> lock(_md5sum_cache_mutex);
+
+	LoadMD5SumCache();
+
+	std::error_code ec;
+	size_t removed = std::erase_if(_md5sum_cache, [&ec](const auto &it) { return !std::filesystem::exists(OTTD2FS(it.first.first), ec); });
+	if ((!_md5sum_cache_dirty && removed == 0) || _md5sum_cache_file.empty()) return;
+
+	IniFile ini;
+	IniGroup &group = ini.GetOrCreateGroup(MD5SUM_CACHE_GROUP);
+	for (const auto &[key, entry] : _md5sum_cache) {
+		/* A file may be hashed with different lengths, so the path is not unique in the group. */
+		group.CreateItem(key.first).SetValue(fmt::format("{} {} {} {}", FormatArrayAsHex(entry.md5sum), entry.size, entry.mtime, key.second));
+	}
+	ini.SaveToDisk(_md5sum_cache_file);
+
+	_md5sum_cache_dirty = false;
+	Debug(misc, 3, "Saved {} cached MD5 sums", _md5sum_cache.size());
+}
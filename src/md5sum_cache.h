@@ -0,0 +1,26 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file md5sum_cache.h Persistent cache of the MD5 sums of NewGRFs and base set files. */
+
+#ifndef MD5SUM_CACHE_H
+#define MD5SUM_CACHE_H
+
+#include "fileio_type.h"
+#include "3rdparty/md5/md5.h"
+
+/**
+ * Function calculating the MD5 sum of a file.
+ * @param[out] md5sum The calculated MD5 sum.
+ * @return True iff the MD5 sum could be calculated.
+ */
+using MD5SumCalculator = std::function<bool(MD5Hash &md5sum)>;
+
+bool GetCachedMD5Sum(const std::string &filename, Subdirectory subdir, MD5Hash &md5sum, const MD5SumCalculator &calculate, size_t max_size = SIZE_MAX);
+void SaveMD5SumCache();
+
+#endif /* MD5SUM_CACHE_H */
@@ -62,8 +62,9 @@ Packet::Packet(NetworkSocketHandler *cs, PacketType type, size_t limit) : pos(0)
 
 /**
  * Writes the packet size from the raw packet from packet->size
+ * @param defer_encryption Whether to leave the encryption to a later call to #EncryptForSending.
  */
-void Packet::PrepareToSend()
+void Packet::PrepareToSend(bool defer_encryption)
 {
 	/* Prevent this to be called twice and for packets that have been received. */
 	assert(this->buffer[0] == 0 && this->buffer[1] == 0);
@@ -71,17 +72,27 @@ void Packet::PrepareToSend()
 	this->buffer[0] = GB(this->Size(), 0, 8);
 	this->buffer[1] = GB(this->Size(), 8, 8);
 
-	if (cs != nullptr && cs->send_encryption_handler != nullptr) {
-		size_t offset = EncodedLengthOfPacketSize();
-		size_t mac_size = cs->send_encryption_handler->MACSize();
-		size_t message_offset = offset + mac_size;
-		cs->send_encryption_handler->Encrypt(std::span(&this->buffer[offset], mac_size), std::span(&this->buffer[message_offset], this->buffer.size() - message_offset));
-	}
+	if (!defer_encryption) this->EncryptForSending();
 
 	this->pos  = 0; // We start reading from here
 	this->buffer.shrink_to_fit();
 }
 
+/**
+ * Encrypt the packet with the send encryption handler of the socket, if any.
+ * This does not touch the read/write position, so it can be done from another
+ * thread once #PrepareToSend has been called with deferred encryption.
+ */
+void Packet::EncryptForSending()
+{
+	if (cs == nullptr || cs->send_encryption_handler == nullptr) return;
+
+	size_t offset = EncodedLengthOfPacketSize();
+	size_t mac_size = cs->send_encryption_handler->MACSize();
+	size_t message_offset = offset + mac_size;
+	cs->send_encryption_handler->Encrypt(std::span(&this->buffer[offset], mac_size), std::span(&this->buffer[message_offset], this->buffer.size() - message_offset));
+}
+
 /**
  * Is it safe to write to the packet, i.e. didn't we run over the buffer?
  * @param bytes_to_write The amount of bytes we want to try to write.
@@ -58,7 +58,8 @@ public:
 	Packet(NetworkSocketHandler *cs, PacketType type, size_t limit = COMPAT_MTU);
 
 	/* Sending/writing of packets */
-	void PrepareToSend();
+	void PrepareToSend(bool defer_encryption = false);
+	void EncryptForSending();
 
 	bool   CanWriteToPacket(size_t bytes_to_write);
 	void   Send_bool  (bool   data);
@@ -11,11 +11,82 @@
 
 #include "../../stdafx.h"
 #include "../../debug.h"
+#include "../../thread.h"
 
 #include "tcp.h"
 
+#include <condition_variable>
+#include <mutex>
+
 #include "../../safeguards.h"
 
+/** A packet that is waiting to be encrypted by the encryption thread. */
+struct PendingEncryption {
+	Packet *packet; ///< The packet to encrypt; owned by the packet queue of the socket.
+	std::atomic<size_t> *pending; ///< The counter of the socket's packets waiting on encryption.
+};
+
+static std::thread _encryption_thread; ///< Thread encrypting outgoing packets for all TCP connections.
+static std::mutex _encryption_mutex; ///< Mutex guarding the encryption queue.
+static std::condition_variable _encryption_cv; ///< Signal for new work for the encryption thread, or for it to exit.
+static std::condition_variable _encryption_done_cv; ///< Signal that a packet has been encrypted.
+static std::deque<PendingEncryption> _encryption_queue; ///< Packets waiting to be encrypted, in order of sending.
+static bool _encryption_thread_exit = false; ///< Whether the encryption thread should exit once its queue is empty.
+
+/**
+ * Encrypt the queued packets, in order, until told to exit.
+ * As all packets go through a single queue, the order of packets of a single connection is retained,
+ * which is required as the nonce of the encryption is advanced with every packet.
+ */
+static void EncryptionThread()
+{
+	std::unique_lock<std::mutex> lock(_encryption_mutex);
+
+	for (;;) {
+		_encryption_cv.wait(lock, []() { return _encryption_thread_exit || !_encryption_queue.empty(); });
+		if (_encryption_queue.empty()) return;
+
+		PendingEncryption job = _encryption_queue.front();
+		_encryption_queue.pop_front();
+
+		lock.unlock();
+		job.packet->EncryptForSending();
+		lock.lock();
+
+		(*job.pending)--;
+		_encryption_done_cv.notify_all();
+	}
+}
+
+/**
+ * Start the thread that encrypts outgoing packets, so the game loop only needs to queue them.
+ */
+void NetworkTCPEncryptionThreadInitialize()
+{
+	if (_encryption_thread.joinable()) return;
+
+	_encryption_thread_exit = false;
+	if (!StartNewThread(&_encryption_thread, "ottd:crypto", &EncryptionThread)) {
+		Debug(net, 1, "Failed to start encryption thread; encrypting packets on the game thread");
+	}
+}
+
+/**
+ * Stop the encryption thread, after it has encrypted all packets still in its queue.
+ */
+void NetworkTCPEncryptionThreadUninitialize()
+{
+	if (!_encryption_thread.joinable()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(_encryption_mutex);
+		_encryption_thread_exit = true;
+		_encryption_cv.notify_one();
+	}
+
+	_encryption_thread.join();
+}
+
 /**
  * Construct a socket handler for a TCP connection.
  * @param s The just opened TCP connection.
@@ -28,9 +99,22 @@ NetworkTCPSocketHandler::NetworkTCPSocketHandler(SOCKET s) :
 
 NetworkTCPSocketHandler::~NetworkTCPSocketHandler()
 {
+	this->WaitForPendingEncryption();
 	this->CloseSocket();
 }
 
+/**
+ * Wait until the encryption thread is done with all packets of this connection,
+ * so the packets in the queue can safely be removed.
+ */
+void NetworkTCPSocketHandler::WaitForPendingEncryption()
+{
+	if (this->pending_encryption == 0) return;
+
+	std::unique_lock<std::mutex> lock(_encryption_mutex);
+	_encryption_done_cv.wait(lock, [this]() { return this->pending_encryption == 0; });
+}
+
 /**
  * Close the actual socket of the connection.
  * Please make sure CloseConnection is called before CloseSocket, as
@@ -53,6 +137,7 @@ NetworkRecvStatus NetworkTCPSocketHandler::CloseConnection([[maybe_unused]] bool
 	this->MarkClosed();
 	this->writable = false;
 
+	this->WaitForPendingEncryption();
 	this->packet_queue.clear();
 	this->packet_recv = nullptr;
 
@@ -63,14 +148,27 @@ NetworkRecvStatus NetworkTCPSocketHandler::CloseConnection([[maybe_unused]] bool
  * This function puts the packet in the send-queue and it is send as
  * soon as possible. This is the next tick, or maybe one tick later
  * if the OS-network-buffer is full)
+ * When the encryption thread is running, encryption of the packet is left to that thread.
  * @param packet the packet to send
  */
 void NetworkTCPSocketHandler::SendPacket(std::unique_ptr<Packet> &&packet)
 {
 	assert(packet != nullptr);
 
-	packet->PrepareToSend();
+	if (!_encryption_thread.joinable() || this->send_encryption_handler == nullptr) {
+		packet->PrepareToSend();
+		this->packet_queue.push_back(std::move(packet));
+		return;
+	}
+
+	packet->PrepareToSend(true);
+	Packet *p = packet.get();
+	this->pending_encryption++;
 	this->packet_queue.push_back(std::move(packet));
+
+	std::lock_guard<std::mutex> lock(_encryption_mutex);
+	_encryption_queue.push_back({ p, &this->pending_encryption });
+	_encryption_cv.notify_one();
 }
 
 /**
@@ -89,7 +187,13 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 	if (!this->writable) return SPS_NONE_SENT;
 	if (!this->IsConnected()) return SPS_CLOSED;
 
+	/* The connection is torn down after this, so the last packets may not be left to the encryption thread. */
+	if (closing_down) this->WaitForPendingEncryption();
+
 	while (!this->packet_queue.empty()) {
+		/* The packets waiting for encryption are always at the end of the queue. */
+		if (this->packet_queue.size() <= this->pending_encryption) return SPS_PARTLY_SENT;
+
 		Packet &p = *this->packet_queue.front();
 		ssize_t res = p.TransferOut<int>(send, this->sock, 0);
 		if (res == -1) {
@@ -32,8 +32,10 @@ class NetworkTCPSocketHandler : public NetworkSocketHandler {
 private:
 	std::deque<std::unique_ptr<Packet>> packet_queue; ///< Packets that are awaiting delivery. Cannot be std::queue as that does not have a clear() function.
 	std::unique_ptr<Packet> packet_recv; ///< Partially received packet
+	std::atomic<size_t> pending_encryption = 0; ///< Number of packets at the end of packet_queue still waiting on the encryption thread.
 
 	void EmptyPacketQueue();
+	void WaitForPendingEncryption();
 public:
 	SOCKET sock;              ///< The socket currently connected to
 	bool writable;            ///< Can we write to this socket?
@@ -163,4 +165,7 @@ public:
 	void SetFailure();
 };
 
+void NetworkTCPEncryptionThreadInitialize();
+void NetworkTCPEncryptionThreadUninitialize();
+
 #endif /* NETWORK_CORE_TCP_H */
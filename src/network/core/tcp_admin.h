@@ -65,6 +65,8 @@ enum PacketAdminType : uint8_t {
 	ADMIN_PACKET_SERVER_CMD_LOGGING,     ///< The server gives the admin copies of incoming command packets.
 	ADMIN_PACKET_SERVER_AUTH_REQUEST,    ///< The server gives the admin the used authentication method and required parameters.
 	ADMIN_PACKET_SERVER_ENABLE_ENCRYPTION, ///< The server tells that authentication has completed and requests to enable encryption with the keys of the last \c ADMIN_PACKET_ADMIN_AUTH_RESPONSE.
+	ADMIN_PACKET_SERVER_PERFORMANCE,     ///< The server gives the admin its performance measurements.
+	ADMIN_PACKET_SERVER_CLIENT_LAG,      ///< The server gives the admin the frame lag of its clients.
 
 	INVALID_ADMIN_PACKET = 0xFF,         ///< An invalid marker for admin packets.
 };
@@ -77,6 +79,18 @@ enum AdminStatus {
 	ADMIN_STATUS_END,           ///< Must ALWAYS be on the end of this list!! (period)
 };
 
+/** Pools of which the number of items is sent in \c ADMIN_PACKET_SERVER_PERFORMANCE, in order. */
+enum AdminPerformancePool : uint8_t {
+	ADMIN_PERFORMANCE_POOL_VEHICLE,       ///< Vehicles.
+	ADMIN_PERFORMANCE_POOL_STATION,       ///< Stations and waypoints.
+	ADMIN_PERFORMANCE_POOL_TOWN,          ///< Towns.
+	ADMIN_PERFORMANCE_POOL_INDUSTRY,      ///< Industries.
+	ADMIN_PERFORMANCE_POOL_CARGO_PACKET,  ///< Cargo packets.
+	ADMIN_PERFORMANCE_POOL_ORDER,         ///< Orders.
+	ADMIN_PERFORMANCE_POOL_LINK_GRAPH,    ///< Link graphs.
+	ADMIN_PERFORMANCE_POOL_END,           ///< Must ALWAYS be on the end of this list!! (period)
+};
+
 /** Update types an admin can register a frequency for */
 enum AdminUpdateType {
 	ADMIN_UPDATE_DATE,            ///< Updates about the date of the game.
@@ -89,6 +103,7 @@ enum AdminUpdateType {
 	ADMIN_UPDATE_CMD_NAMES,       ///< The admin would like a list of all DoCommand names.
 	ADMIN_UPDATE_CMD_LOGGING,     ///< The admin would like to have DoCommand information.
 	ADMIN_UPDATE_GAMESCRIPT,      ///< The admin would like to have gamescript messages.
+	ADMIN_UPDATE_PERFORMANCE,     ///< The admin would like to have performance measurements and client lag.
 	ADMIN_UPDATE_END,             ///< Must ALWAYS be on the end of this list!! (period)
 };
 
@@ -538,6 +553,37 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_RCON_END(Packet &p);
 
+	/**
+	 * Send the performance measurements of the server:
+	 * uint32_t  Current frame counter.
+	 * These five fields are repeated for every performance element with measurements:
+	 * bool    Data to follow.
+	 * uint8_t   ID of the performance element (see #PerformanceElement).
+	 * uint32_t  Rate of the element in cycles per 1000 seconds.
+	 * uint32_t  Average duration of the last few cycles, in microseconds.
+	 * uint32_t  Average duration of the last 512 cycles, in microseconds.
+	 * bool    No more data.
+	 * uint8_t   Number of pools following (see #AdminPerformancePool).
+	 * uint32_t  Number of items in the pool, repeated for each pool.
+	 * uint16_t  Number of running link graph jobs.
+	 * int32_t   Days until the earliest join of a running link graph job that has not completed; negative when the game is waiting on it, INT32_MAX when there is none.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_PERFORMANCE(Packet &p);
+
+	/**
+	 * Send the frame lag of the clients. Multiple of these packets can follow
+	 * each other in order to provide the lag of all clients.
+	 * These three fields are repeated until the packet is full:
+	 * bool    Data to follow.
+	 * uint32_t  ID of the client.
+	 * uint32_t  Lag of the client, in frames.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_CLIENT_LAG(Packet &p);
+
 	NetworkRecvStatus HandlePacket(Packet &p);
 public:
 	NetworkRecvStatus CloseConnection(bool error = true) override;
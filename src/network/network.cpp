@@ -291,9 +291,10 @@ uint NetworkCalculateLag(const NetworkClientSocket *cs)
 	int lag = cs->last_frame_server - cs->last_frame;
 	/* This client has missed their ACK packet after 1 DAY_TICKS..
 	 *  so we increase their lag for every frame that passes!
-	 * The packet can be out by a max of _net_frame_freq */
-	if (cs->last_frame_server + Ticks::DAY_TICKS + _settings_client.network.frame_freq < _frame_counter) {
-		lag += _frame_counter - (cs->last_frame_server + Ticks::DAY_TICKS + _settings_client.network.frame_freq);
+	 * The packet can be out by a max of NetworkServerFrameFreq() */
+	uint frame_freq = NetworkServerFrameFreq();
+	if (cs->last_frame_server + Ticks::DAY_TICKS + frame_freq < _frame_counter) {
+		lag += _frame_counter - (cs->last_frame_server + Ticks::DAY_TICKS + frame_freq);
 	}
 	return lag;
 }
@@ -1245,7 +1246,7 @@ void NetworkGameLoop()
 		_frame_counter++;
 		/* Update max-frame-counter */
 		if (_frame_counter > _frame_counter_max) {
-			_frame_counter_max = _frame_counter + _settings_client.network.frame_freq;
+			_frame_counter_max = _frame_counter + NetworkServerFrameFreq();
 			send_frame = true;
 		}
 
@@ -1297,12 +1298,14 @@ void NetworkStartUp()
 	Debug(net, 3, "Network online, multiplayer available");
 	NetworkFindBroadcastIPs(&_broadcast_list);
 	NetworkHTTPInitialize();
+	if (_settings_client.network.threaded_encryption) NetworkTCPEncryptionThreadInitialize();
 }
 
 /** This shuts the network down */
 void NetworkShutDown()
 {
 	NetworkDisconnect();
+	NetworkTCPEncryptionThreadUninitialize();
 	NetworkHTTPUninitialize();
 	NetworkUDPClose();
 
@@ -22,6 +22,14 @@
 #include "../map_func.h"
 #include "../rev.h"
 #include "../game/game.hpp"
+#include "../framerate_type.h"
+#include "../cargopacket.h"
+#include "../industry.h"
+#include "../order_base.h"
+#include "../station_base.h"
+#include "../town.h"
+#include "../vehicle_base.h"
+#include "../linkgraph/linkgraphjob.h"
 
 #include "../safeguards.h"
 
@@ -57,6 +65,7 @@ static const AdminUpdateFrequency _admin_update_type_frequencies[] = {
 	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_CMD_NAMES
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CMD_LOGGING
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_GAMESCRIPT
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_PERFORMANCE
 };
 /** Sanity check. */
 static_assert(lengthof(_admin_update_type_frequencies) == ADMIN_UPDATE_END);
@@ -631,6 +640,78 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCmdLogging(ClientID clien
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/** Send the performance measurements, pool sizes and link graph status. */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendPerformance()
+{
+	auto p = std::make_unique<Packet>(this, ADMIN_PACKET_SERVER_PERFORMANCE);
+
+	p->Send_uint32(_frame_counter);
+
+	for (PerformanceElement e = PFE_FIRST; e < PFE_MAX; e++) {
+		double rate, short_term, long_term;
+		if (!GetPerformanceMeasurement(e, rate, short_term, long_term)) continue;
+
+		p->Send_bool  (true);
+		p->Send_uint8 (e);
+		p->Send_uint32(static_cast<uint32_t>(std::clamp(rate * 1000, 0.0, static_cast<double>(UINT32_MAX))));
+		p->Send_uint32(static_cast<uint32_t>(std::clamp(short_term * 1000, 0.0, static_cast<double>(UINT32_MAX))));
+		p->Send_uint32(static_cast<uint32_t>(std::clamp(long_term * 1000, 0.0, static_cast<double>(UINT32_MAX))));
+	}
+	p->Send_bool(false);
+
+	p->Send_uint8 (ADMIN_PERFORMANCE_POOL_END);
+	p->Send_uint32((uint32_t)Vehicle::GetNumItems());
+	p->Send_uint32((uint32_t)BaseStation::GetNumItems());
+	p->Send_uint32((uint32_t)Town::GetNumItems());
+	p->Send_uint32((uint32_t)Industry::GetNumItems());
+	p->Send_uint32((uint32_t)CargoPacket::GetNumItems());
+	p->Send_uint32((uint32_t)Order::GetNumItems());
+	p->Send_uint32((uint32_t)LinkGraph::GetNumItems());
+
+	/* How far away the game is from having to wait on a link graph job. */
+	int32_t join_days = INT32_MAX;
+	for (const LinkGraphJob *lgj : LinkGraphJob::Iterate()) {
+		if (lgj->IsJobCompleted()) continue;
+		join_days = std::min(join_days, (lgj->JoinDate() - TimerGameEconomy::date).base());
+	}
+	p->Send_uint16((uint16_t)LinkGraphJob::GetNumItems());
+	p->Send_uint32(join_days);
+
+	this->SendPacket(std::move(p));
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
+/** Send the frame lag of all clients. */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendClientLag()
+{
+	auto p = std::make_unique<Packet>(this, ADMIN_PACKET_SERVER_CLIENT_LAG);
+
+	for (const NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
+		if (cs->status < NetworkClientSocket::STATUS_PRE_ACTIVE) continue;
+
+		/* Should COMPAT_MTU be exceeded, start a new packet
+		 * (magic 10: 1 bool "more data", one uint32_t "client id",
+		 * one uint32_t "lag" and 1 bool "no more data" */
+		if (!p->CanWriteToPacket(10)) {
+			p->Send_bool(false);
+			this->SendPacket(std::move(p));
+
+			p = std::make_unique<Packet>(this, ADMIN_PACKET_SERVER_CLIENT_LAG);
+		}
+
+		p->Send_bool  (true);
+		p->Send_uint32(cs->client_id);
+		p->Send_uint32(NetworkCalculateLag(cs));
+	}
+
+	/* Marker to notify the end of the packet has been reached. */
+	p->Send_bool(false);
+	this->SendPacket(std::move(p));
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /***********
  * Receiving functions
  ************/
@@ -748,6 +829,12 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet &p)
 			this->SendCmdNames();
 			break;
 
+		case ADMIN_UPDATE_PERFORMANCE:
+			/* The admin is requesting the performance measurements. */
+			this->SendPerformance();
+			this->SendClientLag();
+			break;
+
 		default:
 			/* An unsupported "poll" update type. */
 			Debug(net, 1, "[admin] Not supported poll {} ({}) from '{}' ({}).", type, d1, this->admin_name, this->admin_version);
@@ -1058,6 +1145,22 @@ void NetworkAdminCmdLogging(const NetworkClientSocket *owner, const CommandPacke
 	}
 }
 
+/**
+ * Send the performance measurements and client lag to the admins that registered for them.
+ * This is called every tick; the measurements are sent every network.admin_performance_interval ticks.
+ */
+void NetworkAdminPerformance()
+{
+	if (_frame_counter % _settings_client.network.admin_performance_interval != 0) return;
+
+	for (ServerNetworkAdminSocketHandler *as : ServerNetworkAdminSocketHandler::IterateActive()) {
+		if (as->update_frequency[ADMIN_UPDATE_PERFORMANCE] & ADMIN_FREQUENCY_AUTOMATIC) {
+			as->SendPerformance();
+			as->SendClientLag();
+		}
+	}
+}
+
 /**
  * Send a Welcome packet to all connected admins
  */
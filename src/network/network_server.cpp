@@ -45,6 +45,7 @@
 DECLARE_POSTFIX_INCREMENT(ClientID)
 /** The identifier counter for new clients (is never decreased) */
 static ClientID _network_client_id = CLIENT_ID_FIRST;
+static uint _network_frame_lead = 0; ///< The largest frame lead of the active clients, as of the last server tick.
 
 /** Make very sure the preconditions given in network_type.h are actually followed */
 static_assert(MAX_CLIENT_SLOTS > MAX_CLIENTS);
@@ -578,7 +579,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 		this->last_frame_server = _frame_counter;
 
 		/* Make a dump of the current game */
-		if (SaveWithFilter(this->savegame, true) != SL_OK) UserError("network savedump failed");
+		if (SaveWithFilter(this->savegame, true, _settings_client.network.forked_map_save) != SL_OK) UserError("network savedump failed");
 	}
 
 	if (this->status == STATUS_MAP) {
@@ -1241,6 +1242,13 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_ACK(Packet &p)
 	this->last_frame = frame;
 	/* With those 2 values we can calculate the lag realtime */
 	this->last_frame_server = _frame_counter;
+
+	if (this->status == STATUS_ACTIVE && frame <= _frame_counter) {
+		/* The frames the client trails is roughly the round trip time, as the frame
+		 * had to get to the client and the ACK back. It does not depend on how far the
+		 * clients may run ahead, so the lead does not feed back into itself. */
+		this->frame_lead = UpdateNetworkFrameLead(this->frame_lead, _frame_counter - frame);
+	}
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
@@ -1695,6 +1703,13 @@ void NetworkServer_Tick(bool send_frame)
 	}
 #endif
 
+	/* Determine the lead of the active clients once per tick, as the lag of
+	 * every client, and every ACK, depends on it. */
+	_network_frame_lead = 0;
+	for (const NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
+		if (cs->status == NetworkClientSocket::STATUS_ACTIVE) _network_frame_lead = std::max(_network_frame_lead, GetNetworkFrameLeadFrames(cs->frame_lead));
+	}
+
 	/* Now we are done with the frame, inform the clients that they can
 	 *  do their frame! */
 	for (NetworkClientSocket *cs : NetworkClientSocket::Iterate()) {
@@ -1813,6 +1828,36 @@ void NetworkServer_Tick(bool send_frame)
 #endif
 		}
 	}
+
+	NetworkAdminPerformance();
+}
+
+/**
+ * Get the number of frames the clients may run ahead of the last frame the server has executed.
+ * This is the delay between accepting a command and executing it. With network.adaptive_frame_freq
+ * it is based on the measured lead the active clients need, otherwise it is network.frame_freq.
+ * @return The number of frames.
+ */
+uint NetworkServerFrameFreq()
+{
+	uint frame_freq = _settings_client.network.frame_freq;
+	if (!_settings_client.network.adaptive_frame_freq) return frame_freq;
+
+	return std::max<uint>(frame_freq, std::min<uint>(_network_frame_lead, _settings_client.network.max_frame_freq));
+}
+
+/**
+ * Add a measurement of the lag of a client to its smoothed frame lead. Half of the
+ * round trip has to be hidden by running ahead, so the client does not stall while
+ * waiting for the next frame. The lead is kept in fractions of a frame, so rounding
+ * does not keep it above what the client needs.
+ * @param frame_lead The smoothed frame lead so far, in 1/#NETWORK_FRAME_LEAD_SCALE frames.
+ * @param trail The number of frames the client trails the server, as acknowledged by the client.
+ * @return The new smoothed frame lead, in 1/#NETWORK_FRAME_LEAD_SCALE frames.
+ */
+uint UpdateNetworkFrameLead(uint frame_lead, uint trail)
+{
+	return (frame_lead * 3 + trail * NETWORK_FRAME_LEAD_SCALE / 2 + 2) / 4;
 }
 
 /** Helper function to restart the map. */
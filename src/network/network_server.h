@@ -67,6 +67,7 @@ public:
 	uint8_t lag_test;               ///< Byte used for lag-testing the client
 	uint8_t last_token;             ///< The last random token we did send to verify the client is listening
 	uint32_t last_token_frame;     ///< The last frame we received the right token
+	uint frame_lead = 0;         ///< Smoothed number of frames the client has to run ahead of the server to hide its latency, in 1/#NETWORK_FRAME_LEAD_SCALE frames
 	ClientStatus status;         ///< Status of this client
 	CommandQueue outgoing_queue; ///< The command-queue awaiting delivery; conceptually more a bucket to gather commands in, after which the whole bucket is sent to the client.
 	size_t receive_limit;        ///< Amount of bytes that we can receive at this moment
@@ -121,7 +122,21 @@ public:
 	static ServerNetworkGameSocketHandler *GetByClientID(ClientID client_id);
 };
 
+static const uint NETWORK_FRAME_LEAD_SCALE = 16; ///< Fractions of a frame the smoothed frame lead of a client is kept in.
+
 void NetworkServer_Tick(bool send_frame);
+uint NetworkServerFrameFreq();
+uint UpdateNetworkFrameLead(uint frame_lead, uint trail);
+
+/**
+ * Get the number of frames of a smoothed frame lead, rounded to the nearest frame.
+ * @param frame_lead The smoothed frame lead, in 1/#NETWORK_FRAME_LEAD_SCALE frames.
+ * @return The number of frames.
+ */
+inline uint GetNetworkFrameLeadFrames(uint frame_lead)
+{
+	return (frame_lead + NETWORK_FRAME_LEAD_SCALE / 2) / NETWORK_FRAME_LEAD_SCALE;
+}
 void ChangeNetworkRestartTime(bool reset);
 
 #endif /* NETWORK_SERVER_H */
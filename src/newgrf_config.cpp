@@ -26,6 +26,7 @@
 
 #include "fileio_func.h"
 #include "fios.h"
+#include "md5sum_cache.h"
 
 #include "safeguards.h"
 
@@ -284,40 +285,57 @@ size_t GRFGetSizeOfDataSection(FileHandle &f)
  */
 static bool CalcGRFMD5Sum(GRFConfig *config, Subdirectory subdir)
 {
-	Md5 checksum;
-	uint8_t buffer[1024];
-	size_t len, size;
+	return GetCachedMD5Sum(config->filename, subdir, config->ident.md5sum, [&config, subdir](MD5Hash &md5sum) {
+		Md5 checksum;
+		uint8_t buffer[1024];
+		size_t len, size;
 
-	/* open the file */
-	auto f = FioFOpenFile(config->filename, "rb", subdir, &size);
-	if (!f.has_value()) return false;
+		/* open the file */
+		auto f = FioFOpenFile(config->filename, "rb", subdir, &size);
+		if (!f.has_value()) return false;
 
-	long start = ftell(*f);
-	size = std::min(size, GRFGetSizeOfDataSection(*f));
+		long start = ftell(*f);
+		size = std::min(size, GRFGetSizeOfDataSection(*f));
 
-	if (start < 0 || fseek(*f, start, SEEK_SET) < 0) {
-		return false;
-	}
+		if (start < 0 || fseek(*f, start, SEEK_SET) < 0) {
+			return false;
+		}
 
-	/* calculate md5sum */
-	while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, *f)) != 0 && size != 0) {
-		size -= len;
-		checksum.Append(buffer, len);
-	}
-	checksum.Finish(config->ident.md5sum);
+		/* calculate md5sum */
+		while ((len = fread(buffer, 1, (size > sizeof(buffer)) ? sizeof(buffer) : size, *f)) != 0 && size != 0) {
+			size -= len;
+			checksum.Append(buffer, len);
+		}
+		checksum.Finish(md5sum);
 
-	return true;
+		return true;
+	});
 }
 
+/**
+ * Calculate the MD5 sums of a number of GRFs, spread over multiple threads.
+ * @param configs The GRFs to compute.
+ * @param subdir The subdirectory to look in.
+ * @return For each of the GRFs whether its MD5 sum was successfully computed.
+ */
+static std::vector<bool> CalcGRFMD5Sums(const std::vector<GRFConfig *> &configs, Subdirectory subdir)
+{
+	std::vector<uint8_t> results(configs.size(), false);
+	RunInParallel("ottd:md5sum", configs.size(), [&configs, &results, subdir](size_t i) {
+		results[i] = CalcGRFMD5Sum(configs[i], subdir);
+	});
+
+	return std::vector<bool>(results.begin(), results.end());
+}
 
 /**
- * Find the GRFID of a given grf, and calculate its md5sum.
+ * Find the GRFID of a given grf and load its details, but do not calculate its md5sum.
  * @param config    grf to fill.
  * @param is_static grf is static.
  * @param subdir    the subdirectory to search in.
  * @return Operation was successfully completed.
  */
-bool FillGRFDetails(GRFConfig *config, bool is_static, Subdirectory subdir)
+static bool LoadGRFDetails(GRFConfig *config, bool is_static, Subdirectory subdir)
 {
 	if (!FioCheckFileExists(config->filename, subdir)) {
 		config->status = GCS_NOT_FOUND;
@@ -340,7 +358,20 @@ bool FillGRFDetails(GRFConfig *config, bool is_static, Subdirectory subdir)
 		if (HasBit(config->flags, GCF_UNSAFE)) return false;
 	}
 
-	return CalcGRFMD5Sum(config, subdir);
+	return true;
+}
+
+
+/**
+ * Find the GRFID of a given grf, and calculate its md5sum.
+ * @param config    grf to fill.
+ * @param is_static grf is static.
+ * @param subdir    the subdirectory to search in.
+ * @return Operation was successfully completed.
+ */
+bool FillGRFDetails(GRFConfig *config, bool is_static, Subdirectory subdir)
+{
+	return LoadGRFDetails(config, is_static, subdir) && CalcGRFMD5Sum(config, subdir);
 }
 
 
@@ -524,9 +555,14 @@ int _skip_all_newgrf_scanning = 0;
 class GRFFileScanner : FileScanner {
 	std::chrono::steady_clock::time_point next_update; ///< The next moment we do update the screen.
 	uint num_scanned; ///< The number of GRFs we have scanned.
+	uint num_added; ///< The number of GRFs we have added to the list of all GRFs.
+	std::vector<GRFConfig *> pending; ///< The GRFs that are scanned, but of which the MD5 sum is not calculated yet.
+
+	bool AddGRF(GRFConfig *c);
+	uint AddPendingGRFs();
 
 public:
-	GRFFileScanner() : num_scanned(0)
+	GRFFileScanner() : num_scanned(0), num_added(0)
 	{
 		this->next_update = std::chrono::steady_clock::now();
 	}
@@ -542,7 +578,8 @@ public:
 		}
 
 		GRFFileScanner fs;
-		int ret = fs.Scan(".grf", NEWGRF_DIR);
+		fs.Scan(".grf", NEWGRF_DIR);
+		uint ret = fs.num_added + fs.AddPendingGRFs();
 		/* The number scanned and the number returned may not be the same;
 		 * duplicate NewGRFs and base sets are ignored in the return value. */
 		_settings_client.gui.last_newgrf_count = fs.num_scanned;
@@ -557,34 +594,8 @@ bool GRFFileScanner::AddFile(const std::string &filename, size_t basepath_length
 
 	GRFConfig *c = new GRFConfig(filename.c_str() + basepath_length);
 
-	bool added = true;
-	if (FillGRFDetails(c, false)) {
-		if (_all_grfs == nullptr) {
-			_all_grfs = c;
-		} else {
-			/* Insert file into list at a position determined by its
-			 * name, so the list is sorted as we go along */
-			GRFConfig **pd, *d;
-			bool stop = false;
-			for (pd = &_all_grfs; (d = *pd) != nullptr; pd = &d->next) {
-				if (c->ident.grfid == d->ident.grfid && c->ident.md5sum == d->ident.md5sum) added = false;
-				/* Because there can be multiple grfs with the same name, make sure we checked all grfs with the same name,
-				 *  before inserting the entry. So insert a new grf at the end of all grfs with the same name, instead of
-				 *  just after the first with the same name. Avoids doubles in the list. */
-				if (StrCompareIgnoreCase(c->GetName(), d->GetName()) <= 0) {
-					stop = true;
-				} else if (stop) {
-					break;
-				}
-			}
-			if (added) {
-				c->next = d;
-				*pd = c;
-			}
-		}
-	} else {
-		added = false;
-	}
+	/* The MD5 sum is calculated later on for a batch of GRFs at once, see AddPendingGRFs. */
+	bool loaded = LoadGRFDetails(c, false, NEWGRF_DIR);
 
 	this->num_scanned++;
 
@@ -594,11 +605,74 @@ bool GRFFileScanner::AddFile(const std::string &filename, size_t basepath_length
 	UpdateNewGRFScanStatus(this->num_scanned, name);
 	VideoDriver::GetInstance()->GameLoopPause();
 
-	if (!added) {
+	if (!loaded) {
 		/* File couldn't be opened, or is either not a NewGRF or is a
-		 * 'system' NewGRF or it's already known, so forget about it. */
+		 * 'system' NewGRF, so forget about it. */
 		delete c;
+		return false;
+	}
+
+	this->pending.push_back(c);
+
+	/* Calculate the MD5 sums of a batch at a time, so the progress keeps being shown while hashing. */
+	if (this->pending.size() >= std::max(1U, std::thread::hardware_concurrency()) * 4) this->num_added += this->AddPendingGRFs();
+	return true;
+}
+
+/**
+ * Add a GRF of which all details are known to the list of all GRFs.
+ * @param c The GRF to add.
+ * @return True iff the GRF got added, i.e. it was not already known.
+ */
+bool GRFFileScanner::AddGRF(GRFConfig *c)
+{
+	if (_all_grfs == nullptr) {
+		_all_grfs = c;
+		return true;
+	}
+
+	/* Insert file into list at a position determined by its
+	 * name, so the list is sorted as we go along */
+	GRFConfig **pd, *d;
+	bool stop = false;
+	for (pd = &_all_grfs; (d = *pd) != nullptr; pd = &d->next) {
+		if (c->ident.grfid == d->ident.grfid && c->ident.md5sum == d->ident.md5sum) return false;
+		/* Because there can be multiple grfs with the same name, make sure we checked all grfs with the same name,
+		 *  before inserting the entry. So insert a new grf at the end of all grfs with the same name, instead of
+		 *  just after the first with the same name. Avoids doubles in the list. */
+		if (StrCompareIgnoreCase(c->GetName(), d->GetName()) <= 0) {
+			stop = true;
+		} else if (stop) {
+			break;
+		}
+	}
+
+	c->next = d;
+	*pd = c;
+	return true;
+}
+
+/**
+ * Calculate the MD5 sums of the pending GRFs in parallel, and then add them
+ * to the list of all GRFs in the order they were scanned.
+ * @return The number of GRFs that got added.
+ */
+uint GRFFileScanner::AddPendingGRFs()
+{
+	std::vector<bool> results;
+	if (!_exit_game) results = CalcGRFMD5Sums(this->pending, NEWGRF_DIR);
+
+	uint added = 0;
+	for (size_t i = 0; i < this->pending.size(); i++) {
+		GRFConfig *c = this->pending[i];
+		if (i < results.size() && results[i] && AddGRF(c)) {
+			added++;
+		} else {
+			/* File couldn't be read or it's already known, so forget about it. */
+			delete c;
+		}
 	}
+	this->pending.clear();
 
 	return added;
 }
@@ -625,6 +699,7 @@ void DoScanNewGRFFiles(NewGRFScanCallback *callback)
 
 	Debug(grf, 1, "Scanning for NewGRFs");
 	uint num = GRFFileScanner::DoScan();
+	SaveMD5SumCache();
 
 	Debug(grf, 1, "Scan complete, found {} files", num);
 	if (num != 0 && _all_grfs != nullptr) {
@@ -707,6 +707,7 @@ static void DoTriggerHouse(TileIndex tile, HouseTrigger trigger, uint8_t base_ra
 	random_bits &= ~reseed;
 	random_bits |= (first ? new_random_bits : base_random) & reseed;
 	SetHouseRandomBits(tile, random_bits);
+	InvalidateTileDrawCache(tile);
 
 	switch (trigger) {
 		case HOUSE_TRIGGER_TILE_LOOP:
@@ -349,6 +349,10 @@ static void DoReseedIndustry(Industry *ind, uint32_t reseed)
 	uint16_t random_bits = Random();
 	ind->random &= reseed;
 	ind->random |= random_bits & reseed;
+
+	for (TileIndex tile : ind->location) {
+		if (ind->TileBelongsToIndustry(tile)) InvalidateTileDrawCache(tile);
+	}
 }
 
 /**
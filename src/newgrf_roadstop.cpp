@@ -12,6 +12,7 @@
 #include "station_base.h"
 #include "roadstop_base.h"
 #include "newgrf_roadstop.h"
+#include "newgrf_station.h"
 #include "newgrf_class_func.h"
 #include "newgrf_cargo.h"
 #include "newgrf_roadtype.h"
@@ -469,6 +470,7 @@ void TriggerRoadStopRandomisation(Station *st, TileIndex tile, RoadStopRandomTri
 	if ((whole_reseed & 0xFFFF) != 0) {
 		st->random_bits &= ~whole_reseed;
 		st->random_bits |= Random() & whole_reseed;
+		InvalidateStationTileDrawCache(st);
 	}
 }
 
@@ -909,6 +909,19 @@ void TriggerStationAnimation(BaseStation *st, TileIndex trigger_tile, StationAni
 	}
 }
 
+/**
+ * Forget the sprites of the tiles of a station in the tile draw cache, e.g. as the random bits of the whole station changed.
+ * @param st The station.
+ */
+void InvalidateStationTileDrawCache(const BaseStation *st)
+{
+	if (st->rect.IsEmpty()) return;
+
+	for (TileIndex tile : TileArea(TileXY(st->rect.left, st->rect.top), TileXY(st->rect.right, st->rect.bottom))) {
+		if (IsTileType(tile, MP_STATION) && GetStationIndex(tile) == st->index) InvalidateTileDrawCache(tile);
+	}
+}
+
 /**
  * Trigger station randomisation
  * @param st station being triggered
@@ -984,6 +997,7 @@ void TriggerStationRandomisation(Station *st, TileIndex trigger_tile, StationRan
 	if ((whole_reseed & 0xFFFF) != 0) {
 		st->random_bits &= ~whole_reseed;
 		st->random_bits |= Random() & whole_reseed;
+		InvalidateStationTileDrawCache(st);
 	}
 }
 
@@ -76,6 +76,7 @@
 #include "timer/timer_game_realtime.h"
 #include "timer/timer_game_tick.h"
 #include "social_integration.h"
+#include "sprite_disk_cache.h"
 
 #include "linkgraph/linkgraphschedule.h"
 
@@ -305,6 +306,9 @@ static void ShutdownGame()
 	/* No NewGRFs were loaded when it was still bootstrapping. */
 	if (_game_mode != GM_BOOTSTRAP) ResetNewGRFData();
 
+	/* Keep the sprites encoded during this session for the next one. */
+	SaveSpriteDiskCache();
+
 	UninitFontCache();
 }
 
@@ -1372,8 +1376,6 @@ void GameLoop()
 		if (_exit_game) return;
 	}
 
-	IncreaseSpriteLRU();
-
 	/* Check for UDP stuff */
 	if (_network_available) NetworkBackgroundLoop();
 
@@ -139,6 +139,8 @@ SaveLoadTable GetCargoPacketDesc()
 struct CAPAChunkHandler : ChunkHandler {
 	CAPAChunkHandler() : ChunkHandler('CAPA', CH_TABLE) {}
 
+	bool CanSaveInParallel() const override { return true; }
+
 	void Save() const override
 	{
 		SlTableHeader(GetCargoPacketDesc());
@@ -15,6 +15,7 @@
 #include "../map_func.h"
 #include "../core/bitmath_func.hpp"
 #include "../fios.h"
+#include "../thread.h"
 
 #include "../safeguards.h"
 
@@ -26,9 +27,35 @@ static const SaveLoad _map_desc[] = {
 	SLEG_CONDVAR("dim_y", _map_dim_y, SLE_UINT32, SLV_6, SL_MAX_VERSION),
 };
 
+/**
+ * Planes of the map that have been loaded, but not yet copied into the tiles.
+ * The planes are different bytes of the same tiles, so when they are loaded in
+ * parallel, writing them directly into the tiles would make the threads write to
+ * the same cache lines all the time. Instead every plane is loaded into its own
+ * buffer, and once all of them are loaded the buffers are copied into the tiles
+ * with each thread copying all planes of a range of tiles.
+ */
+struct LoadedMapPlanes {
+	std::vector<uint8_t> type;   ///< Plane of MAPT.
+	std::vector<uint8_t> height; ///< Plane of MAPH.
+	std::vector<uint8_t> m1;     ///< Plane of MAPO.
+	std::vector<uint16_t> m2;    ///< Plane of MAP2.
+	std::vector<uint8_t> m3;     ///< Plane of M3LO.
+	std::vector<uint8_t> m4;     ///< Plane of M3HI.
+	std::vector<uint8_t> m5;     ///< Plane of MAP5.
+	std::vector<uint8_t> m6;     ///< Plane of MAPE.
+	std::vector<uint8_t> m7;     ///< Plane of MAP7.
+	std::vector<uint16_t> m8;    ///< Plane of MAP8.
+	bool pending = false;        ///< Whether any plane has been loaded since they were last copied.
+};
+
+static LoadedMapPlanes _loaded_map_planes;
+
 struct MAPSChunkHandler : ChunkHandler {
 	MAPSChunkHandler() : ChunkHandler('MAPS', CH_TABLE) {}
 
+	bool CanSaveInParallel() const override { return true; }
+
 	void Save() const override
 	{
 		SlTableHeader(_map_desc);
@@ -49,6 +76,8 @@ struct MAPSChunkHandler : ChunkHandler {
 		if (!IsSavegameVersionBefore(SLV_RIFF_TO_ARRAY) && SlIterateArray() != -1) SlErrorCorrupt("Too many MAPS entries");
 
 		Map::Allocate(_map_dim_x, _map_dim_y);
+		/* Drop the planes of a load that failed before they were copied. */
+		_loaded_map_planes = {};
 	}
 
 	void LoadCheck(size_t) const override
@@ -66,55 +95,267 @@ struct MAPSChunkHandler : ChunkHandler {
 
 static const uint MAP_SL_BUF_SIZE = 4096;
 
+static const uint MAP_SL_RLE_MAX_LITERAL = 128; ///< Maximum number of literal bytes after a single control byte.
+static const uint MAP_SL_RLE_MIN_RUN = 3;       ///< Minimum length of a run; shorter runs are stored as literals.
+static const uint MAP_SL_RLE_MAX_RUN = MAP_SL_RLE_MIN_RUN + 127; ///< Maximum length of a run after a single control byte.
+
+/**
+ * Save a byte plane of the map run-length encoded. Most planes that are saved this way
+ * have long runs of the same value, e.g. the tile type and owner, or are mostly zero.
+ * The encoded plane consists of control bytes; a control byte below 128 is followed by
+ * control + 1 literal bytes, otherwise the byte following it is repeated control - 125 times.
+ * @param get Function returning the value of the plane for a tile.
+ */
+template <typename F>
+static void SaveMapPlaneRLE(F get)
+{
+	uint size = Map::Size();
+	std::vector<uint8_t> buf;
+	buf.reserve(size / 4);
+
+	size_t literal = SIZE_MAX; // Position of the control byte of the current literal sequence, if any.
+	for (uint i = 0; i != size;) {
+		uint8_t value = get(i);
+		uint run = 1;
+		while (run < MAP_SL_RLE_MAX_RUN && i + run != size && get(i + run) == value) run++;
+
+		if (run >= MAP_SL_RLE_MIN_RUN) {
+			buf.push_back(static_cast<uint8_t>(128 + run - MAP_SL_RLE_MIN_RUN));
+			buf.push_back(value);
+			literal = SIZE_MAX;
+			i += run;
+			continue;
+		}
+
+		if (literal == SIZE_MAX || buf[literal] == MAP_SL_RLE_MAX_LITERAL - 1) {
+			literal = buf.size();
+			buf.push_back(0);
+		} else {
+			buf[literal]++;
+		}
+		buf.push_back(value);
+		i++;
+	}
+
+	SlSetLength(buf.size());
+	SlCopy(buf.data(), buf.size(), SLE_UINT8);
+}
+
+/**
+ * Load a run-length encoded byte plane of the map.
+ * @param set Function setting the value of the plane for a tile.
+ * @see SaveMapPlaneRLE for the encoding.
+ */
+template <typename F>
+static void LoadMapPlaneRLE(F set)
+{
+	std::array<uint8_t, MAP_SL_RLE_MAX_LITERAL> buf;
+	uint size = Map::Size();
+	size_t length = SlGetFieldLength();
+
+	for (uint i = 0; i != size;) {
+		if (length < 2) SlErrorCorrupt("Map plane is too short");
+		uint8_t control = SlReadByte();
+		length--;
+
+		if (control < 128) {
+			uint count = control + 1;
+			if (count > length || count > size - i) SlErrorCorrupt("Invalid literal sequence in map plane");
+
+			SlCopy(buf.data(), count, SLE_UINT8);
+			length -= count;
+			for (uint j = 0; j != count; j++) set(i++, buf[j]);
+		} else {
+			uint count = control - 128 + MAP_SL_RLE_MIN_RUN;
+			if (count > size - i) SlErrorCorrupt("Invalid run in map plane");
+
+			uint8_t value = SlReadByte();
+			length--;
+			for (uint j = 0; j != count; j++) set(i++, value);
+		}
+	}
+
+	if (length != 0) SlErrorCorrupt("Map plane is too long");
+}
+
+/** Value stored in front of the tile-arrays of raw snapshots, to detect snapshots of a different byte order. */
+static const uint32_t MAP_SL_RAW_MAGIC = 0x01020304;
+
+/**
+ * Save a tile-array as it is in memory, for raw snapshots.
+ * @param memory The memory of the tile-array.
+ */
+static void SaveRawTileArray(std::span<uint8_t> memory)
+{
+	uint32_t magic = MAP_SL_RAW_MAGIC;
+
+	SlSetLength(sizeof(magic) + memory.size());
+	SlCopy(&magic, sizeof(magic), SLE_UINT8);
+	SlCopy(memory.data(), memory.size(), SLE_UINT8);
+}
+
+/**
+ * Load a tile-array of a raw snapshot directly into memory.
+ * @param memory The memory of the tile-array.
+ */
+static void LoadRawTileArray(std::span<uint8_t> memory)
+{
+	uint32_t magic;
+
+	if (SlGetFieldLength() != sizeof(magic) + memory.size()) SlErrorCorrupt("Raw tile-array has the wrong size");
+	SlCopy(&magic, sizeof(magic), SLE_UINT8);
+	if (magic != MAP_SL_RAW_MAGIC) SlErrorCorrupt("Raw snapshot was saved with a different byte order");
+	SlCopy(memory.data(), memory.size(), SLE_UINT8);
+}
+
+/**
+ * Prepare the buffer to load a plane of the map into.
+ * @param plane The plane in #_loaded_map_planes.
+ * @return The plane, with space for every tile of the map.
+ */
+template <typename T>
+static std::vector<T> &PrepareMapPlane(std::vector<T> &plane)
+{
+	_loaded_map_planes.pending = true;
+	plane.resize(Map::Size());
+	return plane;
+}
+
+/**
+ * Copy a range of a loaded plane into the tiles.
+ * @param plane The loaded plane; nothing is done when it was not loaded.
+ * @param begin The first tile to copy.
+ * @param end The tile after the last tile to copy.
+ * @param set Function setting the value of the plane for a tile.
+ */
+template <typename T, typename F>
+static void CopyLoadedMapPlane(const std::vector<T> &plane, uint begin, uint end, F set)
+{
+	if (plane.empty()) return;
+
+	assert(plane.size() == Map::Size());
+	for (uint t = begin; t != end; t++) set(t, plane[t]);
+}
+
+/**
+ * Copy the planes of the map that have been loaded into the tiles, and free them.
+ * The map planes are loaded in parallel, so this is called after each of them; only
+ * the first call after they have been loaded does the work.
+ */
+static void CopyLoadedMapPlanes()
+{
+	const LoadedMapPlanes &p = _loaded_map_planes;
+	if (!p.pending) return;
+
+	uint size = Map::Size();
+
+	RunInParallel("ottd:slmap", CeilDiv(size, MAP_SL_BUF_SIZE), [&p, size](size_t block) {
+		uint begin = static_cast<uint>(block) * MAP_SL_BUF_SIZE;
+		uint end = std::min(begin + MAP_SL_BUF_SIZE, size);
+
+		CopyLoadedMapPlane(p.type, begin, end, [](uint t, uint8_t v) { Tile(t).type() = v; });
+		CopyLoadedMapPlane(p.height, begin, end, [](uint t, uint8_t v) { Tile(t).height() = v; });
+		CopyLoadedMapPlane(p.m1, begin, end, [](uint t, uint8_t v) { Tile(t).m1() = v; });
+		CopyLoadedMapPlane(p.m2, begin, end, [](uint t, uint16_t v) { Tile(t).m2() = v; });
+		CopyLoadedMapPlane(p.m3, begin, end, [](uint t, uint8_t v) { Tile(t).m3() = v; });
+		CopyLoadedMapPlane(p.m4, begin, end, [](uint t, uint8_t v) { Tile(t).m4() = v; });
+		CopyLoadedMapPlane(p.m5, begin, end, [](uint t, uint8_t v) { Tile(t).m5() = v; });
+		CopyLoadedMapPlane(p.m6, begin, end, [](uint t, uint8_t v) { Tile(t).m6() = v; });
+		CopyLoadedMapPlane(p.m7, begin, end, [](uint t, uint8_t v) { Tile(t).m7() = v; });
+		CopyLoadedMapPlane(p.m8, begin, end, [](uint t, uint16_t v) { Tile(t).m8() = v; });
+	});
+
+	_loaded_map_planes = {};
+}
+
 struct MAPTChunkHandler : ChunkHandler {
 	MAPTChunkHandler() : ChunkHandler('MAPT', CH_RIFF) {}
 
+	bool CanSaveInParallel() const override { return true; }
+	bool CanLoadInParallel() const override { return true; }
+	void FinishParallelLoad() const override { CopyLoadedMapPlanes(); }
+
 	void Load() const override
 	{
+		if (SlIsRawSnapshot()) {
+			LoadRawTileArray(Map::GetBaseTileMemory());
+			return;
+		}
+
+		std::vector<uint8_t> &plane = PrepareMapPlane(_loaded_map_planes.type);
+
+		if (!IsSavegameVersionBefore(SLV_MAP_PLANE_FILTERS)) {
+			LoadMapPlaneRLE([&plane](uint t, uint8_t v) { plane[t] = v; });
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
-		for (TileIndex i = 0; i != size;) {
+		for (uint i = 0; i != size;) {
 			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) Tile(i++).type() = buf[j];
+			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) plane[i++] = buf[j];
 		}
 	}
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).type();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
+		if (SlIsRawSnapshot()) {
+			SaveRawTileArray(Map::GetBaseTileMemory());
+			return;
 		}
+
+		SaveMapPlaneRLE([](uint t) { return Tile(t).type(); });
 	}
 };
 
 struct MAPHChunkHandler : ChunkHandler {
 	MAPHChunkHandler() : ChunkHandler('MAPH', CH_RIFF) {}
 
+	bool CanSaveInParallel() const override { return true; }
+	bool CanLoadInParallel() const override { return true; }
+	void FinishParallelLoad() const override { CopyLoadedMapPlanes(); }
+
 	void Load() const override
 	{
+		/* Raw snapshots store this plane in MAPT. */
+		if (SlIsRawSnapshot()) return;
+
+		std::vector<uint8_t> &plane = PrepareMapPlane(_loaded_map_planes.height);
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
-		for (TileIndex i = 0; i != size;) {
+		/* Since SLV_MAP_PLANE_FILTERS the difference with the height of the previous tile is stored. */
+		bool delta = !IsSavegameVersionBefore(SLV_MAP_PLANE_FILTERS);
+		uint8_t height = 0;
+
+		for (uint i = 0; i != size;) {
 			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) Tile(i++).height() = buf[j];
+			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) {
+				height = delta ? static_cast<uint8_t>(height + buf[j]) : buf[j];
+				plane[i++] = height;
+			}
 		}
 	}
 
 	void Save() const override
 	{
+		if (SlIsRawSnapshot()) {
+			SlSetLength(0);
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
+		uint8_t height = 0;
 
 		SlSetLength(size);
 		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).height();
+			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) {
+				uint8_t next = Tile(i++).height();
+				buf[j] = static_cast<uint8_t>(next - height);
+				height = next;
+			}
 			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
 		}
 	}
@@ -123,49 +364,74 @@ struct MAPHChunkHandler : ChunkHandler {
 struct MAPOChunkHandler : ChunkHandler {
 	MAPOChunkHandler() : ChunkHandler('MAPO', CH_RIFF) {}
 
+	bool CanSaveInParallel() const override { return true; }
+	bool CanLoadInParallel() const override { return true; }
+	void FinishParallelLoad() const override { CopyLoadedMapPlanes(); }
+
 	void Load() const override
 	{
+		/* Raw snapshots store this plane in MAPT. */
+		if (SlIsRawSnapshot()) return;
+
+		std::vector<uint8_t> &plane = PrepareMapPlane(_loaded_map_planes.m1);
+
+		if (!IsSavegameVersionBefore(SLV_MAP_PLANE_FILTERS)) {
+			LoadMapPlaneRLE([&plane](uint t, uint8_t v) { plane[t] = v; });
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
-		for (TileIndex i = 0; i != size;) {
+		for (uint i = 0; i != size;) {
 			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) Tile(i++).m1() = buf[j];
+			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) plane[i++] = buf[j];
 		}
 	}
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).m1();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
+		if (SlIsRawSnapshot()) {
+			SlSetLength(0);
+			return;
 		}
+
+		SaveMapPlaneRLE([](uint t) { return Tile(t).m1(); });
 	}
 };
 
 struct MAP2ChunkHandler : ChunkHandler {
 	MAP2ChunkHandler() : ChunkHandler('MAP2', CH_RIFF) {}
 
+	bool CanSaveInParallel() const override { return true; }
+	bool CanLoadInParallel() const override { return true; }
+	void FinishParallelLoad() const override { CopyLoadedMapPlanes(); }
+
 	void Load() const override
 	{
+		/* Raw snapshots store this plane in MAPT. */
+		if (SlIsRawSnapshot()) return;
+
+		std::vector<uint16_t> &plane = PrepareMapPlane(_loaded_map_planes.m2);
 		std::array<uint16_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
-		for (TileIndex i = 0; i != size;) {
+		for (uint i = 0; i != size;) {
 			SlCopy(buf.data(), MAP_SL_BUF_SIZE,
 				/* In those versions the m2 was 8 bits */
 				IsSavegameVersionBefore(SLV_5) ? SLE_FILE_U8 | SLE_VAR_U16 : SLE_UINT16
 			);
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) Tile(i++).m2() = buf[j];
+			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) plane[i++] = buf[j];
 		}
 	}
 
 	void Save() const override
 	{
+		if (SlIsRawSnapshot()) {
+			SlSetLength(0);
+			return;
+		}
+
 		std::array<uint16_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -180,19 +446,32 @@ struct MAP2ChunkHandler : ChunkHandler {
 struct M3LOChunkHandler : ChunkHandler {
 	M3LOChunkHandler() : ChunkHandler('M3LO', CH_RIFF) {}
 
+	bool CanSaveInParallel() const override { return true; }
+	bool CanLoadInParallel() const override { return true; }
+	void FinishParallelLoad() const override { CopyLoadedMapPlanes(); }
+
 	void Load() const override
 	{
+		/* Raw snapshots store this plane in MAPT. */
+		if (SlIsRawSnapshot()) return;
+
+		std::vector<uint8_t> &plane = PrepareMapPlane(_loaded_map_planes.m3);
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
-		for (TileIndex i = 0; i != size;) {
+		for (uint i = 0; i != size;) {
 			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) Tile(i++).m3() = buf[j];
+			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) plane[i++] = buf[j];
 		}
 	}
 
 	void Save() const override
 	{
+		if (SlIsRawSnapshot()) {
+			SlSetLength(0);
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -207,19 +486,32 @@ struct M3LOChunkHandler : ChunkHandler {
 struct M3HIChunkHandler : ChunkHandler {
 	M3HIChunkHandler() : ChunkHandler('M3HI', CH_RIFF) {}
 
+	bool CanSaveInParallel() const override { return true; }
+	bool CanLoadInParallel() const override { return true; }
+	void FinishParallelLoad() const override { CopyLoadedMapPlanes(); }
+
 	void Load() const override
 	{
+		/* Raw snapshots store this plane in MAPT. */
+		if (SlIsRawSnapshot()) return;
+
+		std::vector<uint8_t> &plane = PrepareMapPlane(_loaded_map_planes.m4);
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
-		for (TileIndex i = 0; i != size;) {
+		for (uint i = 0; i != size;) {
 			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) Tile(i++).m4() = buf[j];
+			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) plane[i++] = buf[j];
 		}
 	}
 
 	void Save() const override
 	{
+		if (SlIsRawSnapshot()) {
+			SlSetLength(0);
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -234,19 +526,32 @@ struct M3HIChunkHandler : ChunkHandler {
 struct MAP5ChunkHandler : ChunkHandler {
 	MAP5ChunkHandler() : ChunkHandler('MAP5', CH_RIFF) {}
 
+	bool CanSaveInParallel() const override { return true; }
+	bool CanLoadInParallel() const override { return true; }
+	void FinishParallelLoad() const override { CopyLoadedMapPlanes(); }
+
 	void Load() const override
 	{
+		/* Raw snapshots store this plane in MAPT. */
+		if (SlIsRawSnapshot()) return;
+
+		std::vector<uint8_t> &plane = PrepareMapPlane(_loaded_map_planes.m5);
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
-		for (TileIndex i = 0; i != size;) {
+		for (uint i = 0; i != size;) {
 			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) Tile(i++).m5() = buf[j];
+			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) plane[i++] = buf[j];
 		}
 	}
 
 	void Save() const override
 	{
+		if (SlIsRawSnapshot()) {
+			SlSetLength(0);
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
@@ -261,86 +566,121 @@ struct MAP5ChunkHandler : ChunkHandler {
 struct MAPEChunkHandler : ChunkHandler {
 	MAPEChunkHandler() : ChunkHandler('MAPE', CH_RIFF) {}
 
+	bool CanSaveInParallel() const override { return true; }
+	bool CanLoadInParallel() const override { return true; }
+	void FinishParallelLoad() const override { CopyLoadedMapPlanes(); }
+
 	void Load() const override
 	{
+		if (SlIsRawSnapshot()) {
+			LoadRawTileArray(Map::GetExtendedTileMemory());
+			return;
+		}
+
+		std::vector<uint8_t> &plane = PrepareMapPlane(_loaded_map_planes.m6);
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
 		if (IsSavegameVersionBefore(SLV_42)) {
-			for (TileIndex i = 0; i != size;) {
+			for (uint i = 0; i != size;) {
 				/* 1024, otherwise we overflow on 64x64 maps! */
 				SlCopy(buf.data(), 1024, SLE_UINT8);
 				for (uint j = 0; j != 1024; j++) {
-					Tile(i++).m6() = GB(buf[j], 0, 2);
-					Tile(i++).m6() = GB(buf[j], 2, 2);
-					Tile(i++).m6() = GB(buf[j], 4, 2);
-					Tile(i++).m6() = GB(buf[j], 6, 2);
+					plane[i++] = GB(buf[j], 0, 2);
+					plane[i++] = GB(buf[j], 2, 2);
+					plane[i++] = GB(buf[j], 4, 2);
+					plane[i++] = GB(buf[j], 6, 2);
 				}
 			}
-		} else {
-			for (TileIndex i = 0; i != size;) {
+		} else if (IsSavegameVersionBefore(SLV_MAP_PLANE_FILTERS)) {
+			for (uint i = 0; i != size;) {
 				SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-				for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) Tile(i++).m6() = buf[j];
+				for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) plane[i++] = buf[j];
 			}
+		} else {
+			LoadMapPlaneRLE([&plane](uint t, uint8_t v) { plane[t] = v; });
 		}
 	}
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).m6();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
+		if (SlIsRawSnapshot()) {
+			SaveRawTileArray(Map::GetExtendedTileMemory());
+			return;
 		}
+
+		SaveMapPlaneRLE([](uint t) { return Tile(t).m6(); });
 	}
 };
 
 struct MAP7ChunkHandler : ChunkHandler {
 	MAP7ChunkHandler() : ChunkHandler('MAP7', CH_RIFF) {}
 
+	bool CanSaveInParallel() const override { return true; }
+	bool CanLoadInParallel() const override { return true; }
+	void FinishParallelLoad() const override { CopyLoadedMapPlanes(); }
+
 	void Load() const override
 	{
+		/* Raw snapshots store this plane in MAPE. */
+		if (SlIsRawSnapshot()) return;
+
+		std::vector<uint8_t> &plane = PrepareMapPlane(_loaded_map_planes.m7);
+
+		if (!IsSavegameVersionBefore(SLV_MAP_PLANE_FILTERS)) {
+			LoadMapPlaneRLE([&plane](uint t, uint8_t v) { plane[t] = v; });
+			return;
+		}
+
 		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
-		for (TileIndex i = 0; i != size;) {
+		for (uint i = 0; i != size;) {
 			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) Tile(i++).m7() = buf[j];
+			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) plane[i++] = buf[j];
 		}
 	}
 
 	void Save() const override
 	{
-		std::array<uint8_t, MAP_SL_BUF_SIZE> buf;
-		uint size = Map::Size();
-
-		SlSetLength(size);
-		for (TileIndex i = 0; i != size;) {
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) buf[j] = Tile(i++).m7();
-			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT8);
+		if (SlIsRawSnapshot()) {
+			SlSetLength(0);
+			return;
 		}
+
+		SaveMapPlaneRLE([](uint t) { return Tile(t).m7(); });
 	}
 };
 
 struct MAP8ChunkHandler : ChunkHandler {
 	MAP8ChunkHandler() : ChunkHandler('MAP8', CH_RIFF) {}
 
+	bool CanSaveInParallel() const override { return true; }
+	bool CanLoadInParallel() const override { return true; }
+	void FinishParallelLoad() const override { CopyLoadedMapPlanes(); }
+
 	void Load() const override
 	{
+		/* Raw snapshots store this plane in MAPE. */
+		if (SlIsRawSnapshot()) return;
+
+		std::vector<uint16_t> &plane = PrepareMapPlane(_loaded_map_planes.m8);
 		std::array<uint16_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
-		for (TileIndex i = 0; i != size;) {
+		for (uint i = 0; i != size;) {
 			SlCopy(buf.data(), MAP_SL_BUF_SIZE, SLE_UINT16);
-			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) Tile(i++).m8() = buf[j];
+			for (uint j = 0; j != MAP_SL_BUF_SIZE; j++) plane[i++] = buf[j];
 		}
 	}
 
 	void Save() const override
 	{
+		if (SlIsRawSnapshot()) {
+			SlSetLength(0);
+			return;
+		}
+
 		std::array<uint16_t, MAP_SL_BUF_SIZE> buf;
 		uint size = Map::Size();
 
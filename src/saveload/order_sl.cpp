@@ -121,6 +121,8 @@ SaveLoadTable GetOrderDescription()
 struct ORDRChunkHandler : ChunkHandler {
 	ORDRChunkHandler() : ChunkHandler('ORDR', CH_TABLE) {}
 
+	bool CanSaveInParallel() const override { return true; }
+
 	void Save() const override
 	{
 		const SaveLoadTable slt = GetOrderDescription();
@@ -210,6 +212,8 @@ SaveLoadTable GetOrderListDescription()
 struct ORDLChunkHandler : ChunkHandler {
 	ORDLChunkHandler() : ChunkHandler('ORDL', CH_TABLE) {}
 
+	bool CanSaveInParallel() const override { return true; }
+
 	void Save() const override
 	{
 		const SaveLoadTable slt = GetOrderListDescription();
@@ -0,0 +1,209 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file savebench.cpp Benchmark of saving and loading savegames.
+ *
+ * Every savegame is loaded from disk, and then saved in memory and loaded back
+ * from memory in each of the savegame formats. For all of those the total time,
+ * the time spent on each chunk and the time spent in AfterLoadGame is reported
+ * as JSON, so the results of different builds can be compared by scripts.
+ */
+
+#include "../stdafx.h"
+#include "../debug.h"
+#include "../fileio_func.h"
+#include "../newgrf_config.h"
+#include "../window_func.h"
+#include "../openttd.h"
+#include "../rev.h"
+#include "saveload.h"
+#include "saveload_filter.h"
+#include "savebench.h"
+
+#include "../3rdparty/nlohmann/json.hpp"
+
+#include "../safeguards.h"
+
+SaveBenchmark _save_benchmark;
+
+extern bool SafeLoad(const std::string &filename, SaveLoadOperation fop, DetailedFileType dft, GameMode newgm, Subdirectory subdir, std::shared_ptr<struct LoadFilter> lf);
+
+/** Filter writing the savegame into memory. */
+struct BenchmarkSaveFilter : SaveFilter {
+	std::vector<uint8_t> &data; ///< Where to write the savegame to.
+
+	/**
+	 * Initialise this filter.
+	 * @param data Where to write the savegame to.
+	 */
+	BenchmarkSaveFilter(std::vector<uint8_t> &data) : SaveFilter(nullptr), data(data)
+	{
+	}
+
+	void Write(uint8_t *buf, size_t len) override
+	{
+		this->data.insert(this->data.end(), buf, buf + len);
+	}
+};
+
+/** Filter reading the savegame from memory. */
+struct BenchmarkLoadFilter : LoadFilter {
+	const std::vector<uint8_t> &data; ///< The savegame.
+	size_t pos = 0;                   ///< Position in the savegame we are at.
+
+	/**
+	 * Initialise this filter.
+	 * @param data The savegame.
+	 */
+	BenchmarkLoadFilter(const std::vector<uint8_t> &data) : LoadFilter(nullptr), data(data)
+	{
+	}
+
+	size_t Read(uint8_t *buf, size_t size) override
+	{
+		size_t len = std::min(size, this->data.size() - this->pos);
+		std::copy_n(this->data.data() + this->pos, len, buf);
+		this->pos += len;
+		return len;
+	}
+
+	void Reset() override
+	{
+		this->pos = 0;
+	}
+};
+
+/**
+ * Convert a duration to milliseconds, for reporting.
+ * @param duration The duration to convert.
+ * @return The duration in milliseconds.
+ */
+static double ToMilliseconds(std::chrono::steady_clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/**
+ * Measure how long saving or loading a game takes.
+ * @param operation Whether the game is being saved or loaded.
+ * @param proc The function saving or loading the game.
+ * @return The results of the measurement.
+ */
+static nlohmann::json Measure(std::string_view operation, const std::function<bool()> &proc)
+{
+	SaveLoadProfile profile;
+	SlSetProfile(&profile);
+	auto start = std::chrono::steady_clock::now();
+	bool success = proc();
+	auto total = std::chrono::steady_clock::now() - start;
+	SlSetProfile(nullptr);
+
+	if (!success) _save_benchmark.failed = true;
+
+	nlohmann::json result;
+	result["operation"] = operation;
+	result["success"] = success;
+	result["total_ms"] = ToMilliseconds(total);
+
+	nlohmann::json &chunks = result["chunks_ms"] = nlohmann::json::object();
+	for (const auto &[name, duration] : profile.chunks) chunks[name] = ToMilliseconds(duration);
+
+	if (operation == "load") {
+		result["fix_pointers_ms"] = ToMilliseconds(profile.fix_pointers);
+		result["after_load_ms"] = ToMilliseconds(profile.after_load);
+	}
+	return result;
+}
+
+/**
+ * Load a game, the way it is done when loading a game from the menu.
+ * @param filename The savegame to load, when not loading from memory.
+ * @param lf The filter to load the savegame from memory with, or \c nullptr to load from disk.
+ * @return True iff the game was loaded.
+ */
+static bool BenchmarkLoad(const std::string &filename, std::shared_ptr<LoadFilter> lf)
+{
+	ResetGRFConfig(true);
+	ResetWindowSystem();
+	return SafeLoad(filename, SLO_LOAD, DFT_GAME_FILE, GM_NORMAL, NO_DIRECTORY, lf);
+}
+
+/**
+ * Benchmark a single savegame, in all requested formats.
+ * @param savegame The savegame to benchmark.
+ * @param formats The formats to save the game in.
+ * @param[out] results Where to add the results to.
+ */
+static void BenchmarkSavegame(const std::string &savegame, const std::vector<std::string> &formats, nlohmann::json &results)
+{
+	for (uint iteration = 0; iteration < _save_benchmark.iterations; iteration++) {
+		Debug(sl, 1, "Benchmarking {}, iteration {}", savegame, iteration);
+
+		nlohmann::json result = Measure("load", [&savegame]() { return BenchmarkLoad(savegame, nullptr); });
+		result["savegame"] = savegame;
+		result["format"] = "file";
+		result["iteration"] = iteration;
+		bool success = result["success"];
+		results.push_back(std::move(result));
+		if (!success) return;
+
+		for (const std::string &format : formats) {
+			std::vector<uint8_t> data;
+
+			std::string savegame_format = std::exchange(_savegame_format, format);
+			nlohmann::json save = Measure("save", [&data]() { return SaveWithFilter(std::make_shared<BenchmarkSaveFilter>(data), false, false, false) == SL_OK; });
+			_savegame_format = savegame_format;
+
+			nlohmann::json load = Measure("load", [&data]() { return BenchmarkLoad({}, std::make_shared<BenchmarkLoadFilter>(data)); });
+
+			for (nlohmann::json *result : {&save, &load}) {
+				(*result)["savegame"] = savegame;
+				(*result)["format"] = format;
+				(*result)["iteration"] = iteration;
+				(*result)["size"] = data.size();
+			}
+			bool success = save["success"] && load["success"];
+			results.push_back(std::move(save));
+			results.push_back(std::move(load));
+			if (!success) return;
+		}
+	}
+}
+
+/**
+ * Run the benchmark requested in #_save_benchmark, and write the results.
+ * The game has to be fully initialised, including the NewGRF scan, before
+ * the savegames can be loaded.
+ */
+void RunSaveBenchmark()
+{
+	const std::vector<std::string> formats = _save_benchmark.formats.empty() ? GetSavegameFormatNames() : _save_benchmark.formats;
+
+	nlohmann::json results = nlohmann::json::array();
+	for (const std::string &savegame : _save_benchmark.savegames) {
+		BenchmarkSavegame(savegame, formats, results);
+	}
+
+	nlohmann::json benchmark;
+	benchmark["version"] = std::string(_openttd_revision);
+	benchmark["results"] = std::move(results);
+
+	std::string output = benchmark.dump(1, '\t');
+	if (_save_benchmark.output.empty()) {
+		fmt::print("{}\n", output);
+		return;
+	}
+
+	auto f = FileHandle::Open(_save_benchmark.output, "w");
+	if (!f.has_value()) {
+		Debug(misc, 0, "Cannot open {} to write the benchmark results to", _save_benchmark.output);
+		_save_benchmark.failed = true;
+		return;
+	}
+	fmt::print(*f, "{}\n", output);
+}
@@ -0,0 +1,26 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file savebench.h Benchmark of saving and loading savegames. */
+
+#ifndef SAVEBENCH_H
+#define SAVEBENCH_H
+
+/** What to benchmark, as requested by the openttd_savebench tool. */
+struct SaveBenchmark {
+	std::vector<std::string> savegames; ///< The savegames to load and save; nothing is benchmarked when empty.
+	std::vector<std::string> formats;   ///< The savegame formats to save in; all available formats when empty.
+	std::string output;                 ///< The file to write the results to; the standard output when empty.
+	uint iterations = 1;                ///< How often every measurement is repeated.
+	bool failed = false;                ///< Whether saving or loading any of the savegames failed.
+};
+
+extern SaveBenchmark _save_benchmark;
+
+void RunSaveBenchmark();
+
+#endif /* SAVEBENCH_H */
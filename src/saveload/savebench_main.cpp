@@ -0,0 +1,106 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file savebench_main.cpp Main entry for the savegame benchmark, openttd_savebench. */
+
+#include "../stdafx.h"
+#include "../openttd.h"
+#include "../crashlog.h"
+#include "../core/format.hpp"
+#include "../core/random_func.hpp"
+#include "../misc/getoptdata.h"
+#include "../string_func.h"
+#include "savebench.h"
+
+#include <charconv>
+#include <filesystem>
+#include <time.h>
+
+#include "../safeguards.h"
+
+/** Options of openttd_savebench. */
+static const OptionData _options[] = {
+	{ .type = ODF_HAS_VALUE, .id = 'c', .shortname = 'c' },
+	{ .type = ODF_HAS_VALUE, .id = 'f', .shortname = 'f' },
+	{ .type = ODF_NO_VALUE, .id = 'h', .shortname = 'h' },
+	{ .type = ODF_HAS_VALUE, .id = 'n', .shortname = 'n' },
+	{ .type = ODF_HAS_VALUE, .id = 'o', .shortname = 'o' },
+};
+
+/** Show the usage of openttd_savebench. */
+static void ShowUsage()
+{
+	fmt::print(stderr,
+		"Usage: openttd_savebench [options] savegame...\n"
+		"  -c config_file  = Use 'config_file' instead of 'openttd.cfg'\n"
+		"  -f format       = Save in this format, e.g. 'zlib' or 'zstd:19';\n"
+		"                    may be given multiple times, default all formats\n"
+		"  -n iterations   = Repeat every measurement this often (default 1)\n"
+		"  -o file         = Write the results to 'file' instead of the standard output\n"
+		"  -h              = Show this help\n");
+}
+
+int CDECL main(int argc, char *argv[])
+{
+	/* Make sure our arguments contain only valid UTF-8 characters. */
+	for (int i = 0; i < argc; i++) StrMakeValidInPlace(argv[i]);
+
+	CrashLog::InitialiseCrashLog();
+
+	SetRandomSeed(time(nullptr));
+
+	/* Run the game without video, sound and music; the null video driver runs the benchmark. */
+	std::vector<std::string> arguments = { argv[0], "-v", "null:ticks=1", "-s", "null", "-m", "null" };
+
+	GetOptData mgo(std::span(argv, argc).subspan(1), _options);
+	int i;
+	while ((i = mgo.GetOpt()) != -1) {
+		switch (i) {
+			case 'c':
+				arguments.insert(arguments.end(), { "-c", mgo.opt });
+				break;
+
+			case 'f':
+				_save_benchmark.formats.emplace_back(mgo.opt);
+				break;
+
+			case 'n': {
+				std::string_view value = mgo.opt;
+				auto [end, err] = std::from_chars(value.data(), value.data() + value.size(), _save_benchmark.iterations);
+				if (err != std::errc() || end != value.data() + value.size() || _save_benchmark.iterations == 0) {
+					ShowUsage();
+					return 1;
+				}
+				break;
+			}
+
+			case 'o':
+				_save_benchmark.output = mgo.opt;
+				break;
+
+			default:
+				ShowUsage();
+				return i == 'h' ? 0 : 1;
+		}
+	}
+
+	if (mgo.arguments.empty()) {
+		ShowUsage();
+		return 1;
+	}
+
+	/* The savegames are loaded by their full path, as the game may change its working directory. */
+	for (const char *savegame : mgo.arguments) {
+		_save_benchmark.savegames.push_back(FS2OTTD(std::filesystem::absolute(OTTD2FS(savegame))));
+	}
+
+	std::vector<char *> openttd_arguments;
+	for (std::string &argument : arguments) openttd_arguments.push_back(argument.data());
+
+	int ret = openttd_main(openttd_arguments);
+	return (ret == 0 && _save_benchmark.failed) ? 1 : ret;
+}
@@ -42,10 +42,24 @@
 #include "../string_func.h"
 #include "../fios.h"
 #include "../error.h"
+#include "../video/video_driver.hpp"
+#include "../3rdparty/md5/md5.h"
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 #ifdef __EMSCRIPTEN__
 #	include <emscripten.h>
 #endif
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+#	include <unistd.h>
+#	include <poll.h>
+#	include <signal.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <sys/wait.h>
+#endif
 
 #include "table/strings.h"
 
@@ -86,17 +100,23 @@ static const size_t MEMORY_CHUNK_SIZE = 128 * 1024;
 /** A buffer for reading (and buffering) savegame data. */
 struct ReadBuffer {
 	uint8_t buf[MEMORY_CHUNK_SIZE]; ///< Buffer we're going to read from.
-	uint8_t *bufp;                  ///< Location we're at reading the buffer.
-	uint8_t *bufe;                  ///< End of the buffer we can read from.
+	const uint8_t *bufp;            ///< Location we're at reading the buffer.
+	const uint8_t *bufe;            ///< End of the buffer we can read from.
 	std::shared_ptr<LoadFilter> reader; ///< The filter used to actually read.
 	size_t read;                 ///< The amount of read bytes so far from the filter.
+	bool in_memory;              ///< Whether the whole savegame is read from memory directly, instead of via the buffer.
 
 	/**
 	 * Initialise our variables.
 	 * @param reader The filter to actually read data.
 	 */
-	ReadBuffer(std::shared_ptr<LoadFilter> reader) : bufp(nullptr), bufe(nullptr), reader(reader), read(0)
+	ReadBuffer(std::shared_ptr<LoadFilter> reader) : reader(reader)
 	{
+		std::span<const uint8_t> remainder = this->reader->TakeRemainder();
+		this->bufp = remainder.data();
+		this->bufe = remainder.data() + remainder.size();
+		this->read = remainder.size();
+		this->in_memory = !remainder.empty();
 	}
 
 	inline uint8_t ReadByte()
@@ -113,6 +133,30 @@ struct ReadBuffer {
 		return *this->bufp++;
 	}
 
+	/**
+	 * Read a number of bytes at once.
+	 * @param buf  The buffer to read the bytes into.
+	 * @param size The number of bytes to read.
+	 */
+	void Read(uint8_t *buf, size_t size)
+	{
+		for (;;) {
+			size_t len = std::min<size_t>(size, this->bufe - this->bufp);
+			std::copy_n(this->bufp, len, buf);
+			this->bufp += len;
+			buf += len;
+			size -= len;
+			if (size == 0) return;
+
+			len = this->reader->Read(this->buf, lengthof(this->buf));
+			if (len == 0) SlErrorCorrupt("Unexpected end of chunk");
+
+			this->read += len;
+			this->bufp = this->buf;
+			this->bufe = this->buf + len;
+		}
+	}
+
 	/**
 	 * Get the size of the memory dump made so far.
 	 * @return The size.
@@ -146,22 +190,95 @@ struct MemoryDumper {
 	}
 
 	/**
-	 * Flush this dumper into a writer.
-	 * @param writer The filter we want to use.
+	 * Write a number of bytes at once into the dumper.
+	 * @param data The bytes to write.
+	 * @param len  The number of bytes to write.
 	 */
-	void Flush(std::shared_ptr<SaveFilter> writer)
+	void Write(const uint8_t *data, size_t len)
 	{
-		uint i = 0;
-		size_t t = this->GetSize();
+		while (len != 0) {
+			/* Are we at the end of this chunk? */
+			if (this->buf == this->bufe) {
+				this->buf = this->blocks.emplace_back(std::make_unique<uint8_t[]>(MEMORY_CHUNK_SIZE)).get();
+				this->bufe = this->buf + MEMORY_CHUNK_SIZE;
+			}
+
+			size_t n = std::min<size_t>(len, this->bufe - this->buf);
+			std::copy_n(data, n, this->buf);
+			this->buf += n;
+			data += n;
+			len -= n;
+		}
+	}
+
+	/**
+	 * Get the location of a byte that has already been written into the dumper.
+	 * @param pos The position of the byte.
+	 * @return Pointer to the byte.
+	 */
+	inline uint8_t *GetPointer(size_t pos)
+	{
+		return this->blocks[pos / MEMORY_CHUNK_SIZE].get() + pos % MEMORY_CHUNK_SIZE;
+	}
+
+	/**
+	 * Overwrite bytes that have already been written into the dumper, e.g.
+	 * to fill in a length field that was reserved before writing an object.
+	 * @param pos  The position of the first byte to overwrite.
+	 * @param data The bytes to write.
+	 * @param len  The number of bytes to write.
+	 */
+	void Patch(size_t pos, const uint8_t *data, size_t len)
+	{
+		assert(pos + len <= this->GetSize());
+		for (size_t i = 0; i != len; i++) *this->GetPointer(pos + i) = data[i];
+	}
+
+	/**
+	 * Throw away everything written into the dumper. The first block is kept,
+	 * so a dumper that is used for many small objects does not allocate for each.
+	 */
+	void Clear()
+	{
+		if (this->blocks.size() > 1) this->blocks.resize(1);
+		if (!this->blocks.empty()) {
+			this->buf = this->blocks[0].get();
+			this->bufe = this->buf + MEMORY_CHUNK_SIZE;
+		}
+	}
 
-		while (t > 0) {
-			size_t to_write = std::min(MEMORY_CHUNK_SIZE, t);
+	/**
+	 * Write everything written into this dumper into another dumper, and clear this one.
+	 * @param dest The dumper to write to.
+	 */
+	void MoveTo(MemoryDumper &dest)
+	{
+		size_t t = this->GetSize();
+		for (const auto &block : this->blocks) {
+			size_t len = std::min(MEMORY_CHUNK_SIZE, t);
+			dest.Write(block.get(), len);
+			t -= len;
+		}
+		this->Clear();
+	}
 
-			writer->Write(this->blocks[i++].get(), to_write);
-			t -= to_write;
+	/**
+	 * Take everything written into this dumper out of it, e.g. to write it
+	 * elsewhere. The dumper is empty afterwards.
+	 * @param proc Function called with every block and the number of bytes written into it.
+	 */
+	template <typename F>
+	void TakeBlocks(F proc)
+	{
+		size_t t = this->GetSize();
+		for (auto &block : this->blocks) {
+			size_t len = std::min(MEMORY_CHUNK_SIZE, t);
+			proc(std::move(block), len);
+			t -= len;
 		}
 
-		writer->Finish();
+		this->blocks.clear();
+		this->buf = this->bufe = nullptr;
 	}
 
 	/**
@@ -172,20 +289,151 @@ struct MemoryDumper {
 	{
 		return this->blocks.size() * MEMORY_CHUNK_SIZE - (this->bufe - this->buf);
 	}
+
+	/**
+	 * Get a hash of the memory dump, e.g. to find out whether it changed since an earlier save.
+	 * @return The hash.
+	 */
+	uint64_t GetHash() const
+	{
+		uint64_t hash = 0;
+		for (const auto &block : this->blocks) {
+			size_t len = (&block == &this->blocks.back()) ? MEMORY_CHUNK_SIZE - (this->bufe - this->buf) : MEMORY_CHUNK_SIZE;
+			uint64_t block_hash = std::hash<std::string_view>{}(std::string_view(reinterpret_cast<const char *>(block.get()), len));
+			hash ^= block_hash + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+		}
+		return hash;
+	}
+};
+
+/**
+ * The savegame while it is being saved. The chunks are handed to the save filter in
+ * blocks as soon as they, and all chunks before them, are saved, so the savegame is
+ * not kept in memory any longer than needed. When saving in the background, the
+ * savegame thread compresses and writes the blocks. At most #MAX_QUEUED_BLOCKS blocks
+ * are queued for it, so saving the chunks waits for the savegame thread when that
+ * cannot keep up. The chunks are saved while the game state is locked, so while
+ * waiting the lock is handed to drawing, like it is in between chunks.
+ */
+class SaveStream {
+public:
+	static constexpr size_t MAX_QUEUED_BLOCKS = 32; ///< Maximum number of blocks queued for the savegame thread, i.e. 4 MiB.
+
+	/**
+	 * Write the blocks directly to a filter, instead of queueing them for the savegame thread.
+	 * @param writer The filter to write to.
+	 */
+	void WriteDirectly(std::shared_ptr<SaveFilter> writer)
+	{
+		this->writer = writer;
+	}
+
+	/**
+	 * Write everything in a dumper to the savegame. The dumper is empty afterwards.
+	 * @param dumper The dumper to take the data from.
+	 * @param driver The video driver to let draw while waiting for the savegame thread, if any.
+	 */
+	void Write(MemoryDumper &dumper, VideoDriver *driver)
+	{
+		dumper.TakeBlocks([this, driver](std::unique_ptr<uint8_t[]> &&block, size_t len) {
+			if (this->writer != nullptr) {
+				this->writer->Write(block.get(), len);
+				return;
+			}
+
+			std::unique_lock<std::mutex> lock(this->mutex);
+			auto has_room = [this]() { return this->queue.size() < MAX_QUEUED_BLOCKS || this->failed; };
+			if (driver == nullptr) {
+				this->cv.wait(lock, has_room);
+			} else {
+				while (!this->cv.wait_for(lock, std::chrono::milliseconds(1), has_room)) {
+					lock.unlock();
+					driver->GameLoopDrawPoint();
+					lock.lock();
+				}
+			}
+			/* Writing failed already; the savegame thread reports that once all chunks are saved. */
+			if (this->failed) return;
+
+			this->queue.emplace_back(std::move(block), len);
+			this->cv.notify_all();
+		});
+	}
+
+	/** Mark the savegame as complete, i.e. all chunks have been written. */
+	void Finish()
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->finished = true;
+		this->cv.notify_all();
+	}
+
+	/** Stop writing the savegame, as saving the chunks failed. */
+	void Abort()
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->aborted = true;
+		this->cv.notify_all();
+	}
+
+	/**
+	 * Write the queued blocks to a filter until the savegame is complete. This is done by the savegame thread.
+	 * @param writer The filter to write to.
+	 * @return False iff saving the chunks failed, in which case the thread saving them handles the error.
+	 */
+	bool Drain(SaveFilter &writer)
+	{
+		for (;;) {
+			std::pair<std::unique_ptr<uint8_t[]>, size_t> block;
+			{
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->cv.wait(lock, [this]() { return !this->queue.empty() || this->finished || this->aborted; });
+				if (this->aborted) return false;
+				if (this->queue.empty()) return true;
+
+				block = std::move(this->queue.front());
+				this->queue.pop_front();
+				this->cv.notify_all();
+			}
+
+			writer.Write(block.first.get(), block.second);
+		}
+	}
+
+	/**
+	 * Stop queueing blocks, as writing the savegame failed, and wait until all chunks
+	 * are saved, so the error can be handled without the game state being in use.
+	 * This is done by the savegame thread.
+	 * @return False iff saving the chunks failed as well, in which case the thread saving them handles the error.
+	 */
+	bool Fail()
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->failed = true;
+		this->queue.clear();
+		this->cv.notify_all();
+
+		this->cv.wait(lock, [this]() { return this->finished || this->aborted; });
+		return !this->aborted;
+	}
+
+private:
+	std::shared_ptr<SaveFilter> writer; ///< The filter to write to directly, if not queueing for the savegame thread.
+	std::mutex mutex;                   ///< Lock for the queue and the state.
+	std::condition_variable cv;         ///< Signalled when the queue or the state changes.
+	std::deque<std::pair<std::unique_ptr<uint8_t[]>, size_t>> queue; ///< Blocks waiting to be written, with the number of bytes written into them.
+	bool finished = false;              ///< Whether all chunks have been written.
+	bool aborted = false;               ///< Whether saving the chunks failed.
+	bool failed = false;                ///< Whether writing to the filter failed.
 };
 
 /** The saveload struct, containing reader-writer functions, buffer, version, etc. */
 struct SaveLoadParams {
 	SaveLoadAction action;               ///< are we doing a save or a load atm.
-	NeedLength need_length;              ///< working in NeedLength (Autolength) mode?
-	uint8_t block_mode;                     ///< ???
 	bool error;                          ///< did an error occur or not
 
-	size_t obj_len;                      ///< the length of the current object we are busy with
-	int array_index, last_array_index;   ///< in the case of an array, the current and last positions
-	bool expect_table_header;            ///< In the case of a table, if the header is saved/loaded.
-
-	std::unique_ptr<MemoryDumper> dumper; ///< Memory dumper to write the savegame to.
+	std::unique_ptr<MemoryDumper> dumper; ///< Memory dumper to write the parts of the savegame between the chunks to.
+	std::shared_ptr<SaveStream> stream; ///< The savegame the chunks are written to.
 	std::shared_ptr<SaveFilter> sf; ///< Filter to write the savegame to.
 
 	std::unique_ptr<ReadBuffer> reader; ///< Savegame reading buffer.
@@ -195,10 +443,39 @@ struct SaveLoadParams {
 	std::string extra_msg;               ///< the error message
 
 	bool saveinprogress;                 ///< Whether there is currently a save in progress.
+	bool raw_snapshot;                   ///< Whether the savegame is a raw snapshot, see #SlIsRawSnapshot.
+	const struct SaveLoadFormat *save_format; ///< The format to save the game in, see #SlSetSaveFormat.
+	uint8_t save_compression;            ///< The compression level to save the game with.
+
+	std::map<uint32_t, std::vector<uint8_t>> journal; ///< Chunks to load from the journal of incremental autosaves instead of from the savegame, by identifier.
+	std::vector<uint64_t> *chunk_hashes; ///< If set, where the hashes of the chunks are stored when saving.
+	bool journal_segment;                ///< Whether to only save the chunks of which the hash changed, as segment of a journal.
+	bool forked_child;                   ///< Whether this is the forked child process of #DoForkedSave, which only has a single thread.
 };
 
 static SaveLoadParams _sl; ///< Parameters used for/at saveload.
 
+/** The state of the chunk that is currently being saved or loaded. Every thread has its own, so chunks can be saved in parallel. */
+struct SaveLoadChunkParams {
+	NeedLength need_length;              ///< working in NeedLength (Autolength) mode?
+	uint8_t block_mode;                     ///< ???
+
+	size_t obj_len;                      ///< the length of the current object we are busy with
+	int array_index, last_array_index;   ///< in the case of an array, the current and last positions
+	bool expect_table_header;            ///< In the case of a table, if the header is saved/loaded.
+
+	MemoryDumper *dumper;                ///< Memory dumper to write the chunk to.
+	MemoryDumper *object_parent;         ///< While writing an array element to #_sl_object_dumper, the dumper to write it to afterwards.
+	ReadBuffer *reader;                  ///< Buffer to read the chunk from.
+
+	std::unordered_map<std::string, size_t> saved_strings; ///< Index of the strings saved so far in the chunk, see #SlInternedString.
+	std::vector<std::string> loaded_strings; ///< The strings loaded so far in the chunk, by index, see #SlInternedString.
+	bool defer_cleanup;                  ///< Whether cleaning up after an error is left to whoever catches it, as other threads might still be loading.
+};
+
+static thread_local SaveLoadChunkParams _sl_chunk; ///< Parameters of the chunk that is being saved or loaded by this thread.
+static thread_local MemoryDumper _sl_object_dumper; ///< Dumper to write an array element to, until its length is known; see #SlReserveLength.
+
 static const std::vector<ChunkHandlerRef> &ChunkHandlers()
 {
 	/* These define the chunks */
@@ -310,6 +587,17 @@ static void SlNullPointers()
 	assert(_sl.action == SLA_NULL);
 }
 
+/**
+ * Whether the savegame that is being saved or loaded is a raw snapshot. Those
+ * store the map as it is in memory, so it is saved and loaded without any
+ * conversion, but it can only be loaded by builds with the same byte order.
+ * @return True iff the savegame is a raw snapshot.
+ */
+bool SlIsRawSnapshot()
+{
+	return _sl.raw_snapshot;
+}
+
 /**
  * Error handler. Sets everything up to show an error message and to clean
  * up the mess of a partial savegame load.
@@ -325,10 +613,15 @@ static void SlNullPointers()
 		_load_check_data.error = string;
 		_load_check_data.error_msg = extra_msg;
 	} else {
+		/* Chunks can be saved by multiple threads at the same time. */
+		static std::mutex error_mutex;
+		std::lock_guard<std::mutex> lock(error_mutex);
 		_sl.error_str = string;
 		_sl.extra_msg = extra_msg;
 	}
 
+	if (_sl_chunk.defer_cleanup) throw std::exception();
+
 	/* We have to nullptr all pointers here; we might be in a state where
 	 * the pointers are actually filled with indices, which means that
 	 * when we access them during cleaning the pool dereferences of
@@ -341,6 +634,21 @@ static void SlNullPointers()
 	throw std::exception();
 }
 
+/**
+ * Clean up the mess of a partial savegame load like SlError does, for errors
+ * of which the clean up was deferred, and rethrow the error.
+ * @param error The error to rethrow.
+ */
+[[noreturn]] static void SlCleanUpAndRethrow(std::exception_ptr error)
+{
+	if (_sl.action == SLA_LOAD || _sl.action == SLA_PTRS) SlNullPointers();
+
+	/* Logging could be active. */
+	_gamelog.StopAnyAction();
+
+	std::rethrow_exception(error);
+}
+
 /**
  * Error handler for corrupt savegames. Sets everything up to show the
  * error message and to clean up the mess of a partial savegame load.
@@ -391,7 +699,7 @@ void ProcessAsyncSaveFinish()
  */
 uint8_t SlReadByte()
 {
-	return _sl.reader->ReadByte();
+	return _sl_chunk.reader->ReadByte();
 }
 
 /**
@@ -400,7 +708,7 @@ uint8_t SlReadByte()
  */
 void SlWriteByte(uint8_t b)
 {
-	_sl.dumper->WriteByte(b);
+	_sl_chunk.dumper->WriteByte(b);
 }
 
 static inline int SlReadUint16()
@@ -491,28 +799,34 @@ static uint SlReadSimpleGamma()
  * @param i Index being written
  */
 
-static void SlWriteSimpleGamma(size_t i)
+template <typename F>
+static void SlEncodeSimpleGamma(size_t i, F write_byte)
 {
 	if (i >= (1 << 7)) {
 		if (i >= (1 << 14)) {
 			if (i >= (1 << 21)) {
 				if (i >= (1 << 28)) {
 					assert(i <= UINT32_MAX); // We can only support 32 bits for now.
-					SlWriteByte((uint8_t)(0xF0));
-					SlWriteByte((uint8_t)(i >> 24));
+					write_byte((uint8_t)(0xF0));
+					write_byte((uint8_t)(i >> 24));
 				} else {
-					SlWriteByte((uint8_t)(0xE0 | (i >> 24)));
+					write_byte((uint8_t)(0xE0 | (i >> 24)));
 				}
-				SlWriteByte((uint8_t)(i >> 16));
+				write_byte((uint8_t)(i >> 16));
 			} else {
-				SlWriteByte((uint8_t)(0xC0 | (i >> 16)));
+				write_byte((uint8_t)(0xC0 | (i >> 16)));
 			}
-			SlWriteByte((uint8_t)(i >> 8));
+			write_byte((uint8_t)(i >> 8));
 		} else {
-			SlWriteByte((uint8_t)(0x80 | (i >> 8)));
+			write_byte((uint8_t)(0x80 | (i >> 8)));
 		}
 	}
-	SlWriteByte((uint8_t)i);
+	write_byte((uint8_t)i);
+}
+
+static void SlWriteSimpleGamma(size_t i)
+{
+	SlEncodeSimpleGamma(i, SlWriteByte);
 }
 
 /** Return how many bytes used to encode a gamma value */
@@ -645,11 +959,11 @@ static inline size_t SlCalcRefLen()
 
 void SlSetArrayIndex(uint index)
 {
-	_sl.need_length = NL_WANTLENGTH;
-	_sl.array_index = index;
+	_sl_chunk.need_length = NL_WANTLENGTH;
+	_sl_chunk.array_index = index;
 }
 
-static size_t _next_offs;
+static thread_local size_t _next_offs;
 
 /**
  * Iterate through the elements of an array and read the whole thing
@@ -659,32 +973,32 @@ int SlIterateArray()
 {
 	/* After reading in the whole array inside the loop
 	 * we must have read in all the data, so we must be at end of current block. */
-	if (_next_offs != 0 && _sl.reader->GetSize() != _next_offs) {
-		SlErrorCorruptFmt("Invalid chunk size iterating array - expected to be at position {}, actually at {}", _next_offs, _sl.reader->GetSize());
+	if (_next_offs != 0 && _sl_chunk.reader->GetSize() != _next_offs) {
+		SlErrorCorruptFmt("Invalid chunk size iterating array - expected to be at position {}, actually at {}", _next_offs, _sl_chunk.reader->GetSize());
 	}
 
 	for (;;) {
 		uint length = SlReadArrayLength();
 		if (length == 0) {
-			assert(!_sl.expect_table_header);
+			assert(!_sl_chunk.expect_table_header);
 			_next_offs = 0;
 			return -1;
 		}
 
-		_sl.obj_len = --length;
-		_next_offs = _sl.reader->GetSize() + length;
+		_sl_chunk.obj_len = --length;
+		_next_offs = _sl_chunk.reader->GetSize() + length;
 
-		if (_sl.expect_table_header) {
-			_sl.expect_table_header = false;
+		if (_sl_chunk.expect_table_header) {
+			_sl_chunk.expect_table_header = false;
 			return INT32_MAX;
 		}
 
 		int index;
-		switch (_sl.block_mode) {
+		switch (_sl_chunk.block_mode) {
 			case CH_SPARSE_TABLE:
 			case CH_SPARSE_ARRAY: index = (int)SlReadSparseIndex(); break;
 			case CH_TABLE:
-			case CH_ARRAY:        index = _sl.array_index++; break;
+			case CH_ARRAY:        index = _sl_chunk.array_index++; break;
 			default:
 				Debug(sl, 0, "SlIterateArray error");
 				return -1; // error
@@ -700,7 +1014,7 @@ int SlIterateArray()
 void SlSkipArray()
 {
 	while (SlIterateArray() != -1) {
-		SlSkipBytes(_next_offs - _sl.reader->GetSize());
+		SlSkipBytes(_next_offs - _sl_chunk.reader->GetSize());
 	}
 }
 
@@ -713,16 +1027,16 @@ void SlSetLength(size_t length)
 {
 	assert(_sl.action == SLA_SAVE);
 
-	switch (_sl.need_length) {
+	switch (_sl_chunk.need_length) {
 		case NL_WANTLENGTH:
-			_sl.need_length = NL_NONE;
-			if ((_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE) && _sl.expect_table_header) {
-				_sl.expect_table_header = false;
+			_sl_chunk.need_length = NL_NONE;
+			if ((_sl_chunk.block_mode == CH_TABLE || _sl_chunk.block_mode == CH_SPARSE_TABLE) && _sl_chunk.expect_table_header) {
+				_sl_chunk.expect_table_header = false;
 				SlWriteArrayLength(length + 1);
 				break;
 			}
 
-			switch (_sl.block_mode) {
+			switch (_sl_chunk.block_mode) {
 				case CH_RIFF:
 					/* Ugly encoding of >16M RIFF chunks
 					 * The lower 24 bits are normal
@@ -732,29 +1046,103 @@ void SlSetLength(size_t length)
 					break;
 				case CH_TABLE:
 				case CH_ARRAY:
-					assert(_sl.last_array_index <= _sl.array_index);
-					while (++_sl.last_array_index <= _sl.array_index) {
+					assert(_sl_chunk.last_array_index <= _sl_chunk.array_index);
+					while (++_sl_chunk.last_array_index <= _sl_chunk.array_index) {
 						SlWriteArrayLength(1);
 					}
 					SlWriteArrayLength(length + 1);
 					break;
 				case CH_SPARSE_TABLE:
 				case CH_SPARSE_ARRAY:
-					SlWriteArrayLength(length + 1 + SlGetArrayLength(_sl.array_index)); // Also include length of sparse index.
-					SlWriteSparseIndex(_sl.array_index);
+					SlWriteArrayLength(length + 1 + SlGetArrayLength(_sl_chunk.array_index)); // Also include length of sparse index.
+					SlWriteSparseIndex(_sl_chunk.array_index);
 					break;
 				default: NOT_REACHED();
 			}
 			break;
 
 		case NL_CALCLENGTH:
-			_sl.obj_len += (int)length;
+			_sl_chunk.obj_len += (int)length;
 			break;
 
 		default: NOT_REACHED();
 	}
 }
 
+/**
+ * Reserve space for the length of either a RIFF object or an array element, for when
+ * the length is only known after writing it. This avoids having to go through the
+ * object twice: once to calculate its length, and once to actually write it.
+ * After writing the object, #SlWriteReservedLength fills in the actual length.
+ *
+ * The length of a RIFF object has a fixed size, so space for it is reserved in the chunk.
+ * The length of an array element is gamma encoded, so its size depends on the length;
+ * the element is written to #_sl_object_dumper instead, and it is copied into the chunk
+ * after its length.
+ * @return The position of the reserved space; only meaningful for RIFF objects.
+ */
+static size_t SlReserveLength()
+{
+	assert(_sl.action == SLA_SAVE && _sl_chunk.need_length == NL_WANTLENGTH && !_sl_chunk.expect_table_header);
+	_sl_chunk.need_length = NL_NONE;
+
+	switch (_sl_chunk.block_mode) {
+		case CH_TABLE:
+		case CH_ARRAY:
+			assert(_sl_chunk.last_array_index <= _sl_chunk.array_index);
+			while (++_sl_chunk.last_array_index <= _sl_chunk.array_index) {
+				SlWriteArrayLength(1);
+			}
+			break;
+		case CH_RIFF:
+		case CH_SPARSE_TABLE:
+		case CH_SPARSE_ARRAY:
+			break;
+		default: NOT_REACHED();
+	}
+
+	size_t pos = _sl_chunk.dumper->GetSize();
+	if (_sl_chunk.block_mode == CH_RIFF) {
+		for (uint i = 0; i != 4; i++) SlWriteByte(0);
+		return pos;
+	}
+
+	/* Array elements do not nest. The dumper might not be empty after an error during an earlier save. */
+	assert(_sl_chunk.object_parent == nullptr);
+	_sl_object_dumper.Clear();
+	_sl_chunk.object_parent = _sl_chunk.dumper;
+	_sl_chunk.dumper = &_sl_object_dumper;
+
+	/* The sparse index is part of the length. */
+	if (_sl_chunk.block_mode == CH_SPARSE_TABLE || _sl_chunk.block_mode == CH_SPARSE_ARRAY) SlWriteSparseIndex(_sl_chunk.array_index);
+
+	return pos;
+}
+
+/**
+ * Fill in the length of the object written after a call to #SlReserveLength.
+ * @param pos The position of the reserved space.
+ */
+static void SlWriteReservedLength(size_t pos)
+{
+	if (_sl_chunk.block_mode == CH_RIFF) {
+		size_t length = _sl_chunk.dumper->GetSize() - pos - 4;
+
+		/* Ugly encoding of >16M RIFF chunks, see SlSetLength. */
+		assert(length < (1 << 28));
+		uint32_t encoded = (uint32_t)((length & 0xFFFFFF) | ((length >> 24) << 28));
+		uint8_t buf[4] = { (uint8_t)GB(encoded, 24, 8), (uint8_t)GB(encoded, 16, 8), (uint8_t)GB(encoded, 8, 8), (uint8_t)GB(encoded, 0, 8) };
+		_sl_chunk.dumper->Patch(pos, buf, sizeof(buf));
+		return;
+	}
+
+	_sl_chunk.dumper = _sl_chunk.object_parent;
+	_sl_chunk.object_parent = nullptr;
+
+	SlWriteSimpleGamma(_sl_object_dumper.GetSize() + 1);
+	_sl_object_dumper.MoveTo(*_sl_chunk.dumper);
+}
+
 /**
  * Save/Load bytes. These do not need to be converted to Little/Big Endian
  * so directly write them or read them to/from file
@@ -768,10 +1156,10 @@ static void SlCopyBytes(void *ptr, size_t length)
 	switch (_sl.action) {
 		case SLA_LOAD_CHECK:
 		case SLA_LOAD:
-			for (; length != 0; length--) *p++ = SlReadByte();
+			_sl_chunk.reader->Read(p, length);
 			break;
 		case SLA_SAVE:
-			for (; length != 0; length--) SlWriteByte(*p++);
+			_sl_chunk.dumper->Write(p, length);
 			break;
 		default: NOT_REACHED();
 	}
@@ -780,7 +1168,7 @@ static void SlCopyBytes(void *ptr, size_t length)
 /** Get the length of the current object */
 size_t SlGetFieldLength()
 {
-	return _sl.obj_len;
+	return _sl_chunk.obj_len;
 }
 
 /**
@@ -924,6 +1312,24 @@ static void FixSCCEncoded(std::string &str)
 	}
 }
 
+/**
+ * Make a loaded string valid, according to what the string may contain.
+ * @param str the string to validate.
+ * @param conv must be SLE_FILE_STRING, with flags telling what the string may contain.
+ */
+static void SlValidateString(std::string &str, VarType conv)
+{
+	StringValidationSettings settings = SVS_REPLACE_WITH_QUESTION_MARK;
+	if ((conv & SLF_ALLOW_CONTROL) != 0) {
+		settings = settings | SVS_ALLOW_CONTROL_CODE;
+		if (IsSavegameVersionBefore(SLV_169)) FixSCCEncoded(str);
+	}
+	if ((conv & SLF_ALLOW_NEWLINE) != 0) {
+		settings = settings | SVS_ALLOW_NEWLINE;
+	}
+	str = StrMakeValid(str, settings);
+}
+
 /**
  * Save/Load a \c std::string.
  * @param ptr the string being manipulated
@@ -951,16 +1357,90 @@ static void SlStdString(void *ptr, VarType conv)
 
 			str->resize(len);
 			SlCopyBytes(str->data(), len);
+			SlValidateString(*str, conv);
+		}
+
+		case SLA_PTRS: break;
+		case SLA_NULL: break;
+		default: NOT_REACHED();
+	}
+}
+
+/**
+ * Calculate the gross length of a string that is a member of an object, see #SlInternedString.
+ * When the same string occurs more than once in the object, the actual length can be shorter.
+ * @param ptr Pointer to the \c std::string.
+ * @return The gross length of the string.
+ */
+static inline size_t SlCalcInternedStringLen(const void *ptr)
+{
+	if (IsSavegameVersionBefore(SLV_STRING_TABLE)) return SlCalcStdStringLen(ptr);
+
+	const std::string *str = reinterpret_cast<const std::string *>(ptr);
+	if (str->empty()) return SlGetArrayLength(0);
+
+	auto it = _sl_chunk.saved_strings.find(*str);
+	if (it != _sl_chunk.saved_strings.end()) return SlGetArrayLength(it->second + 2);
+
+	return SlGetArrayLength(1) + SlCalcStdStringLen(ptr);
+}
+
+/**
+ * Save/Load a \c std::string that is a member of an object. Since #SLV_STRING_TABLE every
+ * string is saved only once per chunk; when it occurs again, its index is saved instead.
+ * The string is preceded by 0 for an empty string, by 1 when the string itself follows,
+ * or by the index of the string in the chunk plus 2 for a string that occurred before.
+ * @param ptr the string being manipulated
+ * @param conv must be SLE_FILE_STRING
+ */
+static void SlInternedString(void *ptr, VarType conv)
+{
+	if (IsSavegameVersionBefore(SLV_STRING_TABLE)) {
+		SlStdString(ptr, conv);
+		return;
+	}
+
+	std::string *str = reinterpret_cast<std::string *>(ptr);
+
+	switch (_sl.action) {
+		case SLA_SAVE: {
+			if (str->empty()) {
+				SlWriteArrayLength(0);
+				break;
+			}
+
+			auto [it, inserted] = _sl_chunk.saved_strings.try_emplace(*str, _sl_chunk.saved_strings.size());
+			if (!inserted) {
+				SlWriteArrayLength(it->second + 2);
+				break;
+			}
+
+			SlWriteArrayLength(1);
+			SlStdString(ptr, conv);
+			break;
+		}
 
-			StringValidationSettings settings = SVS_REPLACE_WITH_QUESTION_MARK;
-			if ((conv & SLF_ALLOW_CONTROL) != 0) {
-				settings = settings | SVS_ALLOW_CONTROL_CODE;
-				if (IsSavegameVersionBefore(SLV_169)) FixSCCEncoded(*str);
+		case SLA_LOAD_CHECK:
+		case SLA_LOAD: {
+			size_t index = SlReadArrayLength();
+			if (index == 1) {
+				/* The strings are stored as they are in the savegame, as their validation depends on the field they are loaded into. */
+				std::string &loaded = _sl_chunk.loaded_strings.emplace_back(SlReadArrayLength(), '\0');
+				SlCopyBytes(loaded.data(), loaded.size());
+				index = _sl_chunk.loaded_strings.size() + 1;
+			} else if (index > 1 && index - 2 >= _sl_chunk.loaded_strings.size()) {
+				SlErrorCorrupt("Invalid string index");
 			}
-			if ((conv & SLF_ALLOW_NEWLINE) != 0) {
-				settings = settings | SVS_ALLOW_NEWLINE;
+
+			if (GetVarMemType(conv) == SLE_VAR_NULL) return;
+
+			if (index == 0) {
+				str->clear();
+			} else {
+				*str = _sl_chunk.loaded_strings[index - 2];
+				SlValidateString(*str, conv);
 			}
-			*str = StrMakeValid(*str, settings);
+			break;
 		}
 
 		case SLA_PTRS: break;
@@ -1031,10 +1511,10 @@ void SlCopy(void *object, size_t length, VarType conv)
 	if (_sl.action == SLA_PTRS || _sl.action == SLA_NULL) return;
 
 	/* Automatically calculate the length? */
-	if (_sl.need_length != NL_NONE) {
+	if (_sl_chunk.need_length != NL_NONE) {
 		SlSetLength(length * SlCalcConvFileLen(conv));
 		/* Determine length only? */
-		if (_sl.need_length == NL_CALCLENGTH) return;
+		if (_sl_chunk.need_length == NL_CALCLENGTH) return;
 	}
 
 	SlCopyInternal(object, length, conv);
@@ -1338,10 +1818,10 @@ static inline size_t SlCalcRefListLen(const void *list, VarType conv)
 static void SlRefList(void *list, VarType conv)
 {
 	/* Automatically calculate the length? */
-	if (_sl.need_length != NL_NONE) {
+	if (_sl_chunk.need_length != NL_NONE) {
 		SlSetLength(SlCalcRefListLen(list, conv));
 		/* Determine length only? */
-		if (_sl.need_length == NL_CALCLENGTH) return;
+		if (_sl_chunk.need_length == NL_CALCLENGTH) return;
 	}
 
 	SlStorageHelper<std::list, void *>::SlSaveLoad(list, conv, SL_REF);
@@ -1527,26 +2007,26 @@ size_t SlCalcObjMemberLength(const void *object, const SaveLoad &sld)
 		case SL_REFLIST: return SlCalcRefListLen(GetVariableAddress(object, sld), sld.conv);
 		case SL_DEQUE: return SlCalcDequeLen(GetVariableAddress(object, sld), sld.conv);
 		case SL_VECTOR: return SlCalcVectorLen(GetVariableAddress(object, sld), sld.conv);
-		case SL_STDSTR: return SlCalcStdStringLen(GetVariableAddress(object, sld));
+		case SL_STDSTR: return SlCalcInternedStringLen(GetVariableAddress(object, sld));
 		case SL_SAVEBYTE: return 1; // a byte is logically of size 1
 		case SL_NULL: return SlCalcConvFileLen(sld.conv) * sld.length;
 
 		case SL_STRUCT:
 		case SL_STRUCTLIST: {
-			NeedLength old_need_length = _sl.need_length;
-			size_t old_obj_len = _sl.obj_len;
+			NeedLength old_need_length = _sl_chunk.need_length;
+			size_t old_obj_len = _sl_chunk.obj_len;
 
-			_sl.need_length = NL_CALCLENGTH;
-			_sl.obj_len = 0;
+			_sl_chunk.need_length = NL_CALCLENGTH;
+			_sl_chunk.obj_len = 0;
 
 			/* Pretend that we are saving to collect the object size. Other
 			 * means are difficult, as we don't know the length of the list we
 			 * are about to store. */
 			sld.handler->Save(const_cast<void *>(object));
-			size_t length = _sl.obj_len;
+			size_t length = _sl_chunk.obj_len;
 
-			_sl.obj_len = old_obj_len;
-			_sl.need_length = old_need_length;
+			_sl_chunk.obj_len = old_obj_len;
+			_sl_chunk.need_length = old_need_length;
 
 			if (sld.cmd == SL_STRUCT) {
 				length += SlGetArrayLength(1);
@@ -1582,7 +2062,7 @@ static bool SlObjectMember(void *object, const SaveLoad &sld)
 				case SL_REFLIST: SlRefList(ptr, conv); break;
 				case SL_DEQUE: SlDeque(ptr, conv); break;
 				case SL_VECTOR: SlVector(ptr, conv); break;
-				case SL_STDSTR: SlStdString(ptr, sld.conv); break;
+				case SL_STDSTR: SlInternedString(ptr, sld.conv); break;
 				default: NOT_REACHED();
 			}
 			break;
@@ -1668,9 +2148,9 @@ static bool SlObjectMember(void *object, const SaveLoad &sld)
 void SlSetStructListLength(size_t length)
 {
 	/* Automatically calculate the length? */
-	if (_sl.need_length != NL_NONE) {
+	if (_sl_chunk.need_length != NL_NONE) {
 		SlSetLength(SlGetArrayLength(length));
-		if (_sl.need_length == NL_CALCLENGTH) return;
+		if (_sl_chunk.need_length == NL_CALCLENGTH) return;
 	}
 
 	SlWriteArrayLength(length);
@@ -1696,10 +2176,20 @@ size_t SlGetStructListLength(size_t limit)
  */
 void SlObject(void *object, const SaveLoadTable &slt)
 {
+	/* Write the object in a single pass, and fill in the length afterwards. */
+	if (_sl_chunk.need_length == NL_WANTLENGTH && !_sl_chunk.expect_table_header) {
+		size_t pos = SlReserveLength();
+		for (auto &sld : slt) {
+			SlObjectMember(object, sld);
+		}
+		SlWriteReservedLength(pos);
+		return;
+	}
+
 	/* Automatically calculate the length? */
-	if (_sl.need_length != NL_NONE) {
+	if (_sl_chunk.need_length != NL_NONE) {
 		SlSetLength(SlCalcObjLength(object, slt));
-		if (_sl.need_length == NL_CALCLENGTH) return;
+		if (_sl_chunk.need_length == NL_CALCLENGTH) return;
 	}
 
 	for (auto &sld : slt) {
@@ -1750,7 +2240,7 @@ class SlSkipHandler : public SaveLoadHandler {
 std::vector<SaveLoad> SlTableHeader(const SaveLoadTable &slt)
 {
 	/* You can only use SlTableHeader if you are a CH_TABLE. */
-	assert(_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE);
+	assert(_sl_chunk.block_mode == CH_TABLE || _sl_chunk.block_mode == CH_SPARSE_TABLE);
 
 	switch (_sl.action) {
 		case SLA_LOAD_CHECK:
@@ -1828,9 +2318,9 @@ std::vector<SaveLoad> SlTableHeader(const SaveLoadTable &slt)
 
 		case SLA_SAVE: {
 			/* Automatically calculate the length? */
-			if (_sl.need_length != NL_NONE) {
+			if (_sl_chunk.need_length != NL_NONE) {
 				SlSetLength(SlCalcTableHeader(slt));
-				if (_sl.need_length == NL_CALCLENGTH) break;
+				if (_sl_chunk.need_length == NL_CALCLENGTH) break;
 			}
 
 			for (auto &sld : slt) {
@@ -1854,12 +2344,12 @@ std::vector<SaveLoad> SlTableHeader(const SaveLoadTable &slt)
 				if (!SlIsObjectValidInSavegame(sld)) continue;
 				if (sld.cmd == SL_STRUCTLIST || sld.cmd == SL_STRUCT) {
 					/* SlCalcTableHeader already looks in sub-lists, so avoid the length being added twice. */
-					NeedLength old_need_length = _sl.need_length;
-					_sl.need_length = NL_NONE;
+					NeedLength old_need_length = _sl_chunk.need_length;
+					_sl_chunk.need_length = NL_NONE;
 
 					SlTableHeader(sld.handler->GetDescription());
 
-					_sl.need_length = old_need_length;
+					_sl_chunk.need_length = old_need_length;
 				}
 			}
 
@@ -1889,7 +2379,7 @@ std::vector<SaveLoad> SlCompatTableHeader(const SaveLoadTable &slt, const SaveLo
 {
 	assert(_sl.action == SLA_LOAD || _sl.action == SLA_LOAD_CHECK);
 	/* CH_TABLE / CH_SPARSE_TABLE always have a header. */
-	if (_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE) return SlTableHeader(slt);
+	if (_sl_chunk.block_mode == CH_TABLE || _sl_chunk.block_mode == CH_SPARSE_TABLE) return SlTableHeader(slt);
 
 	std::vector<SaveLoad> saveloads;
 
@@ -1945,7 +2435,8 @@ void SlGlobList(const SaveLoadTable &slt)
 }
 
 /**
- * Do something of which I have no idea what it is :P
+ * Save an object of which the length is not known beforehand. The space for the
+ * length is reserved, then the object is written, and then the length is filled in.
  * @param proc The callback procedure that is called
  * @param arg The variable that will be used for the callback procedure
  */
@@ -1953,29 +2444,17 @@ void SlAutolength(AutolengthProc *proc, int arg)
 {
 	assert(_sl.action == SLA_SAVE);
 
-	/* Tell it to calculate the length */
-	_sl.need_length = NL_CALCLENGTH;
-	_sl.obj_len = 0;
-	proc(arg);
-
-	/* Setup length */
-	_sl.need_length = NL_WANTLENGTH;
-	SlSetLength(_sl.obj_len);
+	_sl_chunk.need_length = NL_WANTLENGTH;
+	size_t pos = SlReserveLength();
 
-	size_t start_pos = _sl.dumper->GetSize();
-	size_t expected_offs = start_pos + _sl.obj_len;
-
-	/* And write the stuff */
 	proc(arg);
 
-	if (expected_offs != _sl.dumper->GetSize()) {
-		SlErrorCorruptFmt("Invalid chunk size when writing autolength block, expected {}, got {}", _sl.obj_len, _sl.dumper->GetSize() - start_pos);
-	}
+	SlWriteReservedLength(pos);
 }
 
 void ChunkHandler::LoadCheck(size_t len) const
 {
-	switch (_sl.block_mode) {
+	switch (_sl_chunk.block_mode) {
 		case CH_TABLE:
 		case CH_SPARSE_TABLE:
 			SlTableHeader({});
@@ -1992,28 +2471,65 @@ void ChunkHandler::LoadCheck(size_t len) const
 	}
 }
 
+static SaveLoadProfile *_sl_profile = nullptr; ///< Where to record the time spent saving and loading, if anywhere.
+static std::mutex _sl_profile_mutex; ///< Lock for #_sl_profile, as chunks are saved and loaded by multiple threads.
+
+/**
+ * Set where to record the time spent in the phases of saving and loading.
+ * @param profile The profile to add the time spent to, or \c nullptr to stop recording.
+ */
+void SlSetProfile(SaveLoadProfile *profile)
+{
+	std::lock_guard<std::mutex> lock(_sl_profile_mutex);
+	_sl_profile = profile;
+}
+
+/** Records the time spent on saving or loading a chunk in the profile, if any, until it goes out of scope. */
+class SlChunkTimer {
+	const ChunkHandler &ch; ///< The chunk being saved or loaded.
+	std::chrono::steady_clock::time_point start; ///< When saving or loading the chunk started.
+
+public:
+	SlChunkTimer(const ChunkHandler &ch) : ch(ch), start(std::chrono::steady_clock::now()) {}
+
+	~SlChunkTimer()
+	{
+		std::lock_guard<std::mutex> lock(_sl_profile_mutex);
+		if (_sl_profile != nullptr) _sl_profile->chunks[this->ch.GetName()] += std::chrono::steady_clock::now() - this->start;
+	}
+};
+
+/** Forget the strings of the previous chunk, as repeated strings are only saved once per chunk, see #SlInternedString. */
+static void SlResetInternedStrings()
+{
+	_sl_chunk.saved_strings.clear();
+	_sl_chunk.loaded_strings.clear();
+}
+
 /**
  * Load a chunk of data (eg vehicles, stations, etc.)
  * @param ch The chunkhandler that will be used for the operation
  */
 static void SlLoadChunk(const ChunkHandler &ch)
 {
+	SlChunkTimer timer(ch);
+	SlResetInternedStrings();
 	uint8_t m = SlReadByte();
 
-	_sl.block_mode = m & CH_TYPE_MASK;
-	_sl.obj_len = 0;
-	_sl.expect_table_header = (_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE);
+	_sl_chunk.block_mode = m & CH_TYPE_MASK;
+	_sl_chunk.obj_len = 0;
+	_sl_chunk.expect_table_header = (_sl_chunk.block_mode == CH_TABLE || _sl_chunk.block_mode == CH_SPARSE_TABLE);
 
 	/* The header should always be at the start. Read the length; the
 	 * Load() should as first action process the header. */
-	if (_sl.expect_table_header) {
+	if (_sl_chunk.expect_table_header) {
 		SlIterateArray();
 	}
 
-	switch (_sl.block_mode) {
+	switch (_sl_chunk.block_mode) {
 		case CH_TABLE:
 		case CH_ARRAY:
-			_sl.array_index = 0;
+			_sl_chunk.array_index = 0;
 			ch.Load();
 			if (_next_offs != 0) SlErrorCorrupt("Invalid array length");
 			break;
@@ -2026,13 +2542,13 @@ static void SlLoadChunk(const ChunkHandler &ch)
 			/* Read length */
 			size_t len = (SlReadByte() << 16) | ((m >> 4) << 24);
 			len += SlReadUint16();
-			_sl.obj_len = len;
-			size_t start_pos = _sl.reader->GetSize();
+			_sl_chunk.obj_len = len;
+			size_t start_pos = _sl_chunk.reader->GetSize();
 			size_t endoffs = start_pos + len;
 			ch.Load();
 
-			if (_sl.reader->GetSize() != endoffs) {
-				SlErrorCorruptFmt("Invalid chunk size in RIFF in {} - expected {}, got {}", ch.GetName(), len, _sl.reader->GetSize() - start_pos);
+			if (_sl_chunk.reader->GetSize() != endoffs) {
+				SlErrorCorruptFmt("Invalid chunk size in RIFF in {} - expected {}, got {}", ch.GetName(), len, _sl_chunk.reader->GetSize() - start_pos);
 			}
 			break;
 		}
@@ -2041,7 +2557,7 @@ static void SlLoadChunk(const ChunkHandler &ch)
 			break;
 	}
 
-	if (_sl.expect_table_header) SlErrorCorrupt("Table chunk without header");
+	if (_sl_chunk.expect_table_header) SlErrorCorrupt("Table chunk without header");
 }
 
 /**
@@ -2051,22 +2567,23 @@ static void SlLoadChunk(const ChunkHandler &ch)
  */
 static void SlLoadCheckChunk(const ChunkHandler &ch)
 {
+	SlResetInternedStrings();
 	uint8_t m = SlReadByte();
 
-	_sl.block_mode = m & CH_TYPE_MASK;
-	_sl.obj_len = 0;
-	_sl.expect_table_header = (_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE);
+	_sl_chunk.block_mode = m & CH_TYPE_MASK;
+	_sl_chunk.obj_len = 0;
+	_sl_chunk.expect_table_header = (_sl_chunk.block_mode == CH_TABLE || _sl_chunk.block_mode == CH_SPARSE_TABLE);
 
 	/* The header should always be at the start. Read the length; the
 	 * LoadCheck() should as first action process the header. */
-	if (_sl.expect_table_header) {
+	if (_sl_chunk.expect_table_header) {
 		SlIterateArray();
 	}
 
-	switch (_sl.block_mode) {
+	switch (_sl_chunk.block_mode) {
 		case CH_TABLE:
 		case CH_ARRAY:
-			_sl.array_index = 0;
+			_sl_chunk.array_index = 0;
 			ch.LoadCheck();
 			break;
 		case CH_SPARSE_TABLE:
@@ -2077,13 +2594,13 @@ static void SlLoadCheckChunk(const ChunkHandler &ch)
 			/* Read length */
 			size_t len = (SlReadByte() << 16) | ((m >> 4) << 24);
 			len += SlReadUint16();
-			_sl.obj_len = len;
-			size_t start_pos = _sl.reader->GetSize();
+			_sl_chunk.obj_len = len;
+			size_t start_pos = _sl_chunk.reader->GetSize();
 			size_t endoffs = start_pos + len;
 			ch.LoadCheck(len);
 
-			if (_sl.reader->GetSize() != endoffs) {
-				SlErrorCorruptFmt("Invalid chunk size in RIFF in {} - expected {}, got {}", ch.GetName(), len, _sl.reader->GetSize() - start_pos);
+			if (_sl_chunk.reader->GetSize() != endoffs) {
+				SlErrorCorruptFmt("Invalid chunk size in RIFF in {} - expected {}, got {}", ch.GetName(), len, _sl_chunk.reader->GetSize() - start_pos);
 			}
 			break;
 		}
@@ -2092,7 +2609,7 @@ static void SlLoadCheckChunk(const ChunkHandler &ch)
 			break;
 	}
 
-	if (_sl.expect_table_header) SlErrorCorrupt("Table chunk without header");
+	if (_sl_chunk.expect_table_header) SlErrorCorrupt("Table chunk without header");
 }
 
 /**
@@ -2104,59 +2621,259 @@ static void SlSaveChunk(const ChunkHandler &ch)
 {
 	if (ch.type == CH_READONLY) return;
 
+	SlChunkTimer timer(ch);
+	SlResetInternedStrings();
 	SlWriteUint32(ch.id);
-	Debug(sl, 2, "Saving chunk {}", ch.GetName());
+	/* Debug output takes locks another thread of the parent may have held when forking. */
+	if (!_sl.forked_child) Debug(sl, 2, "Saving chunk {}", ch.GetName());
 
-	_sl.block_mode = ch.type;
-	_sl.expect_table_header = (_sl.block_mode == CH_TABLE || _sl.block_mode == CH_SPARSE_TABLE);
+	_sl_chunk.block_mode = ch.type;
+	_sl_chunk.object_parent = nullptr;
+	_sl_chunk.expect_table_header = (_sl_chunk.block_mode == CH_TABLE || _sl_chunk.block_mode == CH_SPARSE_TABLE);
 
-	_sl.need_length = (_sl.expect_table_header || _sl.block_mode == CH_RIFF) ? NL_WANTLENGTH : NL_NONE;
+	_sl_chunk.need_length = (_sl_chunk.expect_table_header || _sl_chunk.block_mode == CH_RIFF) ? NL_WANTLENGTH : NL_NONE;
 
-	switch (_sl.block_mode) {
+	switch (_sl_chunk.block_mode) {
 		case CH_RIFF:
 			ch.Save();
 			break;
 		case CH_TABLE:
 		case CH_ARRAY:
-			_sl.last_array_index = 0;
-			SlWriteByte(_sl.block_mode);
+			_sl_chunk.last_array_index = 0;
+			SlWriteByte(_sl_chunk.block_mode);
 			ch.Save();
 			SlWriteArrayLength(0); // Terminate arrays
 			break;
 		case CH_SPARSE_TABLE:
 		case CH_SPARSE_ARRAY:
-			SlWriteByte(_sl.block_mode);
+			SlWriteByte(_sl_chunk.block_mode);
 			ch.Save();
 			SlWriteArrayLength(0); // Terminate arrays
 			break;
 		default: NOT_REACHED();
 	}
 
-	if (_sl.expect_table_header) SlErrorCorrupt("Table chunk without header");
+	if (_sl_chunk.expect_table_header) SlErrorCorrupt("Table chunk without header");
 }
 
 /** Save all chunks */
 static void SlSaveChunks()
 {
-	for (auto &ch : ChunkHandlers()) {
-		SlSaveChunk(ch);
+	const std::vector<ChunkHandlerRef> &handlers = ChunkHandlers();
+
+	/* Every chunk is saved into its own dumper first, so the chunks that can be saved in
+	 * parallel can be saved by other threads, while this thread saves the other chunks.
+	 * The chunks are written to the savegame in order, as soon as they have been saved. */
+	std::vector<MemoryDumper> dumpers(handlers.size());
+	std::vector<size_t> parallel;
+	for (size_t i = 0; i < handlers.size(); i++) {
+		if (handlers[i].get().CanSaveInParallel()) parallel.push_back(i);
 	}
 
-	/* Terminator */
-	SlWriteUint32(0);
-}
+	std::vector<std::exception_ptr> errors(handlers.size());
+	std::vector<std::atomic<bool>> saved(handlers.size());
+	auto save_chunk = [&handlers, &dumpers, &errors, &saved](size_t i) {
+		_sl_chunk.dumper = &dumpers[i];
+		try {
+			SlSaveChunk(handlers[i]);
+		} catch (...) {
+			errors[i] = std::current_exception();
+		}
+		saved[i] = true;
+	};
 
-/**
- * Find the ChunkHandler that will be used for processing the found
- * chunk in the savegame or in memory
- * @param id the chunk in question
- * @return returns the appropriate chunkhandler
- */
-static const ChunkHandler *SlFindChunkHandler(uint32_t id)
-{
-	for (const ChunkHandler &ch : ChunkHandlers()) if (ch.id == id) return &ch;
-	return nullptr;
-}
+	std::thread thread;
+	auto save_parallel = [&parallel, &save_chunk]() {
+		RunInParallel("ottd:slchunk", parallel.size(), [&parallel, &save_chunk](size_t i) { save_chunk(parallel[i]); });
+	};
+	bool threaded = !parallel.empty() && !_sl.forked_child && StartNewThread(&thread, "ottd:slchunk", [&save_parallel]() { save_parallel(); });
+
+	if (_sl.chunk_hashes != nullptr) _sl.chunk_hashes->resize(handlers.size());
+
+	/* Saving only reads the game state, so drawing may happen in between chunks, and while waiting for the other threads or for the savegame thread.
+	 * Not in the forked child, which has no draw thread to hand the game-state lock to. */
+	VideoDriver *driver = _sl.forked_child ? nullptr : VideoDriver::GetInstance();
+
+	MemoryDumper *dumper = _sl_chunk.dumper;
+	size_t written = 0;
+	auto write_chunks = [&handlers, &dumpers, &errors, &saved, &written, dumper, driver]() {
+		_sl_chunk.dumper = dumper;
+
+		for (; written < handlers.size() && saved[written] && errors[written] == nullptr; written++) {
+			if (_sl.chunk_hashes != nullptr) {
+				uint64_t hash = dumpers[written].GetHash();
+
+				if (_sl.journal_segment) {
+					if (dumpers[written].GetSize() == 0 || hash == (*_sl.chunk_hashes)[written]) {
+						dumpers[written] = {};
+						continue;
+					}
+
+					/* Journal segments are only read as a whole, so the chunks are preceded by their length. */
+					assert(dumpers[written].GetSize() <= UINT32_MAX);
+					SlWriteUint32(static_cast<uint32_t>(dumpers[written].GetSize()));
+					_sl.stream->Write(*dumper, driver);
+				}
+
+				(*_sl.chunk_hashes)[written] = hash;
+			}
+
+			_sl.stream->Write(dumpers[written], driver);
+		}
+	};
+
+	try {
+		for (size_t i = 0; i < handlers.size(); i++) {
+			if (threaded && handlers[i].get().CanSaveInParallel()) continue;
+
+			if (driver != nullptr) driver->GameLoopDrawPoint();
+			save_chunk(i);
+			write_chunks();
+		}
+
+		while (threaded && driver != nullptr && !std::ranges::all_of(parallel, [&saved](size_t i) { return saved[i].load(); })) {
+			driver->GameLoopDrawPoint();
+			write_chunks();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	} catch (...) {
+		if (thread.joinable()) thread.join();
+		_sl_chunk.dumper = dumper;
+		throw;
+	}
+	if (thread.joinable()) thread.join();
+	_sl_chunk.dumper = dumper;
+
+	for (size_t i = 0; i < handlers.size(); i++) {
+		if (errors[i] != nullptr) std::rethrow_exception(errors[i]);
+	}
+
+	write_chunks();
+
+	/* Terminator */
+	SlWriteUint32(0);
+	_sl.stream->Write(*dumper, driver);
+}
+
+/**
+ * Find the ChunkHandler that will be used for processing the found
+ * chunk in the savegame or in memory
+ * @param id the chunk in question
+ * @return returns the appropriate chunkhandler
+ */
+static const ChunkHandler *SlFindChunkHandler(uint32_t id)
+{
+	for (const ChunkHandler &ch : ChunkHandlers()) if (ch.id == id) return &ch;
+	return nullptr;
+}
+
+/** Filter reading a chunk that has been read into memory. */
+struct MemoryLoadFilter : LoadFilter {
+	std::vector<uint8_t> data; ///< The contents of the chunk.
+	size_t pos = 0;            ///< Position in the contents we are at.
+
+	/**
+	 * Initialise this filter.
+	 * @param data The contents of the chunk.
+	 */
+	MemoryLoadFilter(std::vector<uint8_t> &&data) : LoadFilter(nullptr), data(std::move(data))
+	{
+	}
+
+	size_t Read(uint8_t *buf, size_t size) override
+	{
+		size_t len = std::min(size, this->data.size() - this->pos);
+		std::copy_n(this->data.data() + this->pos, len, buf);
+		this->pos += len;
+		return len;
+	}
+
+	void Reset() override
+	{
+		this->pos = 0;
+	}
+
+	std::span<const uint8_t> TakeRemainder() override
+	{
+		std::span<const uint8_t> remainder(this->data.data() + this->pos, this->data.size() - this->pos);
+		this->pos = this->data.size();
+		return remainder;
+	}
+};
+
+/**
+ * Load a RIFF chunk that has been read into memory. This is done by a helper
+ * thread, while the thread doing the loading reads the next chunks.
+ * @param ch   The chunkhandler that will be used for the operation.
+ * @param data The contents of the chunk.
+ */
+static void SlLoadChunkFromMemory(const ChunkHandler &ch, std::vector<uint8_t> &&data)
+{
+	SlChunkTimer timer(ch);
+	SlResetInternedStrings();
+	size_t len = data.size();
+	auto reader = std::make_unique<ReadBuffer>(std::make_shared<MemoryLoadFilter>(std::move(data)));
+
+	_sl_chunk.defer_cleanup = true;
+	_sl_chunk.reader = reader.get();
+	_sl_chunk.block_mode = CH_RIFF;
+	_sl_chunk.obj_len = len;
+	_sl_chunk.expect_table_header = false;
+	ch.Load();
+
+	if (reader->GetSize() != len) {
+		SlErrorCorruptFmt("Invalid chunk size in RIFF in {} - expected {}, got {}", ch.GetName(), len, reader->GetSize());
+	}
+}
+
+/** Skip a chunk, i.e. everything after its identifier, without loading it. */
+static void SlSkipChunk()
+{
+	uint8_t m = SlReadByte();
+
+	_sl_chunk.block_mode = m & CH_TYPE_MASK;
+	_sl_chunk.expect_table_header = (_sl_chunk.block_mode == CH_TABLE || _sl_chunk.block_mode == CH_SPARSE_TABLE);
+
+	switch (_sl_chunk.block_mode) {
+		case CH_TABLE:
+		case CH_ARRAY:
+		case CH_SPARSE_TABLE:
+		case CH_SPARSE_ARRAY:
+			SlSkipArray();
+			break;
+		case CH_RIFF: {
+			/* Read length */
+			size_t len = (SlReadByte() << 16) | ((m >> 4) << 24);
+			len += SlReadUint16();
+			SlSkipBytes(len);
+			break;
+		}
+		default:
+			SlErrorCorrupt("Invalid chunk type");
+			break;
+	}
+}
+
+/**
+ * Load a chunk from the journal of incremental autosaves instead of from the
+ * savegame, which contains an older version of the chunk.
+ * @param ch   The chunkhandler that will be used for the operation.
+ * @param data The contents of the chunk in the journal.
+ * @param load The function to load the chunk with.
+ */
+static void SlLoadJournalChunk(const ChunkHandler &ch, std::vector<uint8_t> &&data, void (*load)(const ChunkHandler &))
+{
+	Debug(sl, 2, "Loading chunk {} from journal", ch.GetName());
+	SlSkipChunk();
+
+	size_t len = data.size();
+	auto reader = std::make_unique<ReadBuffer>(std::make_shared<MemoryLoadFilter>(std::move(data)));
+	ReadBuffer *savegame_reader = std::exchange(_sl_chunk.reader, reader.get());
+	load(ch);
+
+	if (reader->GetSize() != len) SlErrorCorruptFmt("Invalid chunk size in journal in {} - expected {}, got {}", ch.GetName(), len, reader->GetSize());
+	_sl_chunk.reader = savegame_reader;
+}
 
 /** Load all chunks */
 static void SlLoadChunks()
@@ -2164,12 +2881,83 @@ static void SlLoadChunks()
 	uint32_t id;
 	const ChunkHandler *ch;
 
-	for (id = SlReadUint32(); id != 0; id = SlReadUint32()) {
-		Debug(sl, 2, "Loading chunk {:c}{:c}{:c}{:c}", id >> 24, id >> 16, id >> 8, id);
+	/* Chunks that can be loaded in parallel are read into memory, and loaded by
+	 * helper threads while the next chunks are read. All of them must have been
+	 * loaded before a chunk that cannot be loaded in parallel is loaded. While
+	 * they are being loaded, cleaning up after errors has to wait for them. */
+	struct ParallelLoad {
+		const ChunkHandler *ch;     ///< The chunkhandler loading the chunk.
+		std::thread thread;         ///< The thread loading the chunk.
+		std::vector<uint8_t> data;  ///< The contents of the chunk.
+		std::exception_ptr error;   ///< The error that occurred while loading the chunk.
+	};
+	std::deque<ParallelLoad> loads;
+	auto join = [&loads]() {
+		for (ParallelLoad &load : loads) {
+			if (load.thread.joinable()) load.thread.join();
+		}
+		_sl_chunk.defer_cleanup = false;
+		for (ParallelLoad &load : loads) {
+			if (load.error != nullptr) SlCleanUpAndRethrow(load.error);
+		}
+		for (ParallelLoad &load : loads) load.ch->FinishParallelLoad();
+		loads.clear();
+	};
 
-		ch = SlFindChunkHandler(id);
-		if (ch == nullptr) SlErrorCorrupt("Unknown chunk type");
-		SlLoadChunk(*ch);
+	try {
+		for (id = SlReadUint32(); id != 0; id = SlReadUint32()) {
+			Debug(sl, 2, "Loading chunk {:c}{:c}{:c}{:c}", id >> 24, id >> 16, id >> 8, id);
+
+			ch = SlFindChunkHandler(id);
+			if (ch == nullptr) SlErrorCorrupt("Unknown chunk type");
+
+			if (auto it = _sl.journal.find(id); it != _sl.journal.end()) {
+				join();
+				SlLoadJournalChunk(*ch, std::move(it->second), SlLoadChunk);
+				if (ch->CanLoadInParallel()) ch->FinishParallelLoad();
+				continue;
+			}
+
+			if (!ch->CanLoadInParallel()) {
+				join();
+				SlLoadChunk(*ch);
+				continue;
+			}
+
+			uint8_t m = SlReadByte();
+			if ((m & CH_TYPE_MASK) != CH_RIFF) SlErrorCorrupt("Invalid chunk type");
+
+			/* Read length */
+			size_t len = (SlReadByte() << 16) | ((m >> 4) << 24);
+			len += SlReadUint16();
+
+			ParallelLoad &load = loads.emplace_back();
+			load.ch = ch;
+			load.data.resize(len);
+			_sl_chunk.reader->Read(load.data.data(), len);
+			_sl_chunk.defer_cleanup = true;
+
+			auto load_chunk = [ch, &load]() {
+				try {
+					SlLoadChunkFromMemory(*ch, std::move(load.data));
+				} catch (...) {
+					load.error = std::current_exception();
+				}
+			};
+			if (!StartNewThread(&load.thread, "ottd:slchunk", [load_chunk]() { load_chunk(); })) {
+				/* Load it on this thread instead; that replaces the chunk state, while the savegame still has to be read afterwards. */
+				SaveLoadChunkParams savegame_chunk = _sl_chunk;
+				load_chunk();
+				_sl_chunk = std::move(savegame_chunk);
+			}
+		}
+		join();
+	} catch (...) {
+		for (ParallelLoad &load : loads) {
+			if (load.thread.joinable()) load.thread.join();
+		}
+		_sl_chunk.defer_cleanup = false;
+		SlCleanUpAndRethrow(std::current_exception());
 	}
 }
 
@@ -2184,13 +2972,19 @@ static void SlLoadCheckChunks()
 
 		ch = SlFindChunkHandler(id);
 		if (ch == nullptr) SlErrorCorrupt("Unknown chunk type");
-		SlLoadCheckChunk(*ch);
+
+		if (auto it = _sl.journal.find(id); it != _sl.journal.end()) {
+			SlLoadJournalChunk(*ch, std::move(it->second), SlLoadCheckChunk);
+		} else {
+			SlLoadCheckChunk(*ch);
+		}
 	}
 }
 
 /** Fix all pointers (convert index -> pointer) */
 static void SlFixPointers()
 {
+	auto start = std::chrono::steady_clock::now();
 	_sl.action = SLA_PTRS;
 
 	for (const ChunkHandler &ch : ChunkHandlers()) {
@@ -2199,6 +2993,8 @@ static void SlFixPointers()
 	}
 
 	assert(_sl.action == SLA_PTRS);
+
+	if (_sl_profile != nullptr) _sl_profile->fix_pointers += std::chrono::steady_clock::now() - start;
 }
 
 
@@ -2206,6 +3002,7 @@ static void SlFixPointers()
 struct FileReader : LoadFilter {
 	std::optional<FileHandle> file; ///< The file to read from.
 	long begin; ///< The begin of the file.
+	std::span<const uint8_t> mapping; ///< The file mapped into memory, if it is.
 
 	/**
 	 * Create the file reader, so it reads from a specific file.
@@ -2221,6 +3018,9 @@ struct FileReader : LoadFilter {
 		if (this->file.has_value()) {
 			_game_session_stats.savegame_size = ftell(*this->file) - this->begin;
 		}
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+		if (!this->mapping.empty()) munmap(const_cast<uint8_t *>(this->mapping.data()), this->mapping.size());
+#endif
 	}
 
 	size_t Read(uint8_t *buf, size_t size) override
@@ -2238,6 +3038,30 @@ struct FileReader : LoadFilter {
 			Debug(sl, 1, "Could not reset the file reading");
 		}
 	}
+
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+	std::span<const uint8_t> TakeRemainder() override
+	{
+		if (!this->file.has_value()) return {};
+
+		int fd = fileno(*this->file);
+		long pos = ftell(*this->file);
+		struct stat st;
+		if (pos < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= pos) return {};
+
+		void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED) {
+			Debug(sl, 1, "Could not map the savegame into memory, reading it instead");
+			return {};
+		}
+		madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+		this->mapping = std::span<const uint8_t>(static_cast<const uint8_t *>(mapping), st.st_size);
+
+		/* Everything is read from the mapping from now on. */
+		fseek(*this->file, 0, SEEK_END);
+		return this->mapping.subspan(pos);
+	}
+#endif
 };
 
 /** Yes, simply writing to a file. */
@@ -2275,6 +3099,112 @@ struct FileWriter : SaveFilter {
 	}
 };
 
+/**
+ * Filter that reads (and decompresses) the savegame on a helper thread, so
+ * that is done while the chunks that have already been read are loaded.
+ */
+struct ReadAheadLoadFilter : LoadFilter {
+	static const size_t MAX_BLOCKS = 16; ///< Maximum number of blocks that are read ahead.
+
+	std::thread thread;                       ///< The thread reading ahead.
+	std::mutex mutex;                         ///< Mutex protecting the blocks and the state of the reading.
+	std::condition_variable cv;               ///< Signalled when a block is added or taken.
+	std::deque<std::vector<uint8_t>> blocks;  ///< Blocks that have been read ahead.
+	bool finished = false;                    ///< Whether the reading ahead reached the end of the stream.
+	bool stop = false;                        ///< Whether the reading ahead should stop.
+	std::exception_ptr error;                 ///< The error that occurred while reading ahead.
+
+	std::vector<uint8_t> block; ///< The block we are reading from.
+	size_t pos = 0;             ///< Position in the block we are at.
+
+	/**
+	 * Initialise this filter, and start reading ahead.
+	 * @param chain The next filter in this chain.
+	 */
+	ReadAheadLoadFilter(std::shared_ptr<LoadFilter> chain) : LoadFilter(chain)
+	{
+		if (!StartNewThread(&this->thread, "ottd:slread", [this]() { this->ReadAhead(); })) {
+			Debug(sl, 1, "Could not start read ahead thread, reading without it");
+		}
+	}
+
+	/** Stop reading ahead. */
+	~ReadAheadLoadFilter()
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->stop = true;
+		}
+		this->cv.notify_all();
+		if (this->thread.joinable()) this->thread.join();
+	}
+
+	/** Read the stream into blocks, until the end of the stream or until stopped. */
+	void ReadAhead()
+	{
+		_sl_chunk.defer_cleanup = true;
+
+		try {
+			for (;;) {
+				std::vector<uint8_t> block(MEMORY_CHUNK_SIZE);
+				block.resize(this->chain->Read(block.data(), block.size()));
+
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->cv.wait(lock, [this]() { return this->blocks.size() < MAX_BLOCKS || this->stop; });
+				if (this->stop) return;
+
+				if (block.empty()) {
+					this->finished = true;
+				} else {
+					this->blocks.push_back(std::move(block));
+				}
+				this->cv.notify_all();
+				if (this->finished) return;
+			}
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->error = std::current_exception();
+			this->finished = true;
+			this->cv.notify_all();
+		}
+	}
+
+	size_t Read(uint8_t *buf, size_t size) override
+	{
+		if (!this->thread.joinable()) return this->chain->Read(buf, size);
+
+		size_t read = 0;
+		while (read < size) {
+			if (this->pos == this->block.size()) {
+				std::unique_lock<std::mutex> lock(this->mutex);
+				this->cv.wait(lock, [this]() { return !this->blocks.empty() || this->finished; });
+				if (this->blocks.empty()) {
+					if (this->error != nullptr) SlCleanUpAndRethrow(this->error);
+					break;
+				}
+
+				this->block = std::move(this->blocks.front());
+				this->blocks.pop_front();
+				this->pos = 0;
+				this->cv.notify_all();
+			}
+
+			size_t len = std::min(size - read, this->block.size() - this->pos);
+			std::copy_n(this->block.data() + this->pos, len, buf + read);
+			read += len;
+			this->pos += len;
+		}
+
+		return read;
+	}
+
+	void Reset() override
+	{
+		/* This filter is only added once the format of the savegame is known, after which it is never reset. */
+		NOT_REACHED();
+	}
+};
+
 /*******************************************
  ********** START OF LZO CODE **************
  *******************************************/
@@ -2386,6 +3316,11 @@ struct NoCompLoadFilter : LoadFilter {
 	{
 		return this->chain->Read(buf, size);
 	}
+
+	std::span<const uint8_t> TakeRemainder() override
+	{
+		return this->chain->TakeRemainder();
+	}
 };
 
 /** Filter without any compression. */
@@ -2637,12 +3572,221 @@ struct LZMASaveFilter : SaveFilter {
 
 	void Finish() override
 	{
-		this->WriteLoop(nullptr, 0, LZMA_FINISH);
+		this->WriteLoop(nullptr, 0, LZMA_FINISH);
+		this->chain->Finish();
+	}
+};
+
+#endif /* WITH_LIBLZMA */
+
+/********************************************
+ ********** START OF ZSTD CODE **************
+ ********************************************/
+
+#if defined(WITH_ZSTD)
+#include <zstd.h>
+
+/**
+ * Size of the blocks the savegame is split into. Each block is compressed
+ * into an independent frame, so the blocks can be (de)compressed in parallel.
+ */
+static const size_t ZSTD_BLOCK_SIZE = 1024 * 1024;
+
+/** Number of blocks to (de)compress at the same time. */
+static size_t GetZSTDBatchSize()
+{
+	return std::max(1U, std::thread::hardware_concurrency());
+}
+
+/**
+ * Filter using Zstandard compression.
+ * The stream consists of frames, each preceded by its compressed size as big endian
+ * 32 bits integer. The stream is terminated by a frame size of 0.
+ */
+struct ZSTDLoadFilter : LoadFilter {
+	std::vector<std::vector<uint8_t>> blocks; ///< The decompressed blocks of the current batch.
+	size_t block = 0;                         ///< The block of the current batch we are reading from.
+	size_t pos = 0;                           ///< The position in the block we are reading from.
+	bool finished = false;                    ///< Whether the end of the stream has been read.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain The next filter in this chain.
+	 */
+	ZSTDLoadFilter(std::shared_ptr<LoadFilter> chain) : LoadFilter(chain)
+	{
+	}
+
+	/**
+	 * Read exactly the given number of bytes from the chain.
+	 * @param buf  The buffer to read into.
+	 * @param size The number of bytes to read.
+	 */
+	void ReadFromChain(uint8_t *buf, size_t size)
+	{
+		while (size > 0) {
+			size_t len = this->chain->Read(buf, size);
+			if (len == 0) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "unexpected end of zstd stream");
+			buf += len;
+			size -= len;
+		}
+	}
+
+	/**
+	 * Read the next batch of frames, and decompress them in parallel.
+	 * @return True iff any data has been decompressed.
+	 */
+	bool ReadBatch()
+	{
+		std::vector<std::vector<uint8_t>> frames;
+		size_t batch_size = GetZSTDBatchSize();
+		while (!this->finished && frames.size() < batch_size) {
+			uint8_t header[4];
+			this->ReadFromChain(header, sizeof(header));
+
+			uint32_t frame_size = static_cast<uint32_t>(header[0]) << 24 | header[1] << 16 | header[2] << 8 | header[3];
+			if (frame_size == 0) {
+				this->finished = true;
+				break;
+			}
+			if (frame_size > ZSTD_compressBound(ZSTD_BLOCK_SIZE)) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "zstd frame too large");
+
+			std::vector<uint8_t> &frame = frames.emplace_back(frame_size);
+			this->ReadFromChain(frame.data(), frame_size);
+		}
+
+		this->blocks.clear();
+		this->blocks.resize(frames.size());
+		std::vector<uint8_t> valid(frames.size(), false);
+
+		RunInParallel("ottd:zstd", frames.size(), [this, &frames, &valid](size_t i) {
+			unsigned long long size = ZSTD_getFrameContentSize(frames[i].data(), frames[i].size());
+			if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR || size > ZSTD_BLOCK_SIZE) return;
+
+			std::vector<uint8_t> &block = this->blocks[i];
+			block.resize(size);
+			size_t r = ZSTD_decompress(block.data(), block.size(), frames[i].data(), frames[i].size());
+			valid[i] = !ZSTD_isError(r) && r == size;
+		});
+
+		if (std::find(valid.begin(), valid.end(), false) != valid.end()) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "ZSTD_decompress() failed");
+
+		this->block = 0;
+		this->pos = 0;
+		return !this->blocks.empty();
+	}
+
+	size_t Read(uint8_t *buf, size_t size) override
+	{
+		size_t read = 0;
+		while (read < size) {
+			if (this->block == this->blocks.size() && !this->ReadBatch()) break;
+
+			const std::vector<uint8_t> &data = this->blocks[this->block];
+			size_t len = std::min(size - read, data.size() - this->pos);
+			std::copy_n(data.data() + this->pos, len, buf + read);
+			read += len;
+			this->pos += len;
+
+			if (this->pos == data.size()) {
+				this->block++;
+				this->pos = 0;
+			}
+		}
+
+		return read;
+	}
+
+	void Reset() override
+	{
+		this->blocks.clear();
+		this->block = 0;
+		this->pos = 0;
+		this->finished = false;
+		this->chain->Reset();
+	}
+};
+
+/**
+ * Filter using Zstandard compression.
+ * @see ZSTDLoadFilter for the format of the stream.
+ */
+struct ZSTDSaveFilter : SaveFilter {
+	int compression_level; ///< The requested level of compression.
+	std::vector<std::vector<uint8_t>> blocks; ///< The blocks that still need to be compressed.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain             The next filter in this chain.
+	 * @param compression_level The requested level of compression.
+	 */
+	ZSTDSaveFilter(std::shared_ptr<SaveFilter> chain, uint8_t compression_level) : SaveFilter(chain), compression_level(compression_level)
+	{
+	}
+
+	/**
+	 * Write a frame size to the chain.
+	 * @param frame_size The size of the frame.
+	 */
+	void WriteFrameSize(uint32_t frame_size)
+	{
+		uint8_t header[4] = { static_cast<uint8_t>(GB(frame_size, 24, 8)), static_cast<uint8_t>(GB(frame_size, 16, 8)), static_cast<uint8_t>(GB(frame_size, 8, 8)), static_cast<uint8_t>(GB(frame_size, 0, 8)) };
+		this->chain->Write(header, sizeof(header));
+	}
+
+	/** Compress all pending blocks in parallel, and write the frames to the chain. */
+	void CompressBlocks()
+	{
+		std::vector<std::vector<uint8_t>> frames(this->blocks.size());
+		std::vector<uint8_t> valid(this->blocks.size(), false);
+
+		RunInParallel("ottd:zstd", this->blocks.size(), [this, &frames, &valid](size_t i) {
+			const std::vector<uint8_t> &block = this->blocks[i];
+			std::vector<uint8_t> &frame = frames[i];
+			frame.resize(ZSTD_compressBound(block.size()));
+
+			size_t r = ZSTD_compress(frame.data(), frame.size(), block.data(), block.size(), this->compression_level);
+			if (ZSTD_isError(r)) return;
+
+			frame.resize(r);
+			valid[i] = true;
+		});
+
+		if (std::find(valid.begin(), valid.end(), false) != valid.end()) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "ZSTD_compress() failed");
+
+		for (std::vector<uint8_t> &frame : frames) {
+			this->WriteFrameSize(static_cast<uint32_t>(frame.size()));
+			this->chain->Write(frame.data(), frame.size());
+		}
+
+		this->blocks.clear();
+	}
+
+	void Write(uint8_t *buf, size_t size) override
+	{
+		while (size > 0) {
+			if (this->blocks.empty() || this->blocks.back().size() == ZSTD_BLOCK_SIZE) {
+				if (this->blocks.size() == GetZSTDBatchSize()) this->CompressBlocks();
+				this->blocks.emplace_back().reserve(ZSTD_BLOCK_SIZE);
+			}
+
+			std::vector<uint8_t> &block = this->blocks.back();
+			size_t len = std::min(size, ZSTD_BLOCK_SIZE - block.size());
+			block.insert(block.end(), buf, buf + len);
+			buf += len;
+			size -= len;
+		}
+	}
+
+	void Finish() override
+	{
+		this->CompressBlocks();
+		this->WriteFrameSize(0);
 		this->chain->Finish();
 	}
 };
 
-#endif /* WITH_LIBLZMA */
+#endif /* WITH_ZSTD */
 
 /*******************************************
  ************* END OF CODE *****************
@@ -2665,6 +3809,8 @@ static const uint32_t SAVEGAME_TAG_LZO = TO_BE32X('OTTD');
 static const uint32_t SAVEGAME_TAG_NONE = TO_BE32X('OTTN');
 static const uint32_t SAVEGAME_TAG_ZLIB = TO_BE32X('OTTZ');
 static const uint32_t SAVEGAME_TAG_LZMA = TO_BE32X('OTTX');
+static const uint32_t SAVEGAME_TAG_ZSTD = TO_BE32X('OTTS');
+static const uint32_t SAVEGAME_TAG_RAW  = TO_BE32X('OTTR');
 
 /** The different saveload formats known/understood by OpenTTD. */
 static const SaveLoadFormat _saveload_formats[] = {
@@ -2674,6 +3820,9 @@ static const SaveLoadFormat _saveload_formats[] = {
 #else
 	{"lzo",  SAVEGAME_TAG_LZO,  nullptr,                            nullptr,                            0, 0, 0},
 #endif
+	/* Uncompressed, with the map stored as it is in memory. Only for local use, e.g. quickly restarting a server, as it
+	 * can only be loaded by builds with the same byte order. It comes before "none", so it is never the default. */
+	{"raw",  SAVEGAME_TAG_RAW,  CreateLoadFilter<NoCompLoadFilter>, CreateSaveFilter<NoCompSaveFilter>, 0, 0, 0},
 	/* Roughly 5 times larger at only 1% of the CPU usage over zlib level 6. */
 	{"none", SAVEGAME_TAG_NONE, CreateLoadFilter<NoCompLoadFilter>, CreateSaveFilter<NoCompSaveFilter>, 0, 0, 0},
 #if defined(WITH_ZLIB)
@@ -2684,6 +3833,14 @@ static const SaveLoadFormat _saveload_formats[] = {
 #else
 	{"zlib", SAVEGAME_TAG_ZLIB, nullptr,                            nullptr,                            0, 0, 0},
 #endif
+#if defined(WITH_ZSTD)
+	/* The savegame is split into blocks that are compressed into independent frames, so all cores can be used to
+	 * compress and decompress the savegame. Level 3 is several times faster than lzma level 2 with a single thread,
+	 * at the cost of savegames that are roughly 10% larger. Up to level 19 is possible, but at a steep cost in speed. */
+	{"zstd", SAVEGAME_TAG_ZSTD, CreateLoadFilter<ZSTDLoadFilter>,   CreateSaveFilter<ZSTDSaveFilter>,   1, 3, 19},
+#else
+	{"zstd", SAVEGAME_TAG_ZSTD, nullptr,                            nullptr,                            0, 0, 0},
+#endif
 #if defined(WITH_LIBLZMA)
 	/* Level 2 compression is speed wise as fast as zlib level 6 compression (old default), but results in ~10% smaller saves.
 	 * Higher compression levels are possible, and might improve savegame size by up to 25%, but are also up to 10 times slower.
@@ -2742,6 +3899,36 @@ static std::pair<const SaveLoadFormat &, uint8_t> GetSavegameFormat(const std::s
 	return {def, def.default_compression};
 }
 
+/**
+ * Set the format the game is saved in by the next save.
+ * @param full_name Name of the savegame format, see #GetSavegameFormat.
+ * @param portable Whether the savegame has to be loadable by other builds, e.g. when sending it to network clients.
+ */
+static void SlSetSaveFormat(const std::string &full_name, bool portable)
+{
+	auto [fmt, compression] = GetSavegameFormat(full_name);
+
+	/* Raw snapshots can only be loaded by builds with the same byte order, so fall back to the default format. */
+	if (portable && fmt.tag == SAVEGAME_TAG_RAW) return SlSetSaveFormat({}, false);
+
+	_sl.save_format = &fmt;
+	_sl.save_compression = compression;
+	_sl.raw_snapshot = fmt.tag == SAVEGAME_TAG_RAW;
+}
+
+/**
+ * Get the names of the savegame formats that games can be saved in with this build.
+ * @return The names, to be used in #_savegame_format.
+ */
+std::vector<std::string> GetSavegameFormatNames()
+{
+	std::vector<std::string> names;
+	for (const auto &slf : _saveload_formats) {
+		if (slf.init_write != nullptr) names.emplace_back(slf.name);
+	}
+	return names;
+}
+
 /* actual loader/saver function */
 void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settings);
 extern bool AfterLoadGame();
@@ -2763,9 +3950,15 @@ static void ResetSaveloadData()
 static inline void ClearSaveLoadState()
 {
 	_sl.dumper = nullptr;
+	_sl_chunk.dumper = nullptr;
+	_sl.stream = nullptr;
 	_sl.sf = nullptr;
 	_sl.reader = nullptr;
+	_sl_chunk.reader = nullptr;
 	_sl.lf = nullptr;
+	_sl.journal.clear();
+	_sl.chunk_hashes = nullptr;
+	_sl.journal_segment = false;
 }
 
 /** Update the gui accordingly when starting saving and set locks on saveload. */
@@ -2817,45 +4010,309 @@ static void SaveFileError()
 }
 
 /**
- * We have written the whole game into memory, _memory_savegame, now find
- * and appropriate compressor and start writing to file.
+ * Find the appropriate compressor and write the savegame to the savegame filter.
+ * @param threaded Whether the chunks are saved by another thread, and only have to be written here.
+ * @return False iff saving the chunks failed in the other thread, which then handles the error.
  */
-static SaveOrLoadResult SaveFileToDisk(bool threaded)
+static bool WriteSavegame(bool threaded)
 {
-	try {
-		auto [fmt, compression] = GetSavegameFormat(_savegame_format);
+	const SaveLoadFormat &fmt = *_sl.save_format;
 
-		/* We have written our stuff to memory, now write it to file! */
-		uint32_t hdr[2] = { fmt.tag, TO_BE32(SAVEGAME_VERSION << 16) };
-		_sl.sf->Write((uint8_t*)hdr, sizeof(hdr));
+	uint32_t hdr[2] = { fmt.tag, TO_BE32(SAVEGAME_VERSION << 16) };
+	_sl.sf->Write((uint8_t*)hdr, sizeof(hdr));
 
-		_sl.sf = fmt.init_write(_sl.sf, compression);
-		_sl.dumper->Flush(_sl.sf);
+	_sl.sf = fmt.init_write(_sl.sf, _sl.save_compression);
+	if (threaded) {
+		if (!_sl.stream->Drain(*_sl.sf)) return false;
+	} else {
+		_sl.stream->WriteDirectly(_sl.sf);
+		SlSaveChunks();
+	}
+	_sl.sf->Finish();
+	return true;
+}
 
-		ClearSaveLoadState();
+/*
+ * Incremental autosaves write a full autosave every now and then. The autosaves
+ * in between only append a segment with the chunks that changed since the last
+ * autosave to the journal of the full autosave, a file next to it. A segment is
+ * a savegame of its own, only the chunks in it are preceded by their length.
+ * When loading a savegame with a journal, the latest version of every chunk in
+ * the journal is loaded instead of the version in the savegame.
+ */
 
-		if (threaded) SetAsyncSaveFinish(SaveFileDone);
+static const std::string SAVE_JOURNAL_EXTENSION = ".journal"; ///< Extension of the journal, after the name of the savegame.
+static const size_t SAVE_JOURNAL_HASH_BLOCK_SIZE = 64 * 1024; ///< Number of bytes of the savegame that are read at once to hash it.
 
-		return SL_OK;
-	} catch (...) {
-		ClearSaveLoadState();
+/** Header of a journal, identifying the savegame the journal belongs to. */
+struct SaveJournalHeader {
+	uint32_t tag = 0;     ///< Tag of the format of the savegame, as stored in its header.
+	uint32_t version = 0; ///< Version of the savegame, as stored in its header.
+	uint64_t size = 0;    ///< Size of the savegame.
+	MD5Hash hash;         ///< MD5 hash of the whole savegame.
+
+	static constexpr size_t ENCODED_SIZE = 4 + 4 + 8 + MD5_HASH_BYTES; ///< Size of the header in the journal.
+	using Encoded = std::array<uint8_t, ENCODED_SIZE>; ///< The header as stored in the journal.
+
+	bool operator==(const SaveJournalHeader &other) const = default;
+
+	/**
+	 * Encode the header to store it in the journal, in big endian like the savegame itself.
+	 * @return The encoded header.
+	 */
+	Encoded Encode() const
+	{
+		Encoded buf;
+		auto it = buf.begin();
+		auto write = [&it](uint64_t value, uint bytes) {
+			for (uint i = bytes; i-- > 0;) *it++ = GB(value, i * 8, 8);
+		};
+		write(FROM_BE32(this->tag), 4);
+		write(FROM_BE32(this->version), 4);
+		write(this->size, 8);
+		std::copy(this->hash.begin(), this->hash.end(), it);
+		return buf;
+	}
+
+	/**
+	 * Decode a header stored in a journal.
+	 * @param buf The encoded header.
+	 * @return The header.
+	 */
+	static SaveJournalHeader Decode(const Encoded &buf)
+	{
+		auto it = buf.begin();
+		auto read = [&it](uint bytes) {
+			uint64_t value = 0;
+			for (uint i = 0; i < bytes; i++) value = (value << 8) | *it++;
+			return value;
+		};
+
+		SaveJournalHeader header;
+		header.tag = TO_BE32(static_cast<uint32_t>(read(4)));
+		header.version = TO_BE32(static_cast<uint32_t>(read(4)));
+		header.size = read(8);
+		std::copy_n(it, header.hash.size(), header.hash.begin());
+		return header;
+	}
+};
+
+/**
+ * Read the header of a journal.
+ * @param journal The journal, at its beginning.
+ * @return The header, or std::nullopt when it could not be read.
+ */
+static std::optional<SaveJournalHeader> ReadSaveJournalHeader(FILE *journal)
+{
+	SaveJournalHeader::Encoded buf;
+	if (fread(buf.data(), buf.size(), 1, journal) != 1) return std::nullopt;
+	return SaveJournalHeader::Decode(buf);
+}
 
-		AsyncSaveFinishProc asfp = SaveFileDone;
+/** State of the incremental autosaves. */
+struct SaveJournal {
+	std::string filename;                          ///< Name of the full autosave the journal belongs to, if there is one.
+	std::chrono::steady_clock::time_point session; ///< Start of the game session of the full autosave.
+	std::vector<uint64_t> chunk_hashes;            ///< Hashes of the chunks, as they were saved last.
+	uint segments = 0;                             ///< Number of segments in the journal.
+	std::optional<SaveJournalHeader> header;       ///< Header of the journal, once the full autosave has been hashed.
+};
+
+static SaveJournal _save_journal; ///< The state of the incremental autosaves.
+
+/**
+ * Get the header of a journal belonging to a savegame. This reads the whole
+ * savegame, so any change to it makes the journal not belong to it anymore.
+ * @param file The savegame, at its beginning.
+ * @param size The size of the savegame.
+ * @return The header; with a zero tag when the savegame could not be read.
+ */
+static SaveJournalHeader GetSaveJournalHeader(FILE *file, size_t size)
+{
+	SaveJournalHeader header;
+	long begin = ftell(file);
 
-		/* We don't want to shout when saving is just
-		 * cancelled due to a client disconnecting. */
-		if (_sl.error_str != STR_NETWORK_ERROR_LOSTCONNECTION) {
-			/* Skip the "colour" character */
-			Debug(sl, 0, "{}", GetString(GetSaveLoadErrorType()).substr(3) + GetString(GetSaveLoadErrorMessage()));
-			asfp = SaveFileError;
+	uint32_t hdr[2];
+	Md5 checksum;
+	size_t left = size;
+	if (size >= sizeof(hdr) && fread(hdr, sizeof(hdr), 1, file) == 1) {
+		checksum.Append(hdr, sizeof(hdr));
+		left -= sizeof(hdr);
+
+		std::vector<uint8_t> buf(SAVE_JOURNAL_HASH_BLOCK_SIZE);
+		while (left != 0) {
+			size_t len = fread(buf.data(), 1, std::min(left, buf.size()), file);
+			if (len == 0) break;
+			checksum.Append(buf.data(), len);
+			left -= len;
 		}
+	}
+	fseek(file, begin, SEEK_SET);
+	if (left != 0) return header;
+
+	header.tag = hdr[0];
+	header.version = hdr[1];
+	header.size = size;
+	checksum.Finish(header.hash);
+	return header;
+}
 
-		if (threaded) {
-			SetAsyncSaveFinish(asfp);
-		} else {
-			asfp();
+/** Filter appending a segment to a journal, preceded by its length, once the segment is complete. */
+struct SaveJournalSegmentWriter : SaveFilter {
+	std::optional<FileHandle> file; ///< The journal to append the segment to.
+	std::vector<uint8_t> segment;   ///< The segment written so far.
+
+	/**
+	 * Create the segment writer.
+	 * @param file The journal to append the segment to.
+	 */
+	SaveJournalSegmentWriter(FileHandle &&file) : SaveFilter(nullptr), file(std::move(file))
+	{
+	}
+
+	void Write(uint8_t *buf, size_t size) override
+	{
+		this->segment.insert(this->segment.end(), buf, buf + size);
+	}
+
+	void Finish() override
+	{
+		if (!this->file.has_value()) return;
+
+		uint32_t len = TO_BE32(static_cast<uint32_t>(this->segment.size()));
+		if (fwrite(&len, sizeof(len), 1, *this->file) != 1 || fwrite(this->segment.data(), 1, this->segment.size(), *this->file) != this->segment.size()) {
+			SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_WRITEABLE);
 		}
-		return SL_ERROR;
+		_game_session_stats.savegame_size = this->segment.size();
+		this->file.reset();
+	}
+};
+
+/**
+ * Read the chunks in a segment of a journal.
+ * @param segment The segment.
+ * @param header The header of the journal.
+ */
+static void ReadSaveJournalSegment(std::vector<uint8_t> &&segment, const SaveJournalHeader &header)
+{
+	uint32_t hdr[2];
+	if (segment.size() < sizeof(hdr)) SlErrorCorrupt("Journal segment is too short");
+	std::copy_n(segment.data(), sizeof(hdr), reinterpret_cast<uint8_t *>(hdr));
+	if (hdr[0] != header.tag || hdr[1] != header.version) SlErrorCorrupt("Journal segment differs in format from the savegame");
+
+	const SaveLoadFormat *fmt = std::find_if(std::begin(_saveload_formats), std::end(_saveload_formats), [&hdr](const auto &fmt) { return fmt.tag == hdr[0]; });
+	if (fmt == std::end(_saveload_formats) || fmt->init_load == nullptr) SlErrorCorrupt("Unknown format of journal segment");
+
+	auto filter = std::make_shared<MemoryLoadFilter>(std::move(segment));
+	filter->pos = sizeof(hdr);
+	auto reader = std::make_unique<ReadBuffer>(fmt->init_load(filter));
+
+	ReadBuffer *savegame_reader = std::exchange(_sl_chunk.reader, reader.get());
+	for (uint32_t len = SlReadUint32(); len != 0; len = SlReadUint32()) {
+		if (len < sizeof(uint32_t)) SlErrorCorrupt("Invalid chunk size in journal segment");
+
+		std::vector<uint8_t> &chunk = _sl.journal[SlReadUint32()];
+		chunk.resize(len - sizeof(uint32_t));
+		reader->Read(chunk.data(), chunk.size());
+	}
+	_sl_chunk.reader = savegame_reader;
+}
+
+/**
+ * Read the journal of a savegame, if it has one, so the chunks in it are loaded
+ * instead of those in the savegame.
+ * @param filename The name of the savegame.
+ * @param sb The directory of the savegame.
+ * @param file The savegame, at its beginning.
+ * @param size The size of the savegame.
+ */
+static void ReadSaveJournal(const std::string &filename, Subdirectory sb, FILE *file, size_t size)
+{
+	size_t journal_size;
+	auto journal = FioFOpenFile(filename + SAVE_JOURNAL_EXTENSION, "rb", sb, &journal_size);
+	if (!journal.has_value()) return;
+
+	std::optional<SaveJournalHeader> stored = ReadSaveJournalHeader(*journal);
+	if (!stored.has_value()) return;
+
+	SaveJournalHeader header = GetSaveJournalHeader(file, size);
+	if (*stored != header) {
+		Debug(sl, 1, "Ignoring journal of '{}', as it belongs to an earlier version of the savegame", filename);
+		return;
+	}
+
+	uint segments = 0;
+	size_t left = journal_size - SaveJournalHeader::ENCODED_SIZE;
+	for (uint32_t len; left >= sizeof(len) && fread(&len, sizeof(len), 1, *journal) == 1; segments++) {
+		left -= sizeof(len);
+		/* Only allocate what the journal can contain; a longer segment cannot be complete. */
+		if (FROM_BE32(len) > left) {
+			Debug(sl, 1, "Ignoring incomplete segment of journal of '{}'", filename);
+			break;
+		}
+		left -= FROM_BE32(len);
+
+		std::vector<uint8_t> segment(FROM_BE32(len));
+		if (fread(segment.data(), 1, segment.size(), *journal) != segment.size()) {
+			/* Saving the segment was interrupted; it was never finished. */
+			Debug(sl, 1, "Ignoring incomplete segment of journal of '{}'", filename);
+			break;
+		}
+		ReadSaveJournalSegment(std::move(segment), header);
+	}
+
+	Debug(sl, 1, "Loading {} chunks of {} journal segments", _sl.journal.size(), segments);
+}
+
+/**
+ * Clean up after writing the savegame failed, and report the error.
+ * @param threaded Whether the savegame was written by the savegame thread.
+ * @return #SL_ERROR
+ */
+static SaveOrLoadResult SaveFileFailed(bool threaded)
+{
+	ClearSaveLoadState();
+
+	/* The journal cannot be trusted anymore; start over with a full autosave. */
+	_save_journal.filename.clear();
+
+	AsyncSaveFinishProc asfp = SaveFileDone;
+
+	/* We don't want to shout when saving is just
+	 * cancelled due to a client disconnecting. */
+	if (_sl.error_str != STR_NETWORK_ERROR_LOSTCONNECTION) {
+		/* Skip the "colour" character */
+		Debug(sl, 0, "{}", GetString(GetSaveLoadErrorType()).substr(3) + GetString(GetSaveLoadErrorMessage()));
+		asfp = SaveFileError;
+	}
+
+	if (threaded) {
+		SetAsyncSaveFinish(asfp);
+	} else {
+		asfp();
+	}
+	return SL_ERROR;
+}
+
+/**
+ * Write the savegame to the savegame filter.
+ * @param threaded Whether this is running in the savegame thread, while the chunks are saved by the main thread.
+ * @return Return the result of the action. #SL_OK or #SL_ERROR
+ */
+static SaveOrLoadResult SaveFileToDisk(bool threaded)
+{
+	std::shared_ptr<SaveStream> stream = _sl.stream;
+	try {
+		if (!WriteSavegame(threaded)) return SL_ERROR;
+
+		ClearSaveLoadState();
+
+		if (threaded) SetAsyncSaveFinish(SaveFileDone);
+
+		return SL_OK;
+	} catch (...) {
+		if (threaded && !stream->Fail()) return SL_ERROR;
+		return SaveFileFailed(threaded);
 	}
 }
 
@@ -2871,8 +4328,10 @@ void WaitTillSaved()
 
 /**
  * Actually perform the saving of the savegame.
- * General tactics is to first save the game to memory, then write it to file
- * using the writer, either in threaded mode if possible, or single-threaded.
+ * General tactics is to save the chunks of the game to memory, and to write every
+ * chunk to the writer once it has been saved. If possible the compressing and the
+ * writing is done by the savegame thread, which finishes the savegame after the
+ * game continues; otherwise everything is done single-threaded.
  * @param writer   The filter to write the savegame to.
  * @param threaded Whether to try to perform the saving asynchronously.
  * @return Return the result of the action. #SL_OK or #SL_ERROR
@@ -2882,13 +4341,13 @@ static SaveOrLoadResult DoSave(std::shared_ptr<SaveFilter> writer, bool threaded
 	assert(!_sl.saveinprogress);
 
 	_sl.dumper = std::make_unique<MemoryDumper>();
+	_sl_chunk.dumper = _sl.dumper.get();
+	_sl.stream = std::make_shared<SaveStream>();
 	_sl.sf = writer;
 
 	_sl_version = SAVEGAME_VERSION;
 
 	SaveViewportBeforeSaveGame();
-	SlSaveChunks();
-
 	SaveFileStart();
 
 	if (!threaded || !StartNewThread(&_save_thread, "ottd:savegame", &SaveFileToDisk, true)) {
@@ -2900,19 +4359,220 @@ static SaveOrLoadResult DoSave(std::shared_ptr<SaveFilter> writer, bool threaded
 		return result;
 	}
 
+	std::shared_ptr<SaveStream> stream = _sl.stream;
+	try {
+		SlSaveChunks();
+	} catch (...) {
+		stream->Abort();
+		_save_thread.join();
+		SaveFileDone();
+		throw;
+	}
+	stream->Finish();
+
+	return SL_OK;
+}
+
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+/** Filter writing the savegame to a file descriptor, i.e. the write end of a pipe. */
+struct FileDescriptorWriter : SaveFilter {
+	int fd; ///< The file descriptor to write to.
+
+	/**
+	 * Create the file descriptor writer.
+	 * @param fd The file descriptor to write to.
+	 */
+	FileDescriptorWriter(int fd) : SaveFilter(nullptr), fd(fd)
+	{
+	}
+
+	void Write(uint8_t *buf, size_t size) override
+	{
+		while (size > 0) {
+			ssize_t written = write(this->fd, buf, size);
+			if (written < 0) {
+				if (errno == EINTR) continue;
+				SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_WRITEABLE);
+			}
+			buf += written;
+			size -= written;
+		}
+	}
+
+	void Finish() override
+	{
+	}
+};
+
+static const int FORKED_SAVE_TIMEOUT = 30000; ///< Milliseconds the forked child may write nothing, before it is considered to be stuck.
+
+/**
+ * Forward the savegame written by the forked child process to the writer. A child that
+ * writes nothing for #FORKED_SAVE_TIMEOUT is stuck, e.g. on a lock that another thread of
+ * the parent held when forking, so it is killed.
+ * @param pid The process ID of the child.
+ * @param fd The read end of the pipe the child writes the savegame to.
+ * @param threaded Whether this is running in the savegame thread.
+ * @param[out] stuck If not \c nullptr, set when the child got stuck before it wrote anything; the
+ *                   savegame is then not failed, so the caller can save the game in another way.
+ * @return Return the result of the action. #SL_OK or #SL_ERROR
+ */
+static SaveOrLoadResult ForwardForkedSave(pid_t pid, int fd, bool threaded, bool *stuck = nullptr)
+{
+	/* Closing the pipe makes a child that is still writing fail, so it can always be reaped afterwards. */
+	auto reap_child = [pid, &fd]() -> bool {
+		if (fd >= 0) close(fd);
+		fd = -1;
+
+		int status;
+		while (waitpid(pid, &status, 0) < 0) {
+			if (errno != EINTR) return false;
+		}
+		return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	};
+
+	try {
+		auto buf = std::make_unique<uint8_t[]>(MEMORY_CHUNK_SIZE);
+		bool forwarded = false;
+		for (;;) {
+			pollfd pfd = { fd, POLLIN, 0 };
+			int ready = poll(&pfd, 1, FORKED_SAVE_TIMEOUT);
+			if (ready < 0) {
+				if (errno == EINTR) continue;
+				SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "waiting for forked savegame failed");
+			}
+			if (ready == 0) {
+				kill(pid, SIGKILL);
+				if (stuck != nullptr && !forwarded) {
+					reap_child();
+					*stuck = true;
+					return SL_ERROR;
+				}
+				SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "forked savegame process got stuck");
+			}
+
+			ssize_t len = read(fd, buf.get(), MEMORY_CHUNK_SIZE);
+			if (len < 0) {
+				if (errno == EINTR) continue;
+				SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "reading forked savegame failed");
+			}
+			if (len == 0) break;
+			_sl.sf->Write(buf.get(), len);
+			forwarded = true;
+		}
+
+		if (!reap_child()) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "forked savegame process failed");
+		_sl.sf->Finish();
+
+		ClearSaveLoadState();
+
+		if (threaded) SetAsyncSaveFinish(SaveFileDone);
+
+		return SL_OK;
+	} catch (...) {
+		reap_child();
+		return SaveFileFailed(threaded);
+	}
+}
+
+/**
+ * Perform the saving of the savegame in a forked child process. The child serializes
+ * the chunks from its copy-on-write snapshot of the game state and writes the compressed
+ * savegame to a pipe, so the game does not stall while the chunks are being serialized.
+ * The savegame thread forwards the data from the pipe to the writer.
+ *
+ * The child only has the thread that forked, and any lock another thread held at that
+ * moment stays locked in the child. So the child saves the chunks on its single thread,
+ * and does not print debug output nor let drawing happen. When the child gets stuck
+ * nonetheless, it is killed; without savegame thread the game is then saved in this
+ * process instead. The savegame thread cannot do that, as by then the game has
+ * continued beyond the state that was to be saved.
+ * @param writer The filter to write the savegame to.
+ * @return Return the result of the action. #SL_OK or #SL_ERROR
+ */
+static SaveOrLoadResult DoForkedSave(std::shared_ptr<SaveFilter> writer)
+{
+	assert(!_sl.saveinprogress);
+
+	int fds[2];
+	if (pipe(fds) != 0) {
+		Debug(sl, 1, "Cannot create pipe for forked saving, reverting to threaded mode...");
+		return DoSave(writer, true);
+	}
+
+	SaveViewportBeforeSaveGame();
+
+	pid_t pid = fork();
+	if (pid < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		Debug(sl, 1, "Cannot fork for saving, reverting to threaded mode...");
+		return DoSave(writer, true);
+	}
+
+	if (pid == 0) {
+		/* We're the child; this process only writes the savegame and never returns to the game. */
+		close(fds[0]);
+
+		int status = 0;
+		try {
+			_sl.forked_child = true;
+			if (VideoDriver::GetInstance() != nullptr) VideoDriver::GetInstance()->ForgetDrawTick();
+			_sl.dumper = std::make_unique<MemoryDumper>();
+			_sl_chunk.dumper = _sl.dumper.get();
+			_sl.stream = std::make_shared<SaveStream>();
+			_sl.sf = std::make_shared<FileDescriptorWriter>(fds[1]);
+			_sl_version = SAVEGAME_VERSION;
+
+			WriteSavegame(false);
+		} catch (...) {
+			status = 1;
+		}
+
+		close(fds[1]);
+		_exit(status);
+	}
+
+	/* We're the parent. */
+	close(fds[1]);
+	_sl.sf = writer;
+
+	SaveFileStart();
+
+	if (!StartNewThread(&_save_thread, "ottd:savegame", [pid, fd = fds[0]]() { ForwardForkedSave(pid, fd, true); })) {
+		Debug(sl, 1, "Cannot create savegame thread, reverting to single-threaded mode...");
+
+		bool stuck = false;
+		SaveOrLoadResult result = ForwardForkedSave(pid, fds[0], false, &stuck);
+		SaveFileDone();
+
+		if (stuck) {
+			Debug(sl, 1, "Forked savegame process got stuck, reverting to saving in this process...");
+			return DoSave(writer, true);
+		}
+		return result;
+	}
+
 	return SL_OK;
 }
+#endif /* defined(UNIX) && !defined(__EMSCRIPTEN__) */
 
 /**
  * Save the game using a (writer) filter.
  * @param writer   The filter to write the savegame to.
  * @param threaded Whether to try to perform the saving asynchronously.
+ * @param forked   Whether to try to serialize the game in a forked process, so the game does not stall while saving.
+ * @param portable Whether the savegame has to be loadable by other builds, so it cannot be a raw snapshot.
  * @return Return the result of the action. #SL_OK or #SL_ERROR
  */
-SaveOrLoadResult SaveWithFilter(std::shared_ptr<SaveFilter> writer, bool threaded)
+SaveOrLoadResult SaveWithFilter(std::shared_ptr<SaveFilter> writer, bool threaded, [[maybe_unused]] bool forked, bool portable)
 {
 	try {
 		_sl.action = SLA_SAVE;
+		SlSetSaveFormat(_savegame_format, portable);
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+		if (threaded && forked) return DoForkedSave(writer);
+#endif
 		return DoSave(writer, threaded);
 	} catch (...) {
 		ClearSaveLoadState();
@@ -2992,7 +4652,14 @@ static SaveOrLoadResult DoLoad(std::shared_ptr<LoadFilter> reader, bool load_che
 	}
 
 	_sl.lf = fmt->init_load(_sl.lf);
+	_sl.raw_snapshot = fmt->tag == SAVEGAME_TAG_RAW;
 	_sl.reader = std::make_unique<ReadBuffer>(_sl.lf);
+	if (!load_check && !_sl.reader->in_memory) {
+		/* Unless the savegame is in memory already, read ahead. */
+		_sl.lf = std::make_shared<ReadAheadLoadFilter>(_sl.lf);
+		_sl.reader = std::make_unique<ReadBuffer>(_sl.lf);
+	}
+	_sl_chunk.reader = _sl.reader.get();
 	_next_offs = 0;
 
 	if (!load_check) {
@@ -3053,7 +4720,11 @@ static SaveOrLoadResult DoLoad(std::shared_ptr<LoadFilter> reader, bool load_che
 
 		/* After loading fix up savegame for any internal changes that
 		 * might have occurred since then. If it fails, load back the old game. */
-		if (!AfterLoadGame()) {
+		auto start = std::chrono::steady_clock::now();
+		bool success = AfterLoadGame();
+		if (_sl_profile != nullptr) _sl_profile->after_load += std::chrono::steady_clock::now() - start;
+
+		if (!success) {
 			_gamelog.StopAction();
 			return SL_REINIT;
 		}
@@ -3141,12 +4812,15 @@ SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop,
 			default: NOT_REACHED();
 		}
 
-		auto fh = (fop == SLO_SAVE) ? FioFOpenFile(filename, "wb", sb) : FioFOpenFile(filename, "rb", sb);
+		size_t filesize = 0;
+		auto fh = (fop == SLO_SAVE) ? FioFOpenFile(filename, "wb", sb) : FioFOpenFile(filename, "rb", sb, &filesize);
 
 		/* Make it a little easier to load savegames from the console */
-		if (!fh.has_value() && fop != SLO_SAVE) fh = FioFOpenFile(filename, "rb", SAVE_DIR);
-		if (!fh.has_value() && fop != SLO_SAVE) fh = FioFOpenFile(filename, "rb", BASE_DIR);
-		if (!fh.has_value() && fop != SLO_SAVE) fh = FioFOpenFile(filename, "rb", SCENARIO_DIR);
+		for (Subdirectory dir : {SAVE_DIR, BASE_DIR, SCENARIO_DIR}) {
+			if (fh.has_value() || fop == SLO_SAVE) break;
+			fh = FioFOpenFile(filename, "rb", dir, &filesize);
+			sb = dir;
+		}
 
 		if (!fh.has_value()) {
 			SlError(fop == SLO_SAVE ? STR_GAME_SAVELOAD_ERROR_FILE_NOT_WRITEABLE : STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
@@ -3156,12 +4830,14 @@ SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop,
 			Debug(desync, 1, "save: {:08x}; {:02x}; {}", TimerGameEconomy::date, TimerGameEconomy::date_fract, filename);
 			if (!_settings_client.gui.threaded_saves) threaded = false;
 
+			SlSetSaveFormat(_savegame_format, false);
 			return DoSave(std::make_shared<FileWriter>(std::move(*fh)), threaded);
 		}
 
 		/* LOAD game */
 		assert(fop == SLO_LOAD || fop == SLO_CHECK);
 		Debug(desync, 1, "load: {}", filename);
+		ReadSaveJournal(filename, sb, *fh, filesize);
 		return DoLoad(std::make_shared<FileReader>(std::move(*fh)), fop == SLO_CHECK);
 	} catch (...) {
 		/* This code may be executed both for old and new save games. */
@@ -3175,6 +4851,96 @@ SaveOrLoadResult SaveOrLoad(const std::string &filename, SaveLoadOperation fop,
 	}
 }
 
+/**
+ * Get the header of the journal the next incremental autosave can be appended to.
+ * @return The header of the journal, or std::nullopt when a full autosave has to be made.
+ */
+static std::optional<SaveJournalHeader> GetAppendableSaveJournal()
+{
+	if (_save_journal.filename.empty() || _save_journal.session != _game_session_stats.start_time) return std::nullopt;
+	if (_save_journal.segments >= _settings_client.gui.autosave_journal_segments) return std::nullopt;
+
+	size_t size;
+	auto file = FioFOpenFile(_save_journal.filename, "rb", AUTOSAVE_DIR, &size);
+	if (!file.has_value()) return std::nullopt;
+
+	/* The full autosave does not change while segments are appended, so it is only hashed once. */
+	if (!_save_journal.header.has_value()) _save_journal.header = GetSaveJournalHeader(*file, size);
+	const SaveJournalHeader &header = *_save_journal.header;
+
+	/* Segments have to be in the same format as the full autosave. */
+	if (header.size != size || header.tag != _sl.save_format->tag) return std::nullopt;
+
+	/* And the journal must still belong to the full autosave. */
+	auto journal = FioFOpenFile(_save_journal.filename + SAVE_JOURNAL_EXTENSION, "rb", AUTOSAVE_DIR);
+	std::optional<SaveJournalHeader> stored = journal.has_value() ? ReadSaveJournalHeader(*journal) : std::nullopt;
+	if (!stored.has_value()) {
+		if (_save_journal.segments != 0) return std::nullopt;
+	} else if (*stored != header) {
+		return std::nullopt;
+	}
+
+	return header;
+}
+
+/**
+ * Create an incremental autosave: either a full autosave with an empty journal,
+ * or a segment of the journal with the chunks that changed since the last autosave.
+ * @param counter A reference to the counter variable to be used for rotating the file name.
+ * @return The result of the saving.
+ */
+static SaveOrLoadResult DoIncrementalAutosave(FiosNumberedSaveName &counter)
+{
+	/* An instance of saving is already active, so don't go saving again */
+	if (_sl.saveinprogress) return SL_OK;
+	WaitTillSaved();
+
+	try {
+		_sl.action = SLA_SAVE;
+		bool threaded = _settings_client.gui.threaded_saves;
+
+		/* Autosaves are for local use only, like the journal segments written in the format of their full autosave. */
+		SlSetSaveFormat(_savegame_format, false);
+
+		std::optional<SaveJournalHeader> header = GetAppendableSaveJournal();
+		if (header.has_value()) {
+			auto journal = FioFOpenFile(_save_journal.filename + SAVE_JOURNAL_EXTENSION, "ab", AUTOSAVE_DIR);
+			if (!journal.has_value()) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_WRITEABLE);
+
+			fseek(*journal, 0, SEEK_END);
+			SaveJournalHeader::Encoded encoded = header->Encode();
+			if (ftell(*journal) == 0 && fwrite(encoded.data(), encoded.size(), 1, *journal) != 1) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_WRITEABLE);
+
+			Debug(sl, 2, "Appending segment {} to the journal of '{}'", _save_journal.segments + 1, _save_journal.filename);
+			_save_journal.segments++;
+			_sl.chunk_hashes = &_save_journal.chunk_hashes;
+			_sl.journal_segment = true;
+			return DoSave(std::make_shared<SaveJournalSegmentWriter>(std::move(*journal)), threaded);
+		}
+
+		_save_journal.filename = counter.Filename();
+		_save_journal.session = _game_session_stats.start_time;
+		_save_journal.segments = 0;
+		_save_journal.header.reset();
+
+		/* Empty the journal left by an earlier full autosave with this name. */
+		auto journal = FioFOpenFile(_save_journal.filename + SAVE_JOURNAL_EXTENSION, "wb", AUTOSAVE_DIR);
+		auto file = FioFOpenFile(_save_journal.filename, "wb", AUTOSAVE_DIR);
+		if (!journal.has_value() || !file.has_value()) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_WRITEABLE);
+
+		Debug(sl, 2, "Autosaving to '{}'", _save_journal.filename);
+		_sl.chunk_hashes = &_save_journal.chunk_hashes;
+		return DoSave(std::make_shared<FileWriter>(std::move(*file)), threaded);
+	} catch (...) {
+		ClearSaveLoadState();
+		_save_journal.filename.clear();
+
+		/* Skip the "colour" character */
+		Debug(sl, 0, "{}", GetString(GetSaveLoadErrorType()).substr(3) + GetString(GetSaveLoadErrorMessage()));
+		return SL_ERROR;
+	}
+}
+
 /**
  * Create an autosave or netsave.
  * @param counter A reference to the counter variable to be used for rotating the file name.
@@ -3184,12 +4950,20 @@ void DoAutoOrNetsave(FiosNumberedSaveName &counter)
 {
 	std::string filename;
 
+	if (_do_autosave && _settings_client.gui.autosave_journal_segments != 0 && !_settings_client.gui.keep_all_autosave) {
+		if (DoIncrementalAutosave(counter) != SL_OK) ShowErrorMessage(STR_ERROR_AUTOSAVE_FAILED, INVALID_STRING_ID, WL_ERROR);
+		return;
+	}
+
 	if (_settings_client.gui.keep_all_autosave) {
 		filename = GenerateDefaultSaveName() + counter.Extension();
 	} else {
 		filename = counter.Filename();
 	}
 
+	/* The autosave might overwrite the full autosave of a journal. */
+	_save_journal.filename.clear();
+
 	Debug(sl, 2, "Autosaving to '{}'", filename);
 	if (SaveOrLoad(filename, SLO_SAVE, DFT_GAME_FILE, AUTOSAVE_DIR) != SL_OK) {
 		ShowErrorMessage(STR_ERROR_AUTOSAVE_FAILED, INVALID_STRING_ID, WL_ERROR);
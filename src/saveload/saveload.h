@@ -14,6 +14,8 @@
 #include "../fileio_type.h"
 #include "../fios.h"
 
+#include <chrono>
+
 /** SaveLoad versions
  * Previous savegame versions, the trunk revision where they were
  * introduced and the released version that had that particular
@@ -391,6 +393,8 @@ enum SaveLoadVersion : uint16_t {
 	SLV_PRODUCTION_HISTORY,                 ///< 343  PR#10541 Industry production history.
 	SLV_ROAD_TYPE_LABEL_MAP,                ///< 344  PR#13021 Add road type label map to allow upgrade/conversion of road types.
 	SLV_NONFLOODING_WATER_TILES,            ///< 345  PR#13013 Store water tile non-flooding state.
+	SLV_MAP_PLANE_FILTERS,                  ///< 346  Delta and run-length encoding of the map planes.
+	SLV_STRING_TABLE,                       ///< 347  Strings that repeat within a chunk are saved once.
 
 	SL_MAX_VERSION,                         ///< Highest possible saveload version
 };
@@ -438,9 +442,19 @@ void DoExitSave();
 
 void DoAutoOrNetsave(FiosNumberedSaveName &counter);
 
-SaveOrLoadResult SaveWithFilter(std::shared_ptr<struct SaveFilter> writer, bool threaded);
+SaveOrLoadResult SaveWithFilter(std::shared_ptr<struct SaveFilter> writer, bool threaded, bool forked = false, bool portable = true);
 SaveOrLoadResult LoadWithFilter(std::shared_ptr<struct LoadFilter> reader);
 
+/** Where the time went while saving or loading a game, see #SlSetProfile. */
+struct SaveLoadProfile {
+	std::map<std::string, std::chrono::steady_clock::duration> chunks; ///< Time spent saving or loading each chunk, by name of the chunk.
+	std::chrono::steady_clock::duration fix_pointers{}; ///< Time spent resolving the references after loading the chunks.
+	std::chrono::steady_clock::duration after_load{}; ///< Time spent in AfterLoadGame.
+};
+
+void SlSetProfile(SaveLoadProfile *profile);
+std::vector<std::string> GetSavegameFormatNames();
+
 typedef void AutolengthProc(int);
 
 /** Type of a chunk. */
@@ -491,6 +505,30 @@ struct ChunkHandler {
 	 */
 	virtual void LoadCheck(size_t len = 0) const;
 
+	/**
+	 * Whether the chunk can be saved at the same time as other chunks.
+	 * That is only the case when saving it just reads the game state, and does
+	 * not use any (temporary) state that is shared with other chunks.
+	 * @return True iff the chunk can be saved in parallel with other chunks.
+	 */
+	virtual bool CanSaveInParallel() const { return false; }
+
+	/**
+	 * Whether the chunk can be loaded at the same time as other chunks.
+	 * That is only the case for RIFF chunks whose loading only depends on chunks
+	 * that cannot be loaded in parallel, and does not touch any state that is
+	 * touched by other chunks.
+	 * @return True iff the chunk can be loaded in parallel with other chunks.
+	 */
+	virtual bool CanLoadInParallel() const { return false; }
+
+	/**
+	 * Finish loading a chunk that can be loaded in parallel with other chunks.
+	 * This is called on the loading thread, once all chunks that were loaded at
+	 * the same time have been loaded.
+	 */
+	virtual void FinishParallelLoad() const {}
+
 	std::string GetName() const
 	{
 		return std::string()
@@ -1300,6 +1338,7 @@ std::vector<SaveLoad> SlCompatTableHeader(const SaveLoadTable &slt, const SaveLo
 void SlObject(void *object, const SaveLoadTable &slt);
 
 bool SaveloadCrashWithMissingNewGRFs();
+bool SlIsRawSnapshot();
 
 /**
  * Read in bytes from the file/data structure but don't do
@@ -43,6 +43,16 @@ struct LoadFilter {
 	{
 		this->chain->Reset();
 	}
+
+	/**
+	 * Take the rest of the savegame when it is available in memory as a whole,
+	 * so it can be read from there directly. Afterwards nothing is left to read.
+	 * @return The rest of the savegame, or nothing when it is not in memory.
+	 */
+	virtual std::span<const uint8_t> TakeRemainder()
+	{
+		return {};
+	}
 };
 
 /**
@@ -29,6 +29,7 @@
 #include "landscape.h"
 #include "video/video_driver.hpp"
 #include "smallmap_gui.h"
+#include "worker_pool.h"
 
 #include "table/strings.h"
 
@@ -556,17 +557,24 @@ const char *GetCurrentScreenshotExtension()
 	return _cur_screenshot_format->extension;
 }
 
-/** Initialize screenshot format information on startup, with #_screenshot_format_name filled from the loadsave code. */
-void InitializeScreenshotFormats()
+/**
+ * Find a screenshot format by its extension.
+ * @param extension The extension, without the dot.
+ * @return The format, or \c nullptr when there is no such format.
+ */
+static const ScreenshotFormat *FindScreenshotFormat(std::string_view extension)
 {
 	for (auto &format : _screenshot_formats) {
-		if (_screenshot_format_name == format.extension) {
-			_cur_screenshot_format = &format;
-			return;
-		}
+		if (extension == format.extension) return &format;
 	}
+	return nullptr;
+}
 
-	_cur_screenshot_format = std::begin(_screenshot_formats);
+/** Initialize screenshot format information on startup, with #_screenshot_format_name filled from the loadsave code. */
+void InitializeScreenshotFormats()
+{
+	_cur_screenshot_format = FindScreenshotFormat(_screenshot_format_name);
+	if (_cur_screenshot_format == nullptr) _cur_screenshot_format = std::begin(_screenshot_formats);
 }
 
 /**
@@ -581,58 +589,69 @@ static void CurrentScreenCallback(void *, void *buf, uint y, uint pitch, uint n)
 }
 
 /**
- * generate a large piece of the world
- * @param userdata Viewport area to draw
- * @param buf Videobuffer with same bitdepth as current blitter
- * @param y First line to render
- * @param pitch Pitch of the videobuffer
- * @param n Number of lines to render
+ * Draw a part of a viewport into a buffer instead of onto the screen.
+ * @param vp Viewport to draw.
+ * @param buf Buffer to draw into, with the same bit depth as the current blitter; the top left of the part is drawn at its start.
+ * @param pitch Pitch of the buffer, in pixels.
+ * @param left Left edge of the part to draw, in pixels of the viewport.
+ * @param top Top edge of the part to draw, in pixels of the viewport.
+ * @param width Width of the part to draw, in pixels.
+ * @param height Height of the part to draw, in pixels.
  */
-static void LargeWorldCallback(void *userdata, void *buf, uint y, uint pitch, uint n)
+static void DrawViewportToBuffer(const Viewport *vp, void *buf, uint pitch, int left, int top, int width, int height)
 {
-	Viewport *vp = (Viewport *)userdata;
-	DrawPixelInfo dpi;
-	int wx, left;
-
 	/* We are no longer rendering to the screen */
 	DrawPixelInfo old_screen = _screen;
 	bool old_disable_anim = _screen_disable_anim;
 
 	_screen.dst_ptr = buf;
 	_screen.width = pitch;
-	_screen.height = n;
+	_screen.height = height;
 	_screen.pitch = pitch;
 	_screen_disable_anim = true;
 
+	DrawPixelInfo dpi;
 	AutoRestoreBackup dpi_backup(_cur_dpi, &dpi);
 
 	dpi.dst_ptr = buf;
-	dpi.height = n;
-	dpi.width = vp->width;
+	dpi.height = height;
+	dpi.width = width;
 	dpi.pitch = pitch;
-	dpi.zoom = ZOOM_LVL_WORLD_SCREENSHOT;
-	dpi.left = 0;
-	dpi.top = y;
+	dpi.zoom = vp->zoom;
+	dpi.left = left;
+	dpi.top = top;
 
-	/* Render viewport in blocks of 1600 pixels width */
-	left = 0;
-	while (vp->width - left != 0) {
-		wx = std::min(vp->width - left, 1600);
-		left += wx;
-
-		ViewportDoDraw(vp,
-			ScaleByZoom(left - wx - vp->left, vp->zoom) + vp->virtual_left,
-			ScaleByZoom(y - vp->top, vp->zoom) + vp->virtual_top,
-			ScaleByZoom(left - vp->left, vp->zoom) + vp->virtual_left,
-			ScaleByZoom((y + n) - vp->top, vp->zoom) + vp->virtual_top
-		);
-	}
+	ViewportDoDraw(vp,
+		ScaleByZoom(left - vp->left, vp->zoom) + vp->virtual_left,
+		ScaleByZoom(top - vp->top, vp->zoom) + vp->virtual_top,
+		ScaleByZoom(left + width - vp->left, vp->zoom) + vp->virtual_left,
+		ScaleByZoom(top + height - vp->top, vp->zoom) + vp->virtual_top
+	);
 
 	/* Switch back to rendering to the screen */
 	_screen = old_screen;
 	_screen_disable_anim = old_disable_anim;
 }
 
+/**
+ * generate a large piece of the world
+ * @param userdata Viewport area to draw
+ * @param buf Videobuffer with same bitdepth as current blitter
+ * @param y First line to render
+ * @param pitch Pitch of the videobuffer
+ * @param n Number of lines to render
+ */
+static void LargeWorldCallback(void *userdata, void *buf, uint y, uint pitch, uint n)
+{
+	const Viewport *vp = (const Viewport *)userdata;
+	Blitter *blitter = BlitterFactory::GetCurrentBlitter();
+
+	/* Render viewport in blocks of 1600 pixels width */
+	for (int left = 0; left < vp->width; left += 1600) {
+		DrawViewportToBuffer(vp, blitter->MoveTo(buf, left, 0), pitch, left, y, std::min(vp->width - left, 1600), n);
+	}
+}
+
 /**
  * Construct a pathname for a screenshot file.
  * @param default_fn Default filename.
@@ -684,6 +703,37 @@ static bool MakeSmallScreenshot(bool crashlog)
 			BlitterFactory::GetCurrentBlitter()->GetScreenDepth(), _cur_palette.palette);
 }
 
+/**
+ * Configure a Viewport for rendering the whole map.
+ * @param[out] vp Result viewport.
+ * @param zoom Zoom level to render the map at.
+ */
+static void SetupWorldViewport(Viewport *vp, ZoomLevel zoom)
+{
+	/* Determine world coordinates of screenshot */
+	vp->zoom = zoom;
+
+	TileIndex north_tile = _settings_game.construction.freeform_edges ? TileXY(1, 1) : TileXY(0, 0);
+	TileIndex south_tile = Map::Size() - 1;
+
+	/* We need to account for a hill or high building at tile 0,0. */
+	int extra_height_top = TilePixelHeight(north_tile) + 150;
+	/* If there is a hill at the bottom don't create a large black area. */
+	int reclaim_height_bottom = TilePixelHeight(south_tile);
+
+	vp->virtual_left   = RemapCoords(TileX(south_tile) * TILE_SIZE, TileY(north_tile) * TILE_SIZE, 0).x;
+	vp->virtual_top    = RemapCoords(TileX(north_tile) * TILE_SIZE, TileY(north_tile) * TILE_SIZE, extra_height_top).y;
+	vp->virtual_width  = RemapCoords(TileX(north_tile) * TILE_SIZE, TileY(south_tile) * TILE_SIZE, 0).x                     - vp->virtual_left + 1;
+	vp->virtual_height = RemapCoords(TileX(south_tile) * TILE_SIZE, TileY(south_tile) * TILE_SIZE, reclaim_height_bottom).y - vp->virtual_top  + 1;
+
+	/* Compute pixel coordinates */
+	vp->left = 0;
+	vp->top = 0;
+	vp->width  = UnScaleByZoom(vp->virtual_width,  vp->zoom);
+	vp->height = UnScaleByZoom(vp->virtual_height, vp->zoom);
+	vp->overlay = nullptr;
+}
+
 /**
  * Configure a Viewport for rendering (a part of) the map into a screenshot.
  * @param t Screenshot type
@@ -715,28 +765,7 @@ void SetupScreenshotViewport(ScreenshotType t, Viewport *vp, uint32_t width, uin
 		case SC_WORLD: {
 			assert(width == 0 && height == 0);
 
-			/* Determine world coordinates of screenshot */
-			vp->zoom = ZOOM_LVL_WORLD_SCREENSHOT;
-
-			TileIndex north_tile = _settings_game.construction.freeform_edges ? TileXY(1, 1) : TileXY(0, 0);
-			TileIndex south_tile = Map::Size() - 1;
-
-			/* We need to account for a hill or high building at tile 0,0. */
-			int extra_height_top = TilePixelHeight(north_tile) + 150;
-			/* If there is a hill at the bottom don't create a large black area. */
-			int reclaim_height_bottom = TilePixelHeight(south_tile);
-
-			vp->virtual_left   = RemapCoords(TileX(south_tile) * TILE_SIZE, TileY(north_tile) * TILE_SIZE, 0).x;
-			vp->virtual_top    = RemapCoords(TileX(north_tile) * TILE_SIZE, TileY(north_tile) * TILE_SIZE, extra_height_top).y;
-			vp->virtual_width  = RemapCoords(TileX(north_tile) * TILE_SIZE, TileY(south_tile) * TILE_SIZE, 0).x                     - vp->virtual_left + 1;
-			vp->virtual_height = RemapCoords(TileX(south_tile) * TILE_SIZE, TileY(south_tile) * TILE_SIZE, reclaim_height_bottom).y - vp->virtual_top  + 1;
-
-			/* Compute pixel coordinates */
-			vp->left = 0;
-			vp->top = 0;
-			vp->width  = UnScaleByZoom(vp->virtual_width,  vp->zoom);
-			vp->height = UnScaleByZoom(vp->virtual_height, vp->zoom);
-			vp->overlay = nullptr;
+			SetupWorldViewport(vp, ZOOM_LVL_WORLD_SCREENSHOT);
 			break;
 		}
 		default: {
@@ -781,6 +810,270 @@ static bool MakeLargeWorldScreenshot(ScreenshotType t, uint32_t width = 0, uint3
 			BlitterFactory::GetCurrentBlitter()->GetScreenDepth(), _cur_palette.palette);
 }
 
+/**
+ * Make an image of the whole map, without involving the GUI.
+ * @param filename The file to write the image to; its extension determines the format.
+ * @param zoom The zoom level to draw the map at.
+ * @return True iff the image was written.
+ */
+bool MakeWorldImage(const std::string &filename, ZoomLevel zoom)
+{
+	const ScreenshotFormat *format = FindScreenshotFormat(filename.substr(filename.rfind('.') + 1));
+	if (format == nullptr) return false;
+
+	Viewport vp;
+	SetupWorldViewport(&vp, zoom);
+
+	return format->proc(filename.c_str(), LargeWorldCallback, &vp, vp.width, vp.height,
+			BlitterFactory::GetCurrentBlitter()->GetScreenDepth(), _cur_palette.palette);
+}
+
+static const uint MAP_TILE_SIZE = 256; ///< Width and height in pixels of the tiles of a tile pyramid.
+static const uint MAP_TILE_BLOCK = 16; ///< Number of tiles next to each other that are drawn at once.
+
+/**
+ * Writer of a pyramid of map tiles, like the ones used by slippy maps. The tile at
+ * level 0 shows the whole map, and every next level doubles the resolution, up to
+ * the most detailed level. Levels are drawn by the game at the zoom level matching
+ * their resolution; the levels that are zoomed out further than the game can draw
+ * are scaled down from the most zoomed out level the game can draw.
+ */
+class MapTilePyramid {
+public:
+	MapTilePyramid(const std::string &directory, const ScreenshotFormat *format);
+	bool Make(ZoomLevel zoom);
+
+private:
+	/** A level of the pyramid that is made by scaling down the level above it. */
+	struct ScaledLevel {
+		uint level;                  ///< The level in the pyramid.
+		uint width;                  ///< Width of the level in pixels.
+		uint height;                 ///< Height of the level in pixels.
+		std::vector<uint8_t> pixels; ///< Pixels of the row of tiles that is being filled.
+	};
+
+	std::string directory;             ///< Directory to write the pyramid to.
+	const ScreenshotFormat *format;    ///< Format of the tiles.
+	uint bpp;                          ///< Bytes per pixel.
+	std::vector<ScaledLevel> scaled;   ///< The scaled levels, most detailed first.
+	WorkerPool pool{"ottd:maptiles"};  ///< Pool for writing the tiles.
+	std::atomic<bool> failed = false;  ///< Whether writing any tile failed.
+
+	void WriteTiles(const uint8_t *pixels, uint pitch, uint level, uint first, uint count, uint row);
+	void ScaleDown(size_t index, const uint8_t *pixels, uint pitch, uint src_width, uint src_height, uint x, uint y, uint width, uint height);
+	void FinishRow(size_t index, uint row, bool last);
+	void DrawLevel(uint level, ZoomLevel zoom, bool scale);
+};
+
+/**
+ * Create the writer of a pyramid.
+ * @param directory Directory to write the pyramid to.
+ * @param format Format of the tiles.
+ */
+MapTilePyramid::MapTilePyramid(const std::string &directory, const ScreenshotFormat *format) : directory(directory), format(format)
+{
+	this->bpp = BlitterFactory::GetCurrentBlitter()->GetScreenDepth() / 8;
+}
+
+/** A tile being written, see #MapTileCallback. */
+struct MapTile {
+	const uint8_t *pixels; ///< The top left pixel of the tile.
+	uint pitch;            ///< Pitch of the pixels, in pixels.
+	uint bpp;              ///< Bytes per pixel.
+};
+
+/**
+ * Callback of the screenshot generator copying the lines of a map tile.
+ * @see ScreenshotCallback
+ */
+static void MapTileCallback(void *userdata, void *buf, uint y, uint pitch, uint n)
+{
+	const MapTile *tile = static_cast<const MapTile *>(userdata);
+	for (uint i = 0; i < n; i++) {
+		std::copy_n(tile->pixels + static_cast<size_t>(y + i) * tile->pitch * tile->bpp, pitch * tile->bpp, static_cast<uint8_t *>(buf) + static_cast<size_t>(i) * pitch * tile->bpp);
+	}
+}
+
+/**
+ * Write a number of tiles next to each other, in parallel.
+ * @param pixels The pixels of the first tile; there must be #MAP_TILE_SIZE lines of pixels for all tiles.
+ * @param pitch Pitch of the pixels, in pixels.
+ * @param level The level of the pyramid.
+ * @param first The column of the first tile.
+ * @param count The number of tiles.
+ * @param row The row of the tiles.
+ */
+void MapTilePyramid::WriteTiles(const uint8_t *pixels, uint pitch, uint level, uint first, uint count, uint row)
+{
+	for (uint i = 0; i < count; i++) FioCreateDirectory(fmt::format("{}{}{}{}{}", this->directory, level, PATHSEP, first + i, PATHSEP));
+
+	this->pool.Run(count, [this, pixels, pitch, level, first, row](size_t i) {
+		MapTile tile{ pixels + i * MAP_TILE_SIZE * this->bpp, pitch, this->bpp };
+		std::string name = fmt::format("{}{}{}{}{}{}.{}", this->directory, level, PATHSEP, first + i, PATHSEP, row, this->format->extension);
+		if (!this->format->proc(name.c_str(), MapTileCallback, &tile, MAP_TILE_SIZE, MAP_TILE_SIZE, this->bpp * 8, _cur_palette.palette)) {
+			Debug(misc, 0, "Cannot write map tile {}", name);
+			this->failed = true;
+		}
+	});
+}
+
+/**
+ * Scale a part of a level down into the next scaled level. 32bpp pixels are averaged,
+ * for 8bpp pixels the top left of every square of four pixels is taken.
+ * @param index Index of the scaled level to scale into.
+ * @param pixels The pixels of the part.
+ * @param pitch Pitch of the pixels, in pixels.
+ * @param src_width Width of the level being scaled down, in pixels.
+ * @param src_height Height of the level being scaled down, in pixels.
+ * @param x Left edge of the part in the level being scaled down; must be even.
+ * @param y Top edge of the part in the level being scaled down; must be even.
+ * @param width Width of the part, in pixels.
+ * @param height Height of the part, in pixels.
+ */
+void MapTilePyramid::ScaleDown(size_t index, const uint8_t *pixels, uint pitch, uint src_width, uint src_height, uint x, uint y, uint width, uint height)
+{
+	ScaledLevel &dst = this->scaled[index];
+	uint dst_pitch = Align(dst.width, MAP_TILE_SIZE);
+
+	for (uint dy = 0; dy < CeilDiv(height, 2); dy++) {
+		uint8_t *out = dst.pixels.data() + (static_cast<size_t>((y / 2 + dy) % MAP_TILE_SIZE) * dst_pitch + x / 2) * this->bpp;
+		for (uint dx = 0; dx < CeilDiv(width, 2); dx++, out += this->bpp) {
+			const uint8_t *in = pixels + (static_cast<size_t>(dy * 2) * pitch + dx * 2) * this->bpp;
+			if (this->bpp != 4) {
+				std::copy_n(in, this->bpp, out);
+				continue;
+			}
+
+			/* Only average the pixels that are part of the level. */
+			uint columns = (x + dx * 2 + 1 < src_width) ? 2 : 1;
+			uint rows = (y + dy * 2 + 1 < src_height) ? 2 : 1;
+			for (uint channel = 0; channel < 4; channel++) {
+				uint sum = 0;
+				for (uint r = 0; r < rows; r++) {
+					for (uint c = 0; c < columns; c++) sum += in[(r * pitch + c) * 4 + channel];
+				}
+				out[channel] = sum / (rows * columns);
+			}
+		}
+	}
+}
+
+/**
+ * Handle that a row of tiles of the level above a scaled level is complete. Once
+ * both rows of tiles of the level above that make up a row of tiles of the scaled
+ * level are complete, the row of tiles of the scaled level is written and scaled
+ * down into the next scaled level.
+ * @param index Index of the scaled level.
+ * @param row The row of tiles of the level above that is complete.
+ * @param last Whether it is the last row of tiles of the level above.
+ */
+void MapTilePyramid::FinishRow(size_t index, uint row, bool last)
+{
+	if (index >= this->scaled.size() || (row % 2 == 0 && !last)) return;
+
+	ScaledLevel &level = this->scaled[index];
+	uint pitch = Align(level.width, MAP_TILE_SIZE);
+	uint tile_row = row / 2;
+	this->WriteTiles(level.pixels.data(), pitch, level.level, 0, pitch / MAP_TILE_SIZE, tile_row);
+
+	if (index + 1 < this->scaled.size()) {
+		uint top = tile_row * MAP_TILE_SIZE;
+		this->ScaleDown(index + 1, level.pixels.data(), pitch, level.width, level.height, 0, top, level.width, std::min(MAP_TILE_SIZE, level.height - top));
+		this->FinishRow(index + 1, tile_row, last);
+	}
+
+	std::fill(level.pixels.begin(), level.pixels.end(), 0);
+}
+
+/**
+ * Draw all tiles of a level of the pyramid.
+ * @param level The level.
+ * @param zoom The zoom level to draw the level at.
+ * @param scale Whether to scale the level down into the scaled levels.
+ */
+void MapTilePyramid::DrawLevel(uint level, ZoomLevel zoom, bool scale)
+{
+	Viewport vp;
+	SetupWorldViewport(&vp, zoom);
+
+	uint columns = CeilDiv(vp.width, MAP_TILE_SIZE);
+	uint rows = CeilDiv(vp.height, MAP_TILE_SIZE);
+	uint pitch = MAP_TILE_BLOCK * MAP_TILE_SIZE;
+	std::vector<uint8_t> pixels(static_cast<size_t>(pitch) * MAP_TILE_SIZE * this->bpp);
+
+	Debug(misc, 1, "Drawing level {} of the map tiles, {}x{} tiles", level, columns, rows);
+
+	for (uint row = 0; row < rows; row++) {
+		int top = row * MAP_TILE_SIZE;
+		int height = std::min<int>(MAP_TILE_SIZE, vp.height - top);
+
+		for (uint first = 0; first < columns; first += MAP_TILE_BLOCK) {
+			uint count = std::min(MAP_TILE_BLOCK, columns - first);
+			int left = first * MAP_TILE_SIZE;
+			int width = std::min<int>(count * MAP_TILE_SIZE, vp.width - left);
+
+			std::fill(pixels.begin(), pixels.end(), 0);
+			DrawViewportToBuffer(&vp, pixels.data(), pitch, left, top, width, height);
+			this->WriteTiles(pixels.data(), pitch, level, first, count, row);
+
+			if (scale) this->ScaleDown(0, pixels.data(), pitch, vp.width, vp.height, left, top, width, height);
+		}
+
+		if (scale) this->FinishRow(0, row, row + 1 == rows);
+	}
+}
+
+/**
+ * Make the whole pyramid.
+ * @param zoom The zoom level of the most detailed level.
+ * @return True iff all tiles were written.
+ */
+bool MapTilePyramid::Make(ZoomLevel zoom)
+{
+	Viewport vp;
+	SetupWorldViewport(&vp, zoom);
+
+	/* The most detailed level is the first level at which the whole map fits in the tiles. */
+	uint levels = 1;
+	while ((MAP_TILE_SIZE << (levels - 1)) < static_cast<uint>(std::max(vp.width, vp.height))) levels++;
+
+	/* Levels that are zoomed out further than the game can draw are scaled down. */
+	uint drawn = std::min<uint>(levels, ZOOM_LVL_MAX - zoom + 1);
+	uint width = vp.width;
+	uint height = vp.height;
+	for (uint level = levels; level-- > 0;) {
+		if (level < levels - drawn) {
+			this->scaled.push_back({ level, width, height, std::vector<uint8_t>(static_cast<size_t>(Align(width, MAP_TILE_SIZE)) * MAP_TILE_SIZE * this->bpp) });
+		}
+		width = CeilDiv(width, 2);
+		height = CeilDiv(height, 2);
+	}
+
+	for (uint i = 0; i < drawn; i++) {
+		uint level = levels - 1 - i;
+		this->DrawLevel(level, static_cast<ZoomLevel>(zoom + i), i + 1 == drawn && !this->scaled.empty());
+	}
+
+	return !this->failed;
+}
+
+/**
+ * Make a pyramid of tiles of the whole map, like the ones used by slippy maps, without
+ * involving the GUI. The tiles are written as \c directory/level/x/y.png, or with the
+ * extension of the current screenshot format when PNG is not supported.
+ * @param directory The directory to write the tiles to.
+ * @param zoom The zoom level to draw the most detailed level at.
+ * @return True iff all tiles were written.
+ */
+bool MakeWorldTiles(std::string directory, ZoomLevel zoom)
+{
+	const ScreenshotFormat *format = FindScreenshotFormat("png");
+	if (format == nullptr) format = _cur_screenshot_format;
+
+	if (!directory.ends_with(PATHSEP)) directory += PATHSEP;
+	return MapTilePyramid(directory, format).Make(zoom);
+}
+
 /**
  * Callback for generating a heightmap. Supports 8bpp grayscale only.
  * @param buffer   Destination buffer.
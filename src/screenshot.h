@@ -10,6 +10,8 @@
 #ifndef SCREENSHOT_H
 #define SCREENSHOT_H
 
+#include "zoom_type.h"
+
 void InitializeScreenshotFormats();
 
 const char *GetCurrentScreenshotExtension();
@@ -30,6 +32,8 @@ bool MakeHeightmapScreenshot(const char *filename);
 void MakeScreenshotWithConfirm(ScreenshotType t);
 bool MakeScreenshot(ScreenshotType t, std::string name, uint32_t width = 0, uint32_t height = 0);
 bool MakeMinimapWorldScreenshot();
+bool MakeWorldImage(const std::string &filename, ZoomLevel zoom);
+bool MakeWorldTiles(std::string directory, ZoomLevel zoom);
 
 extern std::string _screenshot_format_name;
 extern std::string _full_screenshot_path;
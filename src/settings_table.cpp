@@ -29,6 +29,7 @@
 #define HAS_TRUETYPE_FONT
 #include "fontcache.h"
 #endif
+#include "sprite_disk_cache.h"
 #include "textbuf_gui.h"
 #include "rail_gui.h"
 #include "elrail_func.h"
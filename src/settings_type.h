@@ -172,6 +172,7 @@ struct GUISettings {
 	bool   autosave_on_network_disconnect;   ///< save an autosave when you get disconnected from a network game with an error?
 	uint8_t  date_format_in_default_names;     ///< should the default savegame/screenshot name use long dates (31th Dec 2008), short dates (31-12-2008) or ISO dates (2008-12-31)
 	uint8_t max_num_autosaves;                ///< controls how many autosavegames are made before the game starts to overwrite (names them 0 to max_num_autosaves - 1)
+	uint8_t autosave_journal_segments;        ///< how many incremental autosaves, that only save what changed since the previous autosave, are made between full autosaves (0 = none)
 	bool   population_in_label;              ///< show the population of a town in its label?
 	uint8_t  right_mouse_btn_emulation;        ///< should we emulate right mouse clicking?
 	uint8_t  scrollwheel_scrolling;            ///< scrolling using the scroll wheel?
@@ -302,6 +303,8 @@ struct NewsSettings {
 struct NetworkSettings {
 	uint16_t      sync_freq;                                ///< how often do we check whether we are still in-sync
 	uint8_t       frame_freq;                               ///< how often do we send commands to the clients
+	bool        adaptive_frame_freq;                      ///< raise frame_freq to the lead the clients need based on their measured lag
+	uint8_t       max_frame_freq;                           ///< upper limit of the frame_freq when it is adaptive
 	uint16_t      commands_per_frame;                       ///< how many commands may be sent each frame_freq frames?
 	uint16_t      commands_per_frame_server;                ///< how many commands may be sent each frame_freq frames? (server-originating commands)
 	uint16_t      max_commands_in_queue;                    ///< how many commands may there be in the incoming queue before dropping the connection?
@@ -316,6 +319,7 @@ struct NetworkSettings {
 	uint16_t      server_port;                              ///< port the server listens on
 	uint16_t      server_admin_port;                        ///< port the server listens on for the admin network
 	bool        server_admin_chat;                        ///< allow private chat for the server to be distributed to the admin network
+	uint16_t      admin_performance_interval;               ///< interval, in ticks, at which performance measurements are pushed to the admin network
 	ServerGameType server_game_type;                      ///< Server type: local / public / invite-only.
 	std::string server_invite_code;                       ///< Invite code to use when registering as server.
 	std::string server_invite_code_secret;                ///< Secret to proof we got this invite code from the Game Coordinator.
@@ -340,6 +344,8 @@ struct NetworkSettings {
 	uint16_t      restart_hours;                          ///< number of hours to run the server before automatic restart
 	uint8_t       min_active_clients;                       ///< minimum amount of active clients to unpause the game
 	bool        reload_cfg;                               ///< reload the config file before restarting
+	bool        threaded_encryption;                      ///< encrypt outgoing packets on a separate thread
+	bool        forked_map_save;                          ///< serialize the map for joining clients in a forked process
 	std::string last_joined;                              ///< Last joined server
 	UseRelayService use_relay_service;                    ///< Use relay service?
 	ParticipateSurvey participate_survey;                 ///< Participate in the automated survey
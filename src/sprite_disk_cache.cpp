@@ -0,0 +1,346 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file sprite_disk_cache.cpp Persistent cache of sprites encoded by the blitter.
+ *
+ * Loading a sprite means decoding it from its GRF file, making the missing zoom levels
+ * and encoding it for the blitter. After starting the game, or changing the blitter,
+ * that happens for every sprite the first time it is drawn, which makes the first
+ * minutes of play stutter. The sprite disk cache stores the encoded sprites in a file
+ * per blitter, so the next time they only have to be copied into the sprite cache.
+ * The file is mapped into memory when possible, so only the sprites that are used
+ * are read from disk.
+ *
+ * The file starts with the game version and zoom settings the sprites were encoded
+ * with; when those differ, the file is rebuilt. After that come the sprites, each
+ * with its key and a checksum of its data, so damaged sprites are never used. New
+ * sprites are appended when the game exits or the blitter changes, as long as the
+ * file does not grow beyond its maximum size.
+ */
+
+#include "stdafx.h"
+#include "debug.h"
+#include "fileio_func.h"
+#include "rev.h"
+#include "settings_type.h"
+#include "core/math_func.hpp"
+#include "zoom_type.h"
+#include "blitter/factory.hpp"
+#include "sprite_disk_cache.h"
+
+#include <filesystem>
+
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#endif
+
+#include "safeguards.h"
+
+uint _sprite_disk_cache_size = 0; ///< Maximum size of a sprite disk cache file in MiB; 0 disables the cache.
+
+/** Identification of a sprite disk cache file. */
+static const char SPRITE_DISK_CACHE_MAGIC[8] = { 'O', 'T', 'T', 'D', 'S', 'P', 'R', 'C' };
+/** Version of the format of the sprite disk cache file; this includes the byte order. */
+static const uint32_t SPRITE_DISK_CACHE_VERSION = 1;
+/** Alignment of the sprites in the sprite disk cache file. */
+static const size_t SPRITE_DISK_CACHE_ALIGNMENT = 8;
+
+/** Header of a sprite in the sprite disk cache file; it is followed by the encoded sprite. */
+struct SpriteDiskCacheRecord {
+	MD5Hash file_checksum; ///< Checksum of the GRF file the sprite is in.
+	uint32_t file_pos;     ///< Position of the sprite in the GRF file.
+	uint8_t type;          ///< Type of the sprite.
+	uint8_t control_flags; ///< Control flags of the sprite.
+	uint8_t palette_remap; ///< Whether the colours of the GRF file are remapped to the palette.
+	uint8_t padding;       ///< Unused.
+	uint32_t size;         ///< Size of the encoded sprite.
+	uint32_t checksum;     ///< Checksum of the encoded sprite.
+};
+static_assert(sizeof(SpriteDiskCacheRecord) == 32);
+
+/** Where a sprite in the sprite disk cache is. */
+struct SpriteDiskCacheEntry {
+	size_t offset; ///< Offset of the record of the sprite, in the file or in the added records.
+	bool added;    ///< Whether the sprite was added since the file was opened.
+	bool verified; ///< Whether the checksum of the sprite has been verified.
+};
+
+/** The sprite disk cache of the current blitter and zoom settings. */
+struct SpriteDiskCache {
+	std::string settings; ///< The game version, blitter and zoom settings the sprites are encoded with.
+	std::string filename; ///< The file the cache is stored in.
+	std::span<const uint8_t> contents; ///< Contents of the file, mapped into memory or read into #buffer.
+	std::vector<uint8_t> buffer;       ///< Contents of the file, when it could not be mapped into memory.
+	bool mapped = false;               ///< Whether #contents is mapped into memory.
+	size_t valid_size = 0;             ///< Size of the start of the file that is valid; 0 when the file has to be rebuilt.
+	std::map<SpriteDiskCacheKey, SpriteDiskCacheEntry> sprites; ///< The sprites in the cache.
+	std::vector<uint8_t> added;        ///< Records of the sprites added since the file was opened.
+	bool damaged = false;              ///< Whether the file has damaged sprites, so it has to be rebuilt.
+	bool full = false;                 ///< Whether the file reached its maximum size.
+
+	~SpriteDiskCache()
+	{
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+		if (this->mapped) munmap(const_cast<uint8_t *>(this->contents.data()), this->contents.size());
+#endif
+	}
+
+	void Read(FileHandle &file);
+	void ReadSprites();
+	std::span<const uint8_t> GetRecord(const SpriteDiskCacheEntry &entry) const;
+	void Write();
+};
+
+/** The sprite disk cache, once it has been used. */
+static std::unique_ptr<SpriteDiskCache> _sprite_disk_cache;
+
+/**
+ * Calculate the checksum of an encoded sprite.
+ * @param data The encoded sprite.
+ * @return The checksum.
+ */
+static uint32_t SpriteDiskCacheChecksum(std::span<const uint8_t> data)
+{
+	/* FNV-1a; it only has to catch damaged files. */
+	uint32_t checksum = 2166136261U;
+	for (uint8_t b : data) checksum = (checksum ^ b) * 16777619U;
+	return checksum;
+}
+
+/**
+ * Make the header of the sprite disk cache file.
+ * @param settings The game version, blitter and zoom settings the sprites are encoded with.
+ * @return The header, including the padding after it.
+ */
+static std::vector<uint8_t> MakeSpriteDiskCacheHeader(const std::string &settings)
+{
+	uint32_t version = SPRITE_DISK_CACHE_VERSION;
+	uint32_t length = static_cast<uint32_t>(settings.size());
+
+	std::vector<uint8_t> header(std::begin(SPRITE_DISK_CACHE_MAGIC), std::end(SPRITE_DISK_CACHE_MAGIC));
+	header.insert(header.end(), reinterpret_cast<const uint8_t *>(&version), reinterpret_cast<const uint8_t *>(&version + 1));
+	header.insert(header.end(), reinterpret_cast<const uint8_t *>(&length), reinterpret_cast<const uint8_t *>(&length + 1));
+	header.insert(header.end(), settings.begin(), settings.end());
+	header.resize(Align(header.size(), SPRITE_DISK_CACHE_ALIGNMENT));
+	return header;
+}
+
+/**
+ * Get the contents of the file into memory, by mapping it when possible.
+ * @param file The opened file.
+ */
+void SpriteDiskCache::Read(FileHandle &file)
+{
+#if defined(UNIX) && !defined(__EMSCRIPTEN__)
+	struct stat st;
+	if (fstat(fileno(file), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+		void *mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+		if (mapping != MAP_FAILED) {
+			this->contents = std::span<const uint8_t>(static_cast<const uint8_t *>(mapping), st.st_size);
+			this->mapped = true;
+			return;
+		}
+	}
+#endif
+
+	uint8_t buf[4096];
+	size_t len;
+	while ((len = fread(buf, 1, sizeof(buf), file)) != 0) this->buffer.insert(this->buffer.end(), buf, buf + len);
+	this->contents = this->buffer;
+}
+
+/** Find the sprites in the file, and check it is usable for the current settings. */
+void SpriteDiskCache::ReadSprites()
+{
+	std::vector<uint8_t> header = MakeSpriteDiskCacheHeader(this->settings);
+	if (this->contents.size() < header.size() || !std::equal(header.begin(), header.end(), this->contents.begin())) {
+		Debug(sprite, 1, "Sprite disk cache '{}' is for another game version, blitter or zoom settings; it will be rebuilt", this->filename);
+		return;
+	}
+	if (this->contents.size() > static_cast<size_t>(_sprite_disk_cache_size) * 1024 * 1024) {
+		Debug(sprite, 1, "Sprite disk cache '{}' is larger than allowed; it will be rebuilt", this->filename);
+		return;
+	}
+
+	size_t offset = header.size();
+	while (offset + sizeof(SpriteDiskCacheRecord) <= this->contents.size()) {
+		SpriteDiskCacheRecord record;
+		std::copy_n(this->contents.data() + offset, sizeof(record), reinterpret_cast<uint8_t *>(&record));
+
+		size_t end = offset + Align(sizeof(record) + record.size, SPRITE_DISK_CACHE_ALIGNMENT);
+		if (end > this->contents.size() || record.size == 0 || record.type >= to_underlying(SpriteType::Invalid)) break;
+
+		SpriteDiskCacheKey key{ record.file_checksum, record.file_pos, static_cast<SpriteType>(record.type), record.control_flags, record.palette_remap != 0 };
+		this->sprites[key] = { offset, false, false };
+		offset = end;
+	}
+
+	/* A partly written sprite at the end is dropped when the file is written the next time. */
+	this->valid_size = offset;
+	Debug(sprite, 1, "Sprite disk cache '{}' has {} sprites", this->filename, this->sprites.size());
+}
+
+/**
+ * Get the record of a sprite.
+ * @param entry Where the sprite is.
+ * @return The record, consisting of the header and the encoded sprite.
+ */
+std::span<const uint8_t> SpriteDiskCache::GetRecord(const SpriteDiskCacheEntry &entry) const
+{
+	std::span<const uint8_t> data = entry.added ? std::span<const uint8_t>(this->added) : this->contents;
+
+	SpriteDiskCacheRecord record;
+	std::copy_n(data.data() + entry.offset, sizeof(record), reinterpret_cast<uint8_t *>(&record));
+	return data.subspan(entry.offset, sizeof(record) + record.size);
+}
+
+/** Write the sprites that were added to the file; when the file is not valid, it is rebuilt with all sprites. */
+void SpriteDiskCache::Write()
+{
+	if (this->valid_size != 0 && this->valid_size == this->contents.size() && !this->damaged) {
+		if (this->added.empty()) return;
+
+		auto f = FileHandle::Open(this->filename, "ab");
+		if (!f.has_value() || fwrite(this->added.data(), 1, this->added.size(), *f) != this->added.size()) {
+			Debug(sprite, 0, "Could not write the sprite disk cache '{}'", this->filename);
+		}
+		return;
+	}
+
+	/* Write to another file first, as the sprites might still be read from the current one. */
+	std::string filename = this->filename + ".tmp";
+	{
+		auto f = FileHandle::Open(filename, "wb");
+		if (!f.has_value()) {
+			Debug(sprite, 0, "Could not write the sprite disk cache '{}'", this->filename);
+			return;
+		}
+
+		bool success = true;
+		std::vector<uint8_t> header = MakeSpriteDiskCacheHeader(this->settings);
+		success &= fwrite(header.data(), 1, header.size(), *f) == header.size();
+
+		static const uint8_t padding[SPRITE_DISK_CACHE_ALIGNMENT] = {};
+		for (const auto &[key, entry] : this->sprites) {
+			std::span<const uint8_t> record = this->GetRecord(entry);
+			success &= fwrite(record.data(), 1, record.size(), *f) == record.size();
+			size_t padding_size = Align(record.size(), SPRITE_DISK_CACHE_ALIGNMENT) - record.size();
+			success &= fwrite(padding, 1, padding_size, *f) == padding_size;
+		}
+
+		if (!success) {
+			Debug(sprite, 0, "Could not write the sprite disk cache '{}'", this->filename);
+			return;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(OTTD2FS(filename), OTTD2FS(this->filename), ec);
+	if (ec) Debug(sprite, 0, "Could not write the sprite disk cache '{}': {}", this->filename, ec.message());
+}
+
+/**
+ * Get the sprite disk cache for the current blitter and zoom settings, opening its file when needed.
+ * @return The sprite disk cache, or \c nullptr when it is disabled.
+ */
+static SpriteDiskCache *GetSpriteDiskCache()
+{
+	Blitter *blitter = BlitterFactory::GetCurrentBlitter();
+	if (_sprite_disk_cache_size == 0 || _personal_dir.empty() || blitter == nullptr) return nullptr;
+
+	std::string settings = fmt::format("{} {} {} {} {} {}", _openttd_revision, blitter->GetName(),
+			_settings_client.gui.zoom_min, _settings_client.gui.zoom_max, _settings_client.gui.sprite_zoom_min, _font_zoom);
+	if (_sprite_disk_cache != nullptr && _sprite_disk_cache->settings == settings) return _sprite_disk_cache.get();
+
+	/* The blitter or zoom settings changed; the sprites will all be encoded again. */
+	SaveSpriteDiskCache();
+
+	_sprite_disk_cache = std::make_unique<SpriteDiskCache>();
+	_sprite_disk_cache->settings = std::move(settings);
+	_sprite_disk_cache->filename = fmt::format("{}sprite_cache_{}.dat", _personal_dir, blitter->GetName());
+
+	auto f = FileHandle::Open(_sprite_disk_cache->filename, "rb");
+	if (f.has_value()) {
+		_sprite_disk_cache->Read(*f);
+		_sprite_disk_cache->ReadSprites();
+	}
+	return _sprite_disk_cache.get();
+}
+
+/**
+ * Find a sprite encoded by the current blitter in the sprite disk cache.
+ * @param key The sprite to find.
+ * @return The encoded sprite, or an empty span when it is not cached.
+ */
+std::span<const uint8_t> FindSpriteInDiskCache(const SpriteDiskCacheKey &key)
+{
+	SpriteDiskCache *cache = GetSpriteDiskCache();
+	if (cache == nullptr) return {};
+
+	auto it = cache->sprites.find(key);
+	if (it == cache->sprites.end()) return {};
+
+	std::span<const uint8_t> data = cache->GetRecord(it->second);
+	std::span<const uint8_t> sprite = data.subspan(sizeof(SpriteDiskCacheRecord));
+	if (!it->second.verified) {
+		SpriteDiskCacheRecord record;
+		std::copy_n(data.data(), sizeof(record), reinterpret_cast<uint8_t *>(&record));
+		if (SpriteDiskCacheChecksum(sprite) != record.checksum) {
+			Debug(sprite, 0, "Sprite disk cache '{}' is damaged; it will be rebuilt", cache->filename);
+			cache->sprites.erase(it);
+			cache->damaged = true;
+			return {};
+		}
+		it->second.verified = true;
+	}
+	return sprite;
+}
+
+/**
+ * Add a sprite encoded by the current blitter to the sprite disk cache.
+ * It is written to disk when the game exits, or when the blitter or zoom settings change.
+ * @param key The sprite to add.
+ * @param sprite The encoded sprite.
+ */
+void AddSpriteToDiskCache(const SpriteDiskCacheKey &key, std::span<const uint8_t> sprite)
+{
+	SpriteDiskCache *cache = GetSpriteDiskCache();
+	if (cache == nullptr || cache->full || sprite.empty() || cache->sprites.contains(key)) return;
+
+	size_t record_size = Align(sizeof(SpriteDiskCacheRecord) + sprite.size(), SPRITE_DISK_CACHE_ALIGNMENT);
+	size_t file_size = std::max(cache->valid_size, MakeSpriteDiskCacheHeader(cache->settings).size()) + cache->added.size();
+	if (file_size + record_size > static_cast<size_t>(_sprite_disk_cache_size) * 1024 * 1024) {
+		Debug(sprite, 1, "Sprite disk cache '{}' is full", cache->filename);
+		cache->full = true;
+		return;
+	}
+
+	SpriteDiskCacheRecord record{};
+	record.file_checksum = key.file_checksum;
+	record.file_pos = key.file_pos;
+	record.type = to_underlying(key.type);
+	record.control_flags = key.control_flags;
+	record.palette_remap = key.palette_remap ? 1 : 0;
+	record.size = static_cast<uint32_t>(sprite.size());
+	record.checksum = SpriteDiskCacheChecksum(sprite);
+
+	cache->sprites[key] = { cache->added.size(), true, true };
+	cache->added.insert(cache->added.end(), reinterpret_cast<const uint8_t *>(&record), reinterpret_cast<const uint8_t *>(&record + 1));
+	cache->added.insert(cache->added.end(), sprite.begin(), sprite.end());
+	cache->added.resize(cache->added.size() + record_size - sizeof(record) - sprite.size());
+}
+
+/** Write the sprites that were added to the sprite disk cache to disk, and close it. */
+void SaveSpriteDiskCache()
+{
+	if (_sprite_disk_cache == nullptr) return;
+
+	_sprite_disk_cache->Write();
+	_sprite_disk_cache.reset();
+}
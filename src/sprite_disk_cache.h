@@ -0,0 +1,33 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file sprite_disk_cache.h Persistent cache of sprites encoded by the blitter. */
+
+#ifndef SPRITE_DISK_CACHE_H
+#define SPRITE_DISK_CACHE_H
+
+#include "gfx_type.h"
+#include "3rdparty/md5/md5.h"
+
+/** What identifies an encoded sprite in the sprite disk cache; the blitter and zoom settings identify the whole cache. */
+struct SpriteDiskCacheKey {
+	MD5Hash file_checksum; ///< Checksum of the GRF file the sprite is in.
+	uint32_t file_pos;     ///< Position of the sprite in the GRF file.
+	SpriteType type;       ///< Type of the sprite.
+	uint8_t control_flags; ///< Control flags of the sprite, see #SpriteCacheCtrlFlags.
+	bool palette_remap;    ///< Whether the colours of the GRF file are remapped to the palette.
+
+	auto operator<=>(const SpriteDiskCacheKey &other) const = default;
+};
+
+extern uint _sprite_disk_cache_size;
+
+std::span<const uint8_t> FindSpriteInDiskCache(const SpriteDiskCacheKey &key);
+void AddSpriteToDiskCache(const SpriteDiskCacheKey &key, std::span<const uint8_t> sprite);
+void SaveSpriteDiskCache();
+
+#endif /* SPRITE_DISK_CACHE_H */
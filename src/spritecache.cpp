@@ -21,11 +21,16 @@
 #include "video/video_driver.hpp"
 #include "spritecache.h"
 #include "spritecache_internal.h"
+#include "sprite_disk_cache.h"
+#include "thread.h"
 
 #include "table/sprites.h"
 #include "table/strings.h"
 #include "table/palette_convert.h"
 
+#include <condition_variable>
+#include <unordered_map>
+
 #include "safeguards.h"
 
 /* Default of 4MB spritecache */
@@ -101,17 +106,10 @@ SpriteFile &OpenCachedSpriteFile(const std::string &filename, Subdirectory subdi
 	return *file;
 }
 
-struct MemBlock {
-	size_t size;
-	uint8_t data[];
-};
-
-static uint _sprite_lru_counter;
-static MemBlock *_spritecache_ptr;
-static uint _allocated_sprite_cache_size = 0;
-static int _compact_cache_counter;
+static bool _sprite_cache_read_only = false; ///< Whether sprites are being drawn by multiple threads, so the cache may not change.
+static SpriteCacheStats _sprite_cache_stats{}; ///< Statistics of the sprite cache.
 
-static void CompactSpriteCache();
+static void DeleteEntryFromSpriteCache(uint item);
 
 /**
  * Skip the given amount of sprite graphics data.
@@ -378,7 +376,7 @@ static bool PadSprites(SpriteLoader::SpriteCollection &sprite, uint8_t sprite_av
 	return true;
 }
 
-static bool ResizeSprites(SpriteLoader::SpriteCollection &sprite, uint8_t sprite_avail, SpriteEncoder *encoder)
+bool ResizeSprites(SpriteLoader::SpriteCollection &sprite, uint8_t sprite_avail, SpriteEncoder *encoder)
 {
 	/* Create a fully zoomed image if it does not exist */
 	ZoomLevel first_avail = static_cast<ZoomLevel>(FindFirstBit(sprite_avail));
@@ -450,19 +448,17 @@ static void *ReadRecolourSprite(SpriteFile &file, uint num, SpriteAllocator &all
 }
 
 /**
- * Read a sprite from disk.
+ * Read a sprite from disk, without falling back to another sprite when it cannot be loaded.
+ * This only uses the given file and encoder, so it may be called by other threads than the main one.
  * @param sc          Location of sprite.
  * @param id          Sprite number.
  * @param sprite_type Type of sprite.
  * @param allocator   Allocator function to use.
  * @param encoder     Sprite encoder to use.
- * @return Read sprite data.
+ * @return Read sprite data, or nullptr when the sprite could not be loaded.
  */
-static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_type, SpriteAllocator &allocator, SpriteEncoder *encoder)
+static void *DecodeSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_type, SpriteAllocator &allocator, SpriteEncoder *encoder)
 {
-	/* Use current blitter if no other sprite encoder is given. */
-	if (encoder == nullptr) encoder = BlitterFactory::GetCurrentBlitter();
-
 	SpriteFile &file = *sc->file;
 	size_t file_pos = sc->file_pos;
 
@@ -486,9 +482,8 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 	}
 
 	if (sprite_avail == 0) {
-		if (sprite_type == SpriteType::MapGen) return nullptr;
 		if (id == SPR_IMG_QUERY) UserError("Okay... something went horribly wrong. I couldn't load the fallback sprite. What should I do?");
-		return (void*)GetRawSprite(SPR_IMG_QUERY, SpriteType::Normal, &allocator, encoder);
+		return nullptr;
 	}
 
 	if (sprite_type == SpriteType::MapGen) {
@@ -521,7 +516,7 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 
 	if (!ResizeSprites(sprite, sprite_avail, encoder)) {
 		if (id == SPR_IMG_QUERY) UserError("Okay... something went horribly wrong. I couldn't resize the fallback sprite. What should I do?");
-		return (void*)GetRawSprite(SPR_IMG_QUERY, SpriteType::Normal, &allocator, encoder);
+		return nullptr;
 	}
 
 	if (sprite[ZOOM_LVL_MIN].type == SpriteType::Font && _font_zoom != ZOOM_LVL_MIN) {
@@ -537,6 +532,92 @@ static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_ty
 	return encoder->Encode(sprite, allocator);
 }
 
+/**
+ * Read a sprite from disk.
+ * @param sc          Location of sprite.
+ * @param id          Sprite number.
+ * @param sprite_type Type of sprite.
+ * @param allocator   Allocator function to use.
+ * @param encoder     Sprite encoder to use.
+ * @return Read sprite data.
+ */
+static void *ReadSprite(const SpriteCache *sc, SpriteID id, SpriteType sprite_type, SpriteAllocator &allocator, SpriteEncoder *encoder)
+{
+	/* Use current blitter if no other sprite encoder is given. */
+	if (encoder == nullptr) encoder = BlitterFactory::GetCurrentBlitter();
+
+	void *data = DecodeSprite(sc, id, sprite_type, allocator, encoder);
+	if (data != nullptr || sprite_type == SpriteType::MapGen) return data;
+
+	return GetRawSprite(SPR_IMG_QUERY, SpriteType::Normal, &allocator, encoder);
+}
+
+/** Allocator keeping track of what a sprite encoder allocated, so the encoded sprite can be stored in the sprite disk cache. */
+class RecordingSpriteAllocator : public SpriteAllocator {
+	SpriteAllocator &allocator; ///< The allocator doing the actual allocations.
+public:
+	void *ptr = nullptr; ///< The last allocated memory.
+	size_t size = 0;     ///< Size of the last allocated memory.
+
+	/**
+	 * Create the allocator.
+	 * @param allocator The allocator doing the actual allocations.
+	 */
+	RecordingSpriteAllocator(SpriteAllocator &allocator) : allocator(allocator) {}
+
+protected:
+	void *AllocatePtr(size_t size) override
+	{
+		this->ptr = this->allocator.Allocate<uint8_t>(size);
+		this->size = size;
+		return this->ptr;
+	}
+};
+
+/**
+ * Get what identifies a sprite in the sprite disk cache.
+ * @param sc          Location of sprite.
+ * @param sprite_type Type of sprite.
+ * @return The key of the sprite, or std::nullopt when the sprite is not kept in the sprite disk cache.
+ */
+static std::optional<SpriteDiskCacheKey> GetSpriteDiskCacheKey(const SpriteCache *sc, SpriteType sprite_type)
+{
+	/* Map generator sprites are not encoded, so there is nothing to gain. */
+	if (_sprite_disk_cache_size == 0 || sprite_type == SpriteType::MapGen || sc->file_pos == SIZE_MAX) return std::nullopt;
+
+	const std::optional<MD5Hash> &checksum = sc->file->GetChecksum();
+	if (!checksum.has_value()) return std::nullopt;
+
+	return SpriteDiskCacheKey{ *checksum, static_cast<uint32_t>(sc->file_pos), sprite_type, sc->control_flags, sc->file->NeedsPaletteRemap() };
+}
+
+/**
+ * Read a sprite for the sprite cache. When the sprite disk cache has the sprite encoded by the
+ * current blitter, it is copied from there; otherwise it is read from disk and added to it.
+ * @param sc          Location of sprite.
+ * @param id          Sprite number.
+ * @param sprite_type Type of sprite.
+ * @param allocator   Allocator function to use.
+ * @return Read sprite data.
+ */
+static void *ReadSpriteForCache(const SpriteCache *sc, SpriteID id, SpriteType sprite_type, SpriteAllocator &allocator)
+{
+	std::optional<SpriteDiskCacheKey> key = GetSpriteDiskCacheKey(sc, sprite_type);
+	if (!key.has_value()) return ReadSprite(sc, id, sprite_type, allocator, nullptr);
+
+	std::span<const uint8_t> cached = FindSpriteInDiskCache(*key);
+	if (!cached.empty()) {
+		uint8_t *data = allocator.Allocate<uint8_t>(cached.size());
+		std::copy(cached.begin(), cached.end(), data);
+		return data;
+	}
+
+	RecordingSpriteAllocator recorder(allocator);
+	void *data = ReadSprite(sc, id, sprite_type, recorder, nullptr);
+	if (data != nullptr && data == recorder.ptr) AddSpriteToDiskCache(*key, std::span(static_cast<const uint8_t *>(data), recorder.size));
+	return data;
+}
+
 struct GrfSpriteOffset {
 	size_t file_pos;
 	uint8_t control_flags;
@@ -673,10 +754,10 @@ bool LoadNextSprite(SpriteID load_index, SpriteFile &file, uint file_sprite_id)
 	}
 
 	SpriteCache *sc = AllocateSpriteCache(load_index);
+	if (sc->evictable) DeleteEntryFromSpriteCache(load_index);
 	sc->file = &file;
 	sc->file_pos = file_pos;
 	sc->ptr = data;
-	sc->lru = 0;
 	sc->id = file_sprite_id;
 	sc->type = type;
 	sc->warned = false;
@@ -689,6 +770,7 @@ bool LoadNextSprite(SpriteID load_index, SpriteFile &file, uint file_sprite_id)
 void DupSprite(SpriteID old_spr, SpriteID new_spr)
 {
 	SpriteCache *scnew = AllocateSpriteCache(new_spr); // may reallocate: so put it first
+	if (scnew->evictable) DeleteEntryFromSpriteCache(new_spr);
 	SpriteCache *scold = GetSpriteCache(old_spr);
 
 	scnew->file = scold->file;
@@ -700,106 +782,262 @@ void DupSprite(SpriteID old_spr, SpriteID new_spr)
 	scnew->control_flags = scold->control_flags;
 }
 
-/**
- * S_FREE_MASK is used to mask-out lower bits of MemBlock::size
- * If they are non-zero, the block is free.
- * S_FREE_MASK has to ensure MemBlock is correctly aligned -
- * it means 8B (S_FREE_MASK == 7) on 64bit systems!
+/*
+ * The sprite cache gets its memory from the system in slabs. Every slab is split in blocks
+ * of a single size class, and a block that is freed is reused for a sprite of the same size
+ * class. Slabs without blocks in use can be reused for any size class. Sprites that are too
+ * large for the size classes get memory of their own. Sprites are never moved, so the cache
+ * does not have to be compacted.
+ *
+ * Every size class has a list of its sprites, from least to most recently used. When the
+ * cache is at its budget, a new sprite takes the place of the least recently used sprite of
+ * its own size class, so a single block is freed rather than everything that is older. When
+ * the size class has no sprites, the cache may go a bit over its budget; #TrimSpriteCache
+ * brings it back within its budget a few sprites at a time.
  */
-static const size_t S_FREE_MASK = sizeof(size_t) - 1;
 
-/* to make sure nobody adds things to MemBlock without checking S_FREE_MASK first */
-static_assert(sizeof(MemBlock) == sizeof(size_t));
-/* make sure it's a power of two */
-static_assert((sizeof(size_t) & (sizeof(size_t) - 1)) == 0);
+static const size_t SPRITE_SLAB_SIZE = 256 * 1024; ///< Size of a slab; slabs are aligned to their size, so the slab of a block follows from its address.
+static const size_t SPRITE_SIZE_CLASS_MIN = 32; ///< Size of the smallest size class, including the header of the block.
+static const size_t SPRITE_SIZE_CLASS_MAX = SPRITE_SLAB_SIZE / 8; ///< Size of the largest size class; larger blocks get memory of their own.
+static const uint SPRITE_SIZE_CLASSES = 1 + 4 * (FindLastBit(SPRITE_SIZE_CLASS_MAX) - FindLastBit(SPRITE_SIZE_CLASS_MIN)); ///< Number of size classes; there are four of them for every doubling in size.
+static const uint SPRITE_LRU_LISTS = SPRITE_SIZE_CLASSES + 1; ///< Number of LRU lists; one per size class, and one for the sprites that are too large for those.
+static const SpriteID SPRITE_LRU_END = UINT32_MAX; ///< End of the LRU list.
+static const uint SPRITE_TRIM_EVICTIONS = 64; ///< Maximum number of sprites #TrimSpriteCache removes in one go.
+
+/** Header of a block of memory of the sprite cache. */
+struct SpriteBlock {
+	size_t size;            ///< Size of the block, including this header.
+	SpriteBlock *next_free; ///< Next free block in the slab, when this block is free; when it is in use, the sprite is stored from here.
+
+	/** Get the memory for the sprite. */
+	inline void *GetData() { return &this->next_free; }
+
+	/**
+	 * Get the block of the memory of a sprite.
+	 * @param data The memory of the sprite.
+	 * @return The block.
+	 */
+	static inline SpriteBlock *FromData(void *data) { return reinterpret_cast<SpriteBlock *>(static_cast<uint8_t *>(data) - offsetof(SpriteBlock, next_free)); }
+};
 
-static inline MemBlock *NextBlock(MemBlock *block)
-{
-	return (MemBlock*)((uint8_t*)block + (block->size & ~S_FREE_MASK));
-}
+/** Memory of a sprite that is too large for the size classes. */
+struct LargeSpriteBlock {
+	LargeSpriteBlock *prev; ///< Previous large block.
+	LargeSpriteBlock *next; ///< Next large block.
+	SpriteBlock block;      ///< The block of the sprite.
+};
 
-static size_t GetSpriteCacheUsage()
-{
-	size_t tot_size = 0;
-	MemBlock *s;
+/** Slab of memory of the sprite cache, split in blocks of a single size class. The blocks follow this header. */
+struct SpriteSlab {
+	SpriteSlab *prev;  ///< Previous slab in the list of slabs with free blocks of the size class.
+	SpriteSlab *next;  ///< Next slab in the list of slabs with free blocks of the size class, or in the list of empty slabs.
+	SpriteBlock *free; ///< First block that has been freed.
+	uint index;        ///< Index of the slab in #_sprite_slabs.
+	uint used;         ///< Number of blocks in use.
+	uint carved;       ///< Number of blocks that have been taken from the slab; the ones after those have never been used.
+	uint capacity;     ///< Number of blocks in the slab.
+	uint size_class;   ///< Size class of the blocks.
+
+	/**
+	 * Get the slab a block is in.
+	 * @param block The block.
+	 * @return The slab.
+	 */
+	static inline SpriteSlab *FromBlock(SpriteBlock *block) { return reinterpret_cast<SpriteSlab *>(reinterpret_cast<uintptr_t>(block) & ~(SPRITE_SLAB_SIZE - 1)); }
+
+	/** Whether all blocks of the slab are in use. */
+	inline bool IsFull() const { return this->used == this->capacity; }
+};
 
-	for (s = _spritecache_ptr; s->size != 0; s = NextBlock(s)) {
-		if (!(s->size & S_FREE_MASK)) tot_size += s->size;
-	}
+/** Offset of the first block in a slab. */
+static const size_t SPRITE_SLAB_HEADER_SIZE = Align(sizeof(SpriteSlab), 16);
 
-	return tot_size;
+/**
+ * Get the size of the blocks of a size class.
+ * @param size_class The size class.
+ * @return The size of the blocks, including their header.
+ */
+static constexpr size_t GetSizeOfSizeClass(uint size_class)
+{
+	if (size_class == 0) return SPRITE_SIZE_CLASS_MIN;
+	size_t base = SPRITE_SIZE_CLASS_MIN << ((size_class - 1) / 4);
+	return base + ((size_class - 1) % 4 + 1) * (base / 4);
 }
 
+static_assert(GetSizeOfSizeClass(SPRITE_SIZE_CLASSES - 1) == SPRITE_SIZE_CLASS_MAX);
+static_assert(SPRITE_SIZE_CLASS_MIN >= sizeof(SpriteBlock));
 
-void IncreaseSpriteLRU()
+/**
+ * Get the smallest size class of which the blocks can hold a number of bytes.
+ * @param size Number of bytes, including the header of the block; at most #SPRITE_SIZE_CLASS_MAX.
+ * @return The size class.
+ */
+static uint GetSizeClass(size_t size)
 {
-	/* Increase all LRU values */
-	if (_sprite_lru_counter > 16384) {
-		SpriteID i;
+	if (size <= SPRITE_SIZE_CLASS_MIN) return 0;
+	uint bit = FindLastBit(size - 1);
+	size_t base = static_cast<size_t>(1) << bit;
+	size_t step = base / 4;
+	return 4 * (bit - FindLastBit(SPRITE_SIZE_CLASS_MIN)) + static_cast<uint>((size - base + step - 1) / step);
+}
 
-		Debug(sprite, 5, "Fixing lru {}, inuse={}", _sprite_lru_counter, GetSpriteCacheUsage());
+static std::vector<SpriteSlab *> _sprite_slabs; ///< All slabs of the sprite cache.
+static std::array<SpriteSlab *, SPRITE_SIZE_CLASSES> _sprite_slabs_with_room{}; ///< Per size class the first slab with free blocks.
+static SpriteSlab *_empty_sprite_slabs = nullptr; ///< First slab without blocks in use.
+static LargeSpriteBlock *_large_sprite_blocks = nullptr; ///< First block that is too large for the size classes.
+/** LRU lists without sprites. */
+static constexpr std::array<SpriteID, SPRITE_LRU_LISTS> EMPTY_SPRITE_LRU_LISTS = [] {
+	std::array<SpriteID, SPRITE_LRU_LISTS> lists{};
+	lists.fill(SPRITE_LRU_END);
+	return lists;
+}();
+
+static std::array<SpriteID, SPRITE_LRU_LISTS> _sprite_lru_oldest = EMPTY_SPRITE_LRU_LISTS; ///< Per LRU list the least recently used sprite.
+static std::array<SpriteID, SPRITE_LRU_LISTS> _sprite_lru_newest = EMPTY_SPRITE_LRU_LISTS; ///< Per LRU list the most recently used sprite.
+static uint32_t _sprite_lru_clock = 0; ///< Incremented every time a sprite is used; compares the age of sprites in different LRU lists.
 
-		for (i = 0; i != _spritecache_items; i++) {
-			SpriteCache *sc = GetSpriteCache(i);
-			if (sc->ptr != nullptr) {
-				if (sc->lru >= 0) {
-					sc->lru = -1;
-				} else if (sc->lru != -32768) {
-					sc->lru--;
-				}
-			}
-		}
-		_sprite_lru_counter = 0;
-	}
+/**
+ * Get the LRU list of a sprite in the cache.
+ * @param sc The sprite.
+ * @return Index of the LRU list; the size class of the sprite, or #SPRITE_SIZE_CLASSES for sprites that are too large for the size classes.
+ */
+static uint GetSpriteLRUList(const SpriteCache *sc)
+{
+	size_t size = SpriteBlock::FromData(sc->ptr)->size;
+	return size > SPRITE_SIZE_CLASS_MAX ? SPRITE_SIZE_CLASSES : GetSizeClass(size);
+}
 
-	/* Compact sprite cache every now and then. */
-	if (++_compact_cache_counter >= 740) {
-		CompactSpriteCache();
-		_compact_cache_counter = 0;
+/**
+ * Remove a sprite from its LRU list.
+ * @param item The sprite.
+ */
+static void UnlinkSpriteLRU(SpriteID item)
+{
+	SpriteCache *sc = GetSpriteCache(item);
+	uint list = GetSpriteLRUList(sc);
+	if (sc->lru_older != SPRITE_LRU_END) {
+		GetSpriteCache(sc->lru_older)->lru_newer = sc->lru_newer;
+	} else {
+		_sprite_lru_oldest[list] = sc->lru_newer;
+	}
+	if (sc->lru_newer != SPRITE_LRU_END) {
+		GetSpriteCache(sc->lru_newer)->lru_older = sc->lru_older;
+	} else {
+		_sprite_lru_newest[list] = sc->lru_older;
 	}
 }
 
 /**
- * Called when holes in the sprite cache should be removed.
- * That is accomplished by moving the cached data.
+ * Add a sprite to its LRU list, as the most recently used sprite.
+ * @param item The sprite.
  */
-static void CompactSpriteCache()
+static void LinkSpriteLRU(SpriteID item)
 {
-	MemBlock *s;
+	SpriteCache *sc = GetSpriteCache(item);
+	uint list = GetSpriteLRUList(sc);
+	sc->lru_used = _sprite_lru_clock++;
+	sc->lru_older = _sprite_lru_newest[list];
+	sc->lru_newer = SPRITE_LRU_END;
+	if (_sprite_lru_newest[list] != SPRITE_LRU_END) {
+		GetSpriteCache(_sprite_lru_newest[list])->lru_newer = item;
+	} else {
+		_sprite_lru_oldest[list] = item;
+	}
+	_sprite_lru_newest[list] = item;
+}
 
-	Debug(sprite, 3, "Compacting sprite cache, inuse={}", GetSpriteCacheUsage());
+/**
+ * Make a sprite the most recently used sprite of its LRU list.
+ * @param item The sprite.
+ */
+static void TouchSpriteLRU(SpriteID item)
+{
+	SpriteCache *sc = GetSpriteCache(item);
+	if (sc->lru_newer == SPRITE_LRU_END) {
+		sc->lru_used = _sprite_lru_clock++;
+		return;
+	}
+	UnlinkSpriteLRU(item);
+	LinkSpriteLRU(item);
+}
 
-	for (s = _spritecache_ptr; s->size != 0;) {
-		if (s->size & S_FREE_MASK) {
-			MemBlock *next = NextBlock(s);
-			MemBlock temp;
-			SpriteID i;
+/**
+ * Add a slab to the list of slabs with free blocks of its size class.
+ * @param slab The slab.
+ */
+static void LinkSpriteSlab(SpriteSlab *slab)
+{
+	SpriteSlab *&first = _sprite_slabs_with_room[slab->size_class];
+	slab->prev = nullptr;
+	slab->next = first;
+	if (first != nullptr) first->prev = slab;
+	first = slab;
+}
 
-			/* Since free blocks are automatically coalesced, this should hold true. */
-			assert(!(next->size & S_FREE_MASK));
+/**
+ * Remove a slab from the list of slabs with free blocks of its size class.
+ * @param slab The slab.
+ */
+static void UnlinkSpriteSlab(SpriteSlab *slab)
+{
+	if (slab->prev != nullptr) {
+		slab->prev->next = slab->next;
+	} else {
+		_sprite_slabs_with_room[slab->size_class] = slab->next;
+	}
+	if (slab->next != nullptr) slab->next->prev = slab->prev;
+}
 
-			/* If the next block is the sentinel block, we can safely return */
-			if (next->size == 0) break;
+/**
+ * Return an empty slab to the system.
+ * @param slab The slab.
+ */
+static void ReleaseSpriteSlab(SpriteSlab *slab)
+{
+	_sprite_slabs[slab->index] = _sprite_slabs.back();
+	_sprite_slabs[slab->index]->index = slab->index;
+	_sprite_slabs.pop_back();
 
-			/* Locate the sprite belonging to the next pointer. */
-			for (i = 0; GetSpriteCache(i)->ptr != next->data; i++) {
-				assert(i != _spritecache_items);
-			}
+	::operator delete(slab, std::align_val_t{SPRITE_SLAB_SIZE});
+	_sprite_cache_stats.allocated -= SPRITE_SLAB_SIZE;
+}
 
-			GetSpriteCache(i)->ptr = s->data; // Adjust sprite array entry
-			/* Swap this and the next block */
-			temp = *s;
-			memmove(s, next, next->size);
-			s = NextBlock(s);
-			*s = temp;
+/**
+ * Free the memory of a sprite.
+ * @param data The memory of the sprite.
+ */
+static void FreeSpriteMemory(void *data)
+{
+	SpriteBlock *block = SpriteBlock::FromData(data);
+	_sprite_cache_stats.used -= block->size;
 
-			/* Coalesce free blocks */
-			while (NextBlock(s)->size & S_FREE_MASK) {
-				s->size += NextBlock(s)->size & ~S_FREE_MASK;
-			}
+	if (block->size > SPRITE_SIZE_CLASS_MAX) {
+		LargeSpriteBlock *large = reinterpret_cast<LargeSpriteBlock *>(reinterpret_cast<uint8_t *>(block) - offsetof(LargeSpriteBlock, block));
+		if (large->prev != nullptr) {
+			large->prev->next = large->next;
 		} else {
-			s = NextBlock(s);
+			_large_sprite_blocks = large->next;
 		}
+		if (large->next != nullptr) large->next->prev = large->prev;
+
+		_sprite_cache_stats.allocated -= block->size;
+		delete[] reinterpret_cast<uint8_t *>(large);
+		return;
+	}
+
+	SpriteSlab *slab = SpriteSlab::FromBlock(block);
+	bool was_full = slab->IsFull();
+	block->next_free = slab->free;
+	slab->free = block;
+	slab->used--;
+
+	if (slab->used == 0) {
+		/* The slab is free to be used for any size class. */
+		if (!was_full) UnlinkSpriteSlab(slab);
+		slab->next = _empty_sprite_slabs;
+		_empty_sprite_slabs = slab;
+	} else if (was_full) {
+		LinkSpriteSlab(slab);
 	}
 }
 
@@ -809,79 +1047,245 @@ static void CompactSpriteCache()
  */
 static void DeleteEntryFromSpriteCache(uint item)
 {
-	/* Mark the block as free (the block must be in use) */
-	MemBlock *s = (MemBlock*)GetSpriteCache(item)->ptr - 1;
-	assert(!(s->size & S_FREE_MASK));
-	s->size |= S_FREE_MASK;
-	GetSpriteCache(item)->ptr = nullptr;
-
-	/* And coalesce adjacent free blocks */
-	for (s = _spritecache_ptr; s->size != 0; s = NextBlock(s)) {
-		if (s->size & S_FREE_MASK) {
-			while (NextBlock(s)->size & S_FREE_MASK) {
-				s->size += NextBlock(s)->size & ~S_FREE_MASK;
-			}
+	SpriteCache *sc = GetSpriteCache(item);
+	assert(sc->evictable && sc->ptr != nullptr);
+
+	UnlinkSpriteLRU(item);
+	FreeSpriteMemory(sc->ptr);
+	sc->ptr = nullptr;
+	sc->evictable = false;
+}
+
+/**
+ * Remove the least recently used sprite of an LRU list from the sprite cache.
+ * @param list The LRU list.
+ * @return False iff there was no sprite to remove.
+ */
+static bool EvictSpriteFromSpriteCache(uint list)
+{
+	SpriteID item = _sprite_lru_oldest[list];
+	if (item == SPRITE_LRU_END) return false;
+
+	Debug(sprite, 4, "Evicting sprite {}, inuse={}", item, _sprite_cache_stats.used);
+	DeleteEntryFromSpriteCache(item);
+	_sprite_cache_stats.evictions++;
+	return true;
+}
+
+/**
+ * Remove the least recently used sprite of all LRU lists from the sprite cache.
+ * @return False iff there was no sprite to remove.
+ */
+static bool EvictSpriteFromSpriteCache()
+{
+	uint oldest = SPRITE_LRU_LISTS;
+	uint32_t oldest_age = 0;
+	for (uint list = 0; list < SPRITE_LRU_LISTS; list++) {
+		if (_sprite_lru_oldest[list] == SPRITE_LRU_END) continue;
+
+		/* The clock may have wrapped around; the age of a sprite does not. */
+		uint32_t age = _sprite_lru_clock - GetSpriteCache(_sprite_lru_oldest[list])->lru_used;
+		if (oldest == SPRITE_LRU_LISTS || age > oldest_age) {
+			oldest = list;
+			oldest_age = age;
 		}
 	}
+	return oldest != SPRITE_LRU_LISTS && EvictSpriteFromSpriteCache(oldest);
 }
 
-static void DeleteEntryFromSpriteCache()
+/**
+ * Return a slab without blocks in use to the system.
+ * @return False iff there was no such slab.
+ */
+static bool ReleaseEmptySpriteSlab()
 {
-	uint best = UINT_MAX;
-	int cur_lru;
+	SpriteSlab *slab = _empty_sprite_slabs;
+	if (slab == nullptr) return false;
 
-	Debug(sprite, 3, "DeleteEntryFromSpriteCache, inuse={}", GetSpriteCacheUsage());
+	_empty_sprite_slabs = slab->next;
+	ReleaseSpriteSlab(slab);
+	return true;
+}
 
-	cur_lru = 0xffff;
-	for (SpriteID i = 0; i != _spritecache_items; i++) {
-		SpriteCache *sc = GetSpriteCache(i);
-		if (sc->type != SpriteType::Recolour && sc->ptr != nullptr && sc->lru < cur_lru) {
-			cur_lru = sc->lru;
-			best = i;
-		}
+/**
+ * Make room in the budget of the sprite cache for a sprite that is too large for the size
+ * classes, by removing other such sprites from the cache, returning empty slabs to the system,
+ * and finally removing any sprite from the cache. When there is nothing left to remove, the
+ * cache goes over its budget rather than failing.
+ * @param size Number of bytes to make room for.
+ */
+static void MakeRoomInSpriteCache(size_t size)
+{
+	while (_sprite_cache_stats.allocated + size > _sprite_cache_stats.budget) {
+		if (!EvictSpriteFromSpriteCache(SPRITE_SIZE_CLASSES) && !ReleaseEmptySpriteSlab() && !EvictSpriteFromSpriteCache()) return;
 	}
+}
 
-	/* Display an error message and die, in case we found no sprite at all.
-	 * This shouldn't really happen, unless all sprites are locked. */
-	if (best == UINT_MAX) FatalError("Out of sprite memory");
+/**
+ * Get how far the sprite cache may go over its budget for a new slab, when there is no
+ * sprite of the size class of the slab to make room for it.
+ * @return Number of bytes.
+ */
+static size_t GetSpriteCacheOverBudgetAllowance()
+{
+	return std::max(SPRITE_SLAB_SIZE, _sprite_cache_stats.budget / 8);
+}
 
-	DeleteEntryFromSpriteCache(best);
+/**
+ * Handle the system not having the memory the sprite cache asked for. The budget of
+ * the cache is lowered to what the cache got so far, and sprites are removed from it.
+ */
+static void HandleSpriteCacheOutOfMemory()
+{
+	if (_sprite_cache_stats.budget > _sprite_cache_stats.allocated) {
+		Debug(misc, 0, "Not enough memory to allocate {} MiB of spritecache. Spritecache was reduced to {} MiB.", _sprite_cache_stats.budget / 1024 / 1024, _sprite_cache_stats.allocated / 1024 / 1024);
+
+		ErrorMessageData msg(STR_CONFIG_ERROR_OUT_OF_MEMORY, STR_CONFIG_ERROR_SPRITECACHE_TOO_BIG);
+		msg.SetDParam(0, _sprite_cache_stats.budget);
+		msg.SetDParam(1, _sprite_cache_stats.allocated);
+		ScheduleErrorMessage(msg);
+
+		_sprite_cache_stats.budget = _sprite_cache_stats.allocated;
+	}
+
+	/* Display an error message and die, in case there is nothing to give back to the system.
+	 * This shouldn't really happen, unless all sprites are locked. */
+	if (!ReleaseEmptySpriteSlab() && !EvictSpriteFromSpriteCache()) FatalError("Out of sprite memory");
 }
 
-void *CacheSpriteAllocator::AllocatePtr(size_t mem_req)
+/**
+ * Get memory of its own for a sprite that is too large for the size classes.
+ * @param size Number of bytes needed, including the header of the block.
+ * @return The block.
+ */
+static SpriteBlock *AllocateLargeSpriteBlock(size_t size)
 {
-	mem_req += sizeof(MemBlock);
+	size += offsetof(LargeSpriteBlock, block);
+
+	for (;;) {
+		MakeRoomInSpriteCache(size);
+
+		LargeSpriteBlock *large = reinterpret_cast<LargeSpriteBlock *>(new(std::nothrow) uint8_t[size]);
+		if (large == nullptr) {
+			HandleSpriteCacheOutOfMemory();
+			continue;
+		}
 
-	/* Align this to correct boundary. This also makes sure at least one
-	 * bit is not used, so we can use it for other things. */
-	mem_req = Align(mem_req, S_FREE_MASK + 1);
+		large->prev = nullptr;
+		large->next = _large_sprite_blocks;
+		if (large->next != nullptr) large->next->prev = large;
+		_large_sprite_blocks = large;
 
+		large->block.size = size;
+		_sprite_cache_stats.allocated += size;
+		return &large->block;
+	}
+}
+
+/**
+ * Get a slab with free blocks of a size class.
+ * @param size_class The size class.
+ * @return The slab.
+ */
+static SpriteSlab *GetSpriteSlab(uint size_class)
+{
 	for (;;) {
-		MemBlock *s;
-
-		for (s = _spritecache_ptr; s->size != 0; s = NextBlock(s)) {
-			if (s->size & S_FREE_MASK) {
-				size_t cur_size = s->size & ~S_FREE_MASK;
-
-				/* Is the block exactly the size we need or
-				 * big enough for an additional free block? */
-				if (cur_size == mem_req ||
-						cur_size >= mem_req + sizeof(MemBlock)) {
-					/* Set size and in use */
-					s->size = mem_req;
-
-					/* Do we need to inject a free block too? */
-					if (cur_size != mem_req) {
-						NextBlock(s)->size = (cur_size - mem_req) | S_FREE_MASK;
-					}
+		if (_sprite_slabs_with_room[size_class] != nullptr) return _sprite_slabs_with_room[size_class];
 
-					return s->data;
-				}
+		SpriteSlab *slab = _empty_sprite_slabs;
+		if (slab != nullptr) {
+			_empty_sprite_slabs = slab->next;
+		} else {
+			/* At the budget, take the place of the least recently used sprite of this size class.
+			 * Without such a sprite, go over the budget for a while; #TrimSpriteCache gets the
+			 * cache back within it. Only remove the least recently used sprites of all size
+			 * classes until a slab is freed, when the cache is too far over its budget. */
+			if (_sprite_cache_stats.allocated + SPRITE_SLAB_SIZE > _sprite_cache_stats.budget) {
+				if (EvictSpriteFromSpriteCache(size_class)) continue;
+				if (_sprite_cache_stats.allocated + SPRITE_SLAB_SIZE > _sprite_cache_stats.budget + GetSpriteCacheOverBudgetAllowance() && EvictSpriteFromSpriteCache()) continue;
 			}
+
+			slab = static_cast<SpriteSlab *>(::operator new(SPRITE_SLAB_SIZE, std::align_val_t{SPRITE_SLAB_SIZE}, std::nothrow));
+			if (slab == nullptr) {
+				HandleSpriteCacheOutOfMemory();
+				continue;
+			}
+
+			slab->index = static_cast<uint>(_sprite_slabs.size());
+			_sprite_slabs.push_back(slab);
+			_sprite_cache_stats.allocated += SPRITE_SLAB_SIZE;
 		}
 
-		/* Reached sentinel, but no block found yet. Delete some old entry. */
-		DeleteEntryFromSpriteCache();
+		slab->free = nullptr;
+		slab->used = 0;
+		slab->carved = 0;
+		slab->size_class = size_class;
+		slab->capacity = static_cast<uint>((SPRITE_SLAB_SIZE - SPRITE_SLAB_HEADER_SIZE) / GetSizeOfSizeClass(size_class));
+		LinkSpriteSlab(slab);
+		return slab;
+	}
+}
+
+void *CacheSpriteAllocator::AllocatePtr(size_t mem_req)
+{
+	mem_req += offsetof(SpriteBlock, next_free);
+
+	SpriteBlock *block;
+	if (mem_req > SPRITE_SIZE_CLASS_MAX) {
+		block = AllocateLargeSpriteBlock(mem_req);
+	} else {
+		SpriteSlab *slab = GetSpriteSlab(GetSizeClass(mem_req));
+		if (slab->free != nullptr) {
+			block = slab->free;
+			slab->free = block->next_free;
+		} else {
+			block = reinterpret_cast<SpriteBlock *>(reinterpret_cast<uint8_t *>(slab) + SPRITE_SLAB_HEADER_SIZE + slab->carved * GetSizeOfSizeClass(slab->size_class));
+			slab->carved++;
+		}
+		block->size = GetSizeOfSizeClass(slab->size_class);
+
+		slab->used++;
+		if (slab->IsFull()) UnlinkSpriteSlab(slab);
+	}
+
+	_sprite_cache_stats.used += block->size;
+	return block->GetData();
+}
+
+/** Return all memory of the sprite cache to the system; the sprites in the cache are lost. */
+static void FreeSpriteCacheMemory()
+{
+	for (SpriteSlab *slab : _sprite_slabs) ::operator delete(slab, std::align_val_t{SPRITE_SLAB_SIZE});
+	_sprite_slabs.clear();
+	_sprite_slabs_with_room.fill(nullptr);
+	_empty_sprite_slabs = nullptr;
+
+	while (_large_sprite_blocks != nullptr) {
+		LargeSpriteBlock *large = _large_sprite_blocks;
+		_large_sprite_blocks = large->next;
+		delete[] reinterpret_cast<uint8_t *>(large);
+	}
+
+	_sprite_lru_oldest = EMPTY_SPRITE_LRU_LISTS;
+	_sprite_lru_newest = EMPTY_SPRITE_LRU_LISTS;
+	_sprite_cache_stats.used = 0;
+	_sprite_cache_stats.allocated = 0;
+}
+
+/**
+ * Bring the sprite cache back within its budget, after it went over it for lack of sprites of
+ * the size class that was needed. Empty slabs are returned to the system first; after that,
+ * the least recently used sprites are removed, a limited number per call so a single frame
+ * does not pay for all of them.
+ */
+void TrimSpriteCache()
+{
+	if (_sprite_cache_read_only) return;
+
+	uint evictions = 0;
+	while (_sprite_cache_stats.allocated > _sprite_cache_stats.budget) {
+		if (ReleaseEmptySpriteSlab()) continue;
+		if (evictions++ == SPRITE_TRIM_EVICTIONS || !EvictSpriteFromSpriteCache()) return;
 	}
 }
 
@@ -970,15 +1374,30 @@ void *GetRawSprite(SpriteID sprite, SpriteType type, SpriteAllocator *allocator,
 	if (sc->type != type) return HandleInvalidSpriteRequest(sprite, type, sc, allocator);
 
 	if (allocator == nullptr && encoder == nullptr) {
-		/* Load sprite into/from spritecache */
-		CacheSpriteAllocator cache_allocator;
+		if (_sprite_cache_read_only) {
+			/* All sprites have been loaded before; the LRU has been updated then too. */
+			assert(sc->ptr != nullptr);
+			return sc->ptr;
+		}
 
-		/* Update LRU */
-		sc->lru = ++_sprite_lru_counter;
+		if (sc->ptr != nullptr) {
+			_sprite_cache_stats.hits++;
 
-		/* Load the sprite, if it is not loaded, yet */
-		if (sc->ptr == nullptr) sc->ptr = ReadSprite(sc, sprite, type, cache_allocator, nullptr);
+			/* Make it the most recently used sprite. */
+			if (sc->evictable) TouchSpriteLRU(sprite);
+			return sc->ptr;
+		}
 
+		/* Load the sprite into the spritecache */
+		_sprite_cache_stats.misses++;
+		CacheSpriteAllocator cache_allocator;
+		sc->ptr = ReadSpriteForCache(sc, sprite, type, cache_allocator);
+
+		/* Recolour sprites are needed all the time, so they stay in the cache. */
+		if (type != SpriteType::Recolour) {
+			sc->evictable = true;
+			LinkSpriteLRU(sprite);
+		}
 		return sc->ptr;
 	} else {
 		/* Do not use the spritecache, but a different allocator. */
@@ -987,55 +1406,342 @@ void *GetRawSprite(SpriteID sprite, SpriteType type, SpriteAllocator *allocator,
 }
 
 
-static void GfxInitSpriteCache()
+/**
+ * Check whether a sprite is in the sprite cache, so getting it does not change the cache.
+ * @param sprite Sprite to check.
+ * @param type Expected sprite type.
+ * @return True iff the sprite is in the cache; false when it is not, or when it is requested with the wrong type.
+ */
+bool IsSpriteCached(SpriteID sprite, SpriteType type)
 {
-	/* initialize sprite cache heap */
-	int bpp = BlitterFactory::GetCurrentBlitter()->GetScreenDepth();
-	uint target_size = (bpp > 0 ? _sprite_cache_size * bpp / 8 : 1) * 1024 * 1024;
+	if (!SpriteExists(sprite)) sprite = SPR_IMG_QUERY;
 
-	/* Remember 'target_size' from the previous allocation attempt, so we do not try to reach the target_size multiple times in case of failure. */
-	static uint last_alloc_attempt = 0;
+	const SpriteCache *sc = GetSpriteCache(sprite);
+	return sc->type == type && sc->ptr != nullptr;
+}
 
-	if (_spritecache_ptr == nullptr || (_allocated_sprite_cache_size != target_size && target_size != last_alloc_attempt)) {
-		delete[] reinterpret_cast<uint8_t *>(_spritecache_ptr);
+/**
+ * Allow or disallow changes to the sprite cache. While the cache is read-only, sprites may
+ * be got by multiple threads at the same time, but only sprites that are in the cache, see
+ * #IsSpriteCached, may be got, and the LRU of the sprites is not updated.
+ * @param read_only Whether the cache is read-only.
+ */
+void SetSpriteCacheReadOnly(bool read_only)
+{
+	_sprite_cache_read_only = read_only;
+}
+
+/**
+ * Get the statistics of the sprite cache.
+ * @return The statistics.
+ */
+const SpriteCacheStats &GetSpriteCacheStats()
+{
+	return _sprite_cache_stats;
+}
+
+/** A sprite the sprite loader thread has to load. */
+struct SpriteLoadRequest {
+	SpriteID id;          ///< The sprite to load.
+	SpriteCache sc;       ///< Copy of the sprite cache entry of the sprite, i.e. where to load it from.
+	std::string filename; ///< Name of the file the sprite is in.
+	Subdirectory subdir;  ///< The sub directory the file was searched in.
+	bool palette_remap;   ///< Whether the colours of the file have to be remapped to the palette.
+	std::string blitter;  ///< Name of the blitter to encode the sprite for.
+	uint generation;      ///< Generation of the sprite cache the sprite is loaded for.
+};
+
+/** A sprite the sprite loader thread has loaded. */
+struct LoadedSprite {
+	SpriteID id;                     ///< The loaded sprite.
+	const SpriteFile *file;          ///< The file of the sprite in the sprite cache, when it was requested.
+	size_t file_pos;                 ///< Position of the sprite in the file.
+	uint generation;                 ///< Generation of the sprite cache the sprite is loaded for.
+	std::unique_ptr<uint8_t[]> data; ///< The encoded sprite, or nullptr when it could not be loaded.
+	size_t size;                     ///< Size of the encoded sprite.
+};
 
-		last_alloc_attempt = target_size;
-		_allocated_sprite_cache_size = target_size;
+/**
+ * Thread reading and encoding sprites in the background, so drawing does not have to wait for them.
+ * It has its own files and sprite encoder, so it does not touch anything the main thread uses.
+ */
+class SpriteLoaderThread {
+	std::thread thread;                      ///< The thread, once it is started.
+	bool started = false;                    ///< Whether starting the thread has been tried.
+	std::mutex mutex;                        ///< Lock for the members below, up to the ones of the thread itself.
+	std::condition_variable requested;       ///< Signalled when sprites are requested, or when the thread has to exit.
+	std::deque<SpriteLoadRequest> urgent;    ///< Sprites needed for drawing right now.
+	std::deque<SpriteLoadRequest> prefetch;  ///< Sprites that are likely to be needed soon.
+	std::vector<LoadedSprite> loaded;        ///< Sprites that have been loaded, but not yet added to the sprite cache.
+	bool exit = false;                       ///< Whether the thread has to exit.
+
+	/* Only used by the thread itself. */
+	std::vector<std::unique_ptr<SpriteFile>> files; ///< The files sprites have been read from.
+	uint files_generation = 0;                      ///< Generation of the sprite cache the files have been opened for.
+	std::unique_ptr<Blitter> encoder;               ///< The blitter sprites are encoded for.
+
+	static const size_t MAX_PREFETCH = 4096; ///< Maximum number of sprites waiting to be prefetched.
+
+	/**
+	 * Get the file a sprite has to be read from, opening it when needed.
+	 * @param request The sprite to read.
+	 * @return The file.
+	 */
+	SpriteFile &GetFile(const SpriteLoadRequest &request)
+	{
+		/* The files might have changed on disk when the sprites were reloaded. */
+		if (request.generation != this->files_generation) {
+			this->files.clear();
+			this->files_generation = request.generation;
+		}
 
-		do {
-			/* Try to allocate 50% more to make sure we do not allocate almost all available. */
-			_spritecache_ptr = reinterpret_cast<MemBlock *>(new(std::nothrow) uint8_t[_allocated_sprite_cache_size + _allocated_sprite_cache_size / 2]);
+		for (auto &f : this->files) {
+			if (f->GetFilename() == request.filename) return *f;
+		}
+		return *this->files.emplace_back(std::make_unique<SpriteFile>(request.filename, request.subdir, request.palette_remap));
+	}
 
-			if (_spritecache_ptr != nullptr) {
-				/* Allocation succeeded, but we wanted less. */
-				delete[] reinterpret_cast<uint8_t *>(_spritecache_ptr);
-				_spritecache_ptr = reinterpret_cast<MemBlock *>(new uint8_t[_allocated_sprite_cache_size]);
-			} else if (_allocated_sprite_cache_size < 2 * 1024 * 1024) {
-				UserError("Cannot allocate spritecache");
+	/**
+	 * Read and encode a sprite.
+	 * @param request The sprite to load.
+	 * @return The loaded sprite.
+	 */
+	LoadedSprite Load(SpriteLoadRequest &request)
+	{
+		LoadedSprite sprite{ request.id, request.sc.file, request.sc.file_pos, request.generation, nullptr, 0 };
+
+		if (this->encoder == nullptr || this->encoder->GetName() != request.blitter) {
+			this->encoder.reset(BlitterFactory::GetBlitterFactory(request.blitter)->CreateInstance());
+		}
+		request.sc.file = &this->GetFile(request);
+
+		UniquePtrSpriteAllocator allocator;
+		RecordingSpriteAllocator recorder(allocator);
+		void *data = DecodeSprite(&request.sc, request.id, SpriteType::Normal, recorder, this->encoder.get());
+		if (data != nullptr && data == recorder.ptr) {
+			sprite.data = std::move(allocator.data);
+			sprite.size = recorder.size;
+		}
+		return sprite;
+	}
+
+	/** Main loop of the thread: load the requested sprites, the urgent ones first. */
+	void Run()
+	{
+		std::unique_lock<std::mutex> lock(this->mutex);
+		for (;;) {
+			this->requested.wait(lock, [this]() { return this->exit || !this->urgent.empty() || !this->prefetch.empty(); });
+			if (this->exit) return;
+
+			std::deque<SpriteLoadRequest> &queue = this->urgent.empty() ? this->prefetch : this->urgent;
+			SpriteLoadRequest request = std::move(queue.front());
+			queue.pop_front();
+
+			lock.unlock();
+			LoadedSprite sprite = this->Load(request);
+			lock.lock();
+
+			this->loaded.push_back(std::move(sprite));
+		}
+	}
+
+public:
+	~SpriteLoaderThread()
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->exit = true;
+		}
+		this->requested.notify_one();
+
+		if (this->thread.joinable()) this->thread.join();
+	}
+
+	/**
+	 * Request a sprite to be loaded.
+	 * @param request The sprite to load.
+	 * @param prefetch Whether the sprite is only likely to be needed soon, instead of right now.
+	 * @return True iff the sprite is going to be loaded; false when the thread cannot be started, or when there are too many sprites waiting to be prefetched.
+	 */
+	bool Request(SpriteLoadRequest &&request, bool prefetch)
+	{
+		if (!this->started) {
+			this->started = true;
+			StartNewThread(&this->thread, "ottd:sprites", [this]() { this->Run(); });
+		}
+		if (!this->thread.joinable()) return false;
+
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (!prefetch) {
+				this->urgent.push_back(std::move(request));
+			} else if (this->prefetch.size() < MAX_PREFETCH) {
+				this->prefetch.push_back(std::move(request));
 			} else {
-				/* Try again to allocate half. */
-				_allocated_sprite_cache_size >>= 1;
+				return false;
 			}
-		} while (_spritecache_ptr == nullptr);
+		}
+		this->requested.notify_one();
+		return true;
+	}
+
+	/**
+	 * Take the sprites that have been loaded since the last call.
+	 * @return The loaded sprites.
+	 */
+	std::vector<LoadedSprite> TakeLoaded()
+	{
+		std::vector<LoadedSprite> result;
+		std::lock_guard<std::mutex> lock(this->mutex);
+		std::swap(result, this->loaded);
+		return result;
+	}
+
+	/** Forget about all requested sprites, including the ones that have been loaded already. */
+	void Cancel()
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->urgent.clear();
+		this->prefetch.clear();
+		this->loaded.clear();
+	}
+};
 
-		if (_allocated_sprite_cache_size != target_size) {
-			Debug(misc, 0, "Not enough memory to allocate {} MiB of spritecache. Spritecache was reduced to {} MiB.", target_size / 1024 / 1024, _allocated_sprite_cache_size / 1024 / 1024);
+static SpriteLoaderThread _sprite_loader; ///< The thread loading sprites in the background.
+static uint _sprite_load_generation = 0; ///< Generation of the sprite cache; changes whenever the sprites that are being loaded become useless.
+static std::unordered_map<SpriteID, bool> _sprites_loading; ///< The sprites being loaded in the background, and whether they are needed right away.
 
-			ErrorMessageData msg(STR_CONFIG_ERROR_OUT_OF_MEMORY, STR_CONFIG_ERROR_SPRITECACHE_TOO_BIG);
-			msg.SetDParam(0, target_size);
-			msg.SetDParam(1, _allocated_sprite_cache_size);
-			ScheduleErrorMessage(msg);
+/**
+ * Check whether a sprite can be loaded in the background, instead of right away.
+ * @param sprite The sprite.
+ * @param type Expected sprite type.
+ * @return True iff the sprite can be loaded in the background.
+ */
+static bool CanLoadSpriteInBackground(SpriteID sprite, SpriteType type)
+{
+	if (type != SpriteType::Normal || _sprite_cache_read_only || !SpriteExists(sprite)) return false;
+
+	const SpriteCache *sc = GetSpriteCache(sprite);
+	if (sc->type != type || sc->ptr != nullptr || sc->file_pos == SIZE_MAX) return false;
+
+	/* Copying a sprite from the sprite disk cache is quicker than handing it to another thread. */
+	std::optional<SpriteDiskCacheKey> key = GetSpriteDiskCacheKey(sc, type);
+	return !key.has_value() || FindSpriteInDiskCache(*key).empty();
+}
+
+/**
+ * Let the sprite loader thread load a sprite.
+ * @param sprite The sprite.
+ * @param prefetch Whether the sprite is only likely to be needed soon, instead of right now.
+ * @return True iff the sprite is being loaded in the background.
+ */
+static bool LoadSpriteInBackground(SpriteID sprite, bool prefetch)
+{
+	auto it = _sprites_loading.find(sprite);
+	if (it != _sprites_loading.end()) {
+		if (prefetch || it->second) return true;
+		/* It is needed right away now, so do not wait for the sprites that are prefetched before it. */
+	}
+
+	const SpriteCache *sc = GetSpriteCache(sprite);
+	SpriteLoadRequest request{ sprite, *sc, sc->file->GetFilename(), sc->file->GetSubdirectory(), sc->file->NeedsPaletteRemap(), std::string(BlitterFactory::GetCurrentBlitter()->GetName()), _sprite_load_generation };
+	if (!_sprite_loader.Request(std::move(request), prefetch)) return it != _sprites_loading.end();
+
+	_sprites_loading[sprite] = !prefetch;
+	return true;
+}
+
+/**
+ * Request a sprite to be in the sprite cache, without waiting for it to be read from disk.
+ * Sprites that cannot be loaded in the background are loaded right away. Sprites loaded in the
+ * background are added to the sprite cache by #ProcessLoadedSprites.
+ * @param sprite The sprite.
+ * @param type Expected sprite type.
+ * @return True iff the sprite is in the sprite cache.
+ */
+bool RequestSprite(SpriteID sprite, SpriteType type)
+{
+	if (CanLoadSpriteInBackground(sprite, type) && LoadSpriteInBackground(sprite, false)) return false;
+
+	GetRawSprite(sprite, type);
+	return true;
+}
+
+/**
+ * Request a sprite to be loaded in the background, as it is likely to be needed soon.
+ * Nothing happens when the sprite is in the sprite cache, or when it cannot be loaded in the background.
+ * @param sprite The sprite.
+ */
+void PrefetchSprite(SpriteID sprite)
+{
+	if (CanLoadSpriteInBackground(sprite, SpriteType::Normal)) LoadSpriteInBackground(sprite, true);
+}
+
+/**
+ * Check whether sprites are being loaded in the background.
+ * @return True iff there are requested sprites that have not been added to the sprite cache yet.
+ */
+bool IsLoadingSprites()
+{
+	return !_sprites_loading.empty();
+}
+
+/**
+ * Add the sprites that have been loaded in the background to the sprite cache.
+ * @return The number of sprites that have been added.
+ */
+uint ProcessLoadedSprites()
+{
+	uint count = 0;
+	for (LoadedSprite &loaded : _sprite_loader.TakeLoaded()) {
+		if (loaded.generation != _sprite_load_generation) continue;
+		_sprites_loading.erase(loaded.id);
+
+		/* The sprite might have been loaded already, or been replaced by another one. */
+		SpriteCache *sc = GetSpriteCache(loaded.id);
+		if (sc->ptr != nullptr || sc->type != SpriteType::Normal || sc->file != loaded.file || sc->file_pos != loaded.file_pos) continue;
+
+		if (loaded.data == nullptr) {
+			/* Let the normal loading deal with the sprite that could not be loaded. */
+			GetRawSprite(loaded.id, SpriteType::Normal);
+		} else {
+			_sprite_cache_stats.misses++;
+
+			CacheSpriteAllocator allocator;
+			uint8_t *data = allocator.Allocate<uint8_t>(loaded.size);
+			std::copy_n(loaded.data.get(), loaded.size, data);
+			sc->ptr = data;
+			sc->evictable = true;
+			LinkSpriteLRU(loaded.id);
+
+			std::optional<SpriteDiskCacheKey> key = GetSpriteDiskCacheKey(sc, SpriteType::Normal);
+			if (key.has_value()) AddSpriteToDiskCache(*key, std::span(data, loaded.size));
 		}
+		count++;
 	}
+	return count;
+}
 
-	/* A big free block */
-	_spritecache_ptr->size = (_allocated_sprite_cache_size - sizeof(MemBlock)) | S_FREE_MASK;
-	/* Sentinel block (identified by size == 0) */
-	NextBlock(_spritecache_ptr)->size = 0;
+/** Forget about the sprites that are being loaded in the background, as they are not needed anymore. */
+static void CancelSpriteLoads()
+{
+	_sprite_load_generation++;
+	_sprite_loader.Cancel();
+	_sprites_loading.clear();
+}
+
+static void GfxInitSpriteCache()
+{
+	/* Throw away the sprites, and set the budget of the cache for the blitter. */
+	FreeSpriteCacheMemory();
+
+	int bpp = BlitterFactory::GetCurrentBlitter()->GetScreenDepth();
+	_sprite_cache_stats.budget = static_cast<size_t>(bpp > 0 ? _sprite_cache_size * bpp / 8 : 1) * 1024 * 1024;
 }
 
 void GfxInitSpriteMem()
 {
+	CancelSpriteLoads();
 	GfxInitSpriteCache();
 
 	/* Reset the spritecache 'pool' */
@@ -1043,7 +1749,6 @@ void GfxInitSpriteMem()
 	_spritecache_items = 0;
 	_spritecache = nullptr;
 
-	_compact_cache_counter = 0;
 	_sprite_files.clear();
 }
 
@@ -1053,10 +1758,12 @@ void GfxInitSpriteMem()
  */
 void GfxClearSpriteCache()
 {
+	CancelSpriteLoads();
+
 	/* Clear sprite ptr for all cached items */
 	for (uint i = 0; i != _spritecache_items; i++) {
 		SpriteCache *sc = GetSpriteCache(i);
-		if (sc->type != SpriteType::Recolour && sc->ptr != nullptr) DeleteEntryFromSpriteCache(i);
+		if (sc->evictable) DeleteEntryFromSpriteCache(i);
 	}
 
 	VideoDriver::GetInstance()->ClearSystemSprites();
@@ -1071,8 +1778,8 @@ void GfxClearFontSpriteCache()
 	/* Clear sprite ptr for all cached font items */
 	for (uint i = 0; i != _spritecache_items; i++) {
 		SpriteCache *sc = GetSpriteCache(i);
-		if (sc->type == SpriteType::Font && sc->ptr != nullptr) DeleteEntryFromSpriteCache(i);
+		if (sc->type == SpriteType::Font && sc->evictable) DeleteEntryFromSpriteCache(i);
 	}
 }
 
-/* static */ ReusableBuffer<SpriteLoader::CommonPixel> SpriteLoader::Sprite::buffer[ZOOM_LVL_END];
+/* static */ thread_local ReusableBuffer<SpriteLoader::CommonPixel> SpriteLoader::Sprite::buffer[ZOOM_LVL_END];
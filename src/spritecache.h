@@ -31,6 +31,16 @@ enum SpriteCacheCtrlFlags {
 
 extern uint _sprite_cache_size;
 
+/** Statistics of the sprite cache, e.g. for the frame rate window. */
+struct SpriteCacheStats {
+	size_t used;        ///< Bytes of memory used by the sprites in the cache.
+	size_t allocated;   ///< Bytes of memory the cache got from the system.
+	size_t budget;      ///< Bytes of memory the cache may get from the system, before it evicts sprites.
+	uint64_t hits;      ///< Number of times a sprite was in the cache.
+	uint64_t misses;    ///< Number of times a sprite had to be loaded into the cache.
+	uint64_t evictions; ///< Number of sprites that were removed from the cache to make room for others.
+};
+
 /** SpriteAllocate that uses malloc to allocate memory. */
 class SimpleSpriteAllocator : public SpriteAllocator {
 protected:
@@ -47,6 +57,15 @@ protected:
 
 void *GetRawSprite(SpriteID sprite, SpriteType type, SpriteAllocator *allocator = nullptr, SpriteEncoder *encoder = nullptr);
 bool SpriteExists(SpriteID sprite);
+bool IsSpriteCached(SpriteID sprite, SpriteType type);
+void SetSpriteCacheReadOnly(bool read_only);
+const SpriteCacheStats &GetSpriteCacheStats();
+
+bool RequestSprite(SpriteID sprite, SpriteType type);
+void PrefetchSprite(SpriteID sprite);
+bool IsLoadingSprites();
+uint ProcessLoadedSprites();
+void TrimSpriteCache();
 
 SpriteType GetSpriteType(SpriteID sprite);
 SpriteFile *GetOriginFile(SpriteID sprite);
@@ -70,7 +89,6 @@ inline const uint8_t *GetNonSprite(SpriteID sprite, SpriteType type)
 void GfxInitSpriteMem();
 void GfxClearSpriteCache();
 void GfxClearFontSpriteCache();
-void IncreaseSpriteLRU();
 
 SpriteFile &OpenCachedSpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap);
 std::span<const std::unique_ptr<SpriteFile>> GetCachedSpriteFiles();
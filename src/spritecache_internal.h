@@ -25,9 +25,12 @@ struct SpriteCache {
 	size_t file_pos;
 	SpriteFile *file;    ///< The file the sprite in this entry can be found in.
 	uint32_t id;
-	int16_t lru;
+	SpriteID lru_older;  ///< Sprite used less recently than this one, when this sprite is in the LRU list.
+	SpriteID lru_newer;  ///< Sprite used more recently than this one, when this sprite is in the LRU list.
+	uint32_t lru_used;   ///< Value of the LRU clock when this sprite was last used, when this sprite is in the LRU list.
 	SpriteType type;     ///< In some cases a single sprite is misused by two NewGRFs. Once as real sprite and once as recolour sprite. If the recolour sprite gets into the cache it might be drawn as real sprite which causes enormous trouble.
 	bool warned;         ///< True iff the user has been warned about incorrect use of this sprite
+	bool evictable;      ///< True iff the sprite is in the LRU list, so it may be removed from the cache to make room for others.
 	uint8_t control_flags;  ///< Control flags, see SpriteCacheCtrlFlags
 };
 
@@ -43,5 +46,6 @@ inline bool IsMapgenSpriteID(SpriteID sprite)
 }
 
 SpriteCache *AllocateSpriteCache(uint index);
+bool ResizeSprites(SpriteLoader::SpriteCollection &sprite, uint8_t sprite_avail, SpriteEncoder *encoder);
 
 #endif /* SPRITECACHE_INTERNAL_H */
@@ -8,6 +8,7 @@
 /** @file sprite_file.cpp Implementation of logic specific to the SpriteFile class. */
 
 #include "../stdafx.h"
+#include "../fileio_func.h"
 #include "sprite_file_type.hpp"
 
 /** Signature of a container version 2 GRF. */
@@ -43,8 +44,35 @@ static uint8_t GetGRFContainerVersion(SpriteFile &file)
  * @param palette_remap Whether a palette remap needs to be performed for this file.
  */
 SpriteFile::SpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap)
-	: RandomAccessFile(filename, subdir), palette_remap(palette_remap)
+	: RandomAccessFile(filename, subdir), palette_remap(palette_remap), subdir(subdir)
 {
 	this->container_version = GetGRFContainerVersion(*this);
 	this->content_begin = this->GetPos();
 }
+
+/**
+ * Get the MD5 checksum of the whole file, which identifies the contents of all its sprites.
+ * It is calculated the first time it is needed.
+ * @return The checksum, or \c std::nullopt when the file could not be read.
+ */
+const std::optional<MD5Hash> &SpriteFile::GetChecksum()
+{
+	if (this->checksum_calculated) return this->checksum;
+	this->checksum_calculated = true;
+
+	size_t size;
+	auto f = FioFOpenFile(this->GetFilename(), "rb", this->subdir, &size);
+	if (!f.has_value()) return this->checksum;
+
+	Md5 md5;
+	uint8_t buffer[4096];
+	size_t len;
+	while (size != 0 && (len = fread(buffer, 1, std::min(size, sizeof(buffer)), *f)) != 0) {
+		md5.Append(buffer, len);
+		size -= len;
+	}
+	if (size != 0) return this->checksum;
+
+	md5.Finish(this->checksum.emplace());
+	return this->checksum;
+}
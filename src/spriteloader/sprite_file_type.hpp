@@ -11,6 +11,7 @@
 #define SPRITE_FILE_TYPE_HPP
 
 #include "../random_access_file_type.h"
+#include "../3rdparty/md5/md5.h"
 
 /**
  * RandomAccessFile with some extra information specific for sprite files.
@@ -20,6 +21,9 @@ class SpriteFile : public RandomAccessFile {
 	bool palette_remap;     ///< Whether or not a remap of the palette is required for this file.
 	uint8_t container_version; ///< Container format of the sprite file.
 	size_t content_begin;   ///< The begin of the content of the sprite file, i.e. after the container metadata.
+	Subdirectory subdir;    ///< The sub directory the file was searched in.
+	std::optional<MD5Hash> checksum; ///< The checksum of the whole file, once it has been calculated.
+	bool checksum_calculated = false; ///< Whether calculating the checksum has been tried.
 public:
 	SpriteFile(const std::string &filename, Subdirectory subdir, bool palette_remap);
 	SpriteFile(const SpriteFile&) = delete;
@@ -41,6 +45,14 @@ public:
 	 * Seek to the begin of the content, i.e. the position just after the container version has been determined.
 	 */
 	void SeekToBegin() { this->SeekTo(this->content_begin, SEEK_SET); }
+
+	/**
+	 * Get the sub directory the file was searched in.
+	 * @return The sub directory.
+	 */
+	Subdirectory GetSubdirectory() const { return this->subdir; }
+
+	const std::optional<MD5Hash> &GetChecksum();
 };
 
 #endif /* SPRITE_FILE_TYPE_HPP */
@@ -26,7 +26,6 @@ static bool MockLoadNextSprite(SpriteID load_index)
 	sc->file = nullptr;
 	sc->file_pos = 0;
 	sc->ptr = sprite;
-	sc->lru = 0;
 	sc->id = 0;
 	sc->type = is_mapgen ? SpriteType::MapGen : SpriteType::Normal;
 	sc->warned = false;
@@ -0,0 +1,73 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file test_network_frame_lead.cpp Tests for the adaptive frame lead of network clients. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../network/network_server.h"
+
+#include <deque>
+
+#include "../safeguards.h"
+
+/**
+ * Simulate a client on a loopback connection with a latency, that acknowledges every frame it gets.
+ * @param frame_lead The smoothed frame lead of the client at the start.
+ * @param latency Number of frames a packet takes to get to the other side.
+ * @param frames Number of frames to simulate.
+ * @return The smoothed frame lead of the client at the end.
+ */
+static uint SimulateFrameLead(uint frame_lead, uint latency, uint frames)
+{
+	std::deque<uint32_t> to_client(latency, 0); // Frames on their way to the client.
+	std::deque<uint32_t> to_server(latency, 0); // ACKs on their way to the server.
+
+	for (uint32_t frame = 1; frame <= frames; frame++) {
+		to_client.push_back(frame);
+		uint32_t client_frame = to_client.front();
+		to_client.pop_front();
+
+		to_server.push_back(client_frame);
+		uint32_t ack = to_server.front();
+		to_server.pop_front();
+
+		if (ack != 0) frame_lead = UpdateNetworkFrameLead(frame_lead, frame - ack);
+	}
+	return frame_lead;
+}
+
+TEST_CASE("NetworkFrameLead - decays on a connection without latency")
+{
+	CHECK(GetNetworkFrameLeadFrames(SimulateFrameLead(0, 0, 100)) == 0);
+	CHECK(GetNetworkFrameLeadFrames(SimulateFrameLead(10 * NETWORK_FRAME_LEAD_SCALE, 0, 100)) == 0);
+	CHECK(GetNetworkFrameLeadFrames(SimulateFrameLead(6 * NETWORK_FRAME_LEAD_SCALE, 0, 100)) == 0);
+}
+
+TEST_CASE("NetworkFrameLead - converges to half the round trip")
+{
+	for (uint latency = 1; latency <= 10; latency++) {
+		/* The round trip is twice the latency, and the client has to hide half of it. */
+		CHECK(GetNetworkFrameLeadFrames(SimulateFrameLead(0, latency, 200)) == latency);
+		CHECK(GetNetworkFrameLeadFrames(SimulateFrameLead(50 * NETWORK_FRAME_LEAD_SCALE, latency, 200)) == latency);
+	}
+}
+
+TEST_CASE("NetworkFrameLead - settles within a fraction of a frame")
+{
+	for (uint trail = 0; trail <= 20; trail++) {
+		uint needed = trail * NETWORK_FRAME_LEAD_SCALE / 2;
+		for (uint start : {0U, needed, 100 * NETWORK_FRAME_LEAD_SCALE}) {
+			uint frame_lead = start;
+			for (int i = 0; i < 100; i++) frame_lead = UpdateNetworkFrameLead(frame_lead, trail);
+			CHECK(frame_lead + 1 >= needed);
+			CHECK(frame_lead <= needed + 2);
+		}
+	}
+}
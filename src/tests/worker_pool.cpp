@@ -0,0 +1,41 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file worker_pool.cpp Test functionality from worker_pool. */
+
+#include "../stdafx.h"
+
+#include "../3rdparty/catch2/catch.hpp"
+
+#include "../worker_pool.h"
+
+#include "../safeguards.h"
+
+TEST_CASE("WorkerPool - every item is done once")
+{
+	WorkerPool pool("test:pool", 4);
+	CHECK(pool.GetThreadCount() >= 1);
+	CHECK(pool.GetThreadCount() <= 4);
+
+	/* Run several jobs, to check the threads pick up the next job. */
+	for (size_t count : { 0, 1, 7, 1000, 3 }) {
+		std::vector<std::atomic<int>> done(count);
+		pool.Run(count, [&done](size_t i) { done[i]++; });
+
+		for (const std::atomic<int> &d : done) CHECK(d == 1);
+	}
+}
+
+TEST_CASE("WorkerPool - single thread")
+{
+	WorkerPool pool("test:pool", 1);
+	CHECK(pool.GetThreadCount() == 1);
+
+	std::vector<size_t> order;
+	pool.Run(5, [&order](size_t i) { order.push_back(i); });
+	CHECK(order == std::vector<size_t>{ 0, 1, 2, 3, 4 });
+}
@@ -13,6 +13,7 @@
 #include "debug.h"
 #include "crashlog.h"
 #include "error_func.h"
+#include <atomic>
 #include <system_error>
 #include <thread>
 #include <mutex>
@@ -85,4 +86,34 @@ inline bool StartNewThread(std::thread *thr, const char *name, TFn&& _Fx, TArgs&
 	return false;
 }
 
+/**
+ * Call a function for a number of items, spread over as many threads as there are cores.
+ * The calling thread does its share of the work as well, and this returns once all items are done.
+ * @tparam TFn Type of the function to call.
+ * @param name Name of the helper threads.
+ * @param count The number of items.
+ * @param func Function to call with the index of each of the items; it may not throw.
+ */
+template <class TFn>
+inline void RunInParallel(const char *name, size_t count, TFn &&func)
+{
+	if (count == 0) return;
+
+	std::atomic<size_t> next = 0;
+	auto worker = [&func, &next, count]() {
+		for (size_t i = next++; i < count; i = next++) func(i);
+	};
+
+	std::vector<std::thread> threads(std::min<size_t>(std::max(1U, std::thread::hardware_concurrency()), count) - 1);
+	for (std::thread &thread : threads) {
+		if (!StartNewThread(&thread, name, [&worker]() { worker(); })) break;
+	}
+
+	worker();
+
+	for (std::thread &thread : threads) {
+		if (thread.joinable()) thread.join();
+	}
+}
+
 #endif /* THREAD_H */
@@ -60,6 +60,7 @@
 #include "timer/timer_game_calendar.h"
 #include "timer/timer_game_economy.h"
 #include "timer/timer_game_tick.h"
+#include "video/video_driver.hpp"
 
 #include "table/strings.h"
 
@@ -987,9 +988,15 @@ void CallVehicleTicks()
 
 	RunEconomyVehicleDayProc();
 
+	/* With many vehicles this is the longest part of a game-tick, so let drawing happen in between vehicles and stations. */
+	VideoDriver *driver = VideoDriver::GetInstance();
+
 	{
 		PerformanceMeasurer framerate(PFE_GL_ECONOMY);
-		for (Station *st : Station::Iterate()) LoadUnloadStation(st);
+		for (Station *st : Station::Iterate()) {
+			if (driver != nullptr) driver->GameLoopDrawPoint();
+			LoadUnloadStation(st);
+		}
 	}
 	PerformanceAccumulator::Reset(PFE_GL_TRAINS);
 	PerformanceAccumulator::Reset(PFE_GL_ROADVEHS);
@@ -997,6 +1004,8 @@ void CallVehicleTicks()
 	PerformanceAccumulator::Reset(PFE_GL_AIRCRAFT);
 
 	for (Vehicle *v : Vehicle::Iterate()) {
+		if (driver != nullptr) driver->GameLoopDrawPoint();
+
 		[[maybe_unused]] size_t vehicle_index = v->index;
 
 		/* Vehicle could be deleted in this tick */
@@ -11,6 +11,8 @@
 #include "../gfx_func.h"
 #include "../blitter/factory.hpp"
 #include "../saveload/saveload.h"
+#include "../saveload/savebench.h"
+#include "../map_render.h"
 #include "../window_func.h"
 #include "null_v.h"
 
@@ -36,9 +38,13 @@ std::optional<std::string_view> VideoDriver_Null::Start(const StringList &parm)
 	_screen.dst_ptr = nullptr;
 	ScreenSizeChanged();
 
-	/* Do not render, nor blit */
-	Debug(misc, 1, "Forcing blitter 'null'...");
-	BlitterFactory::SelectBlitter("null");
+	/* Do not render, nor blit, unless a blitter is requested for rendering without a screen. */
+	const char *blitter = GetDriverParam(parm, "blitter");
+	if (blitter == nullptr) {
+		Debug(misc, 1, "Forcing blitter 'null'...");
+		blitter = "null";
+	}
+	if (BlitterFactory::SelectBlitter(blitter) == nullptr) return "Unknown blitter";
 	return std::nullopt;
 }
 
@@ -56,6 +62,18 @@ void VideoDriver_Null::MainLoop()
 		::UpdateWindows();
 	}
 
+	/* The savegame benchmark runs once everything, including the NewGRFs, has been scanned in the first tick. */
+	if (!_save_benchmark.savegames.empty()) {
+		RunSaveBenchmark();
+		return;
+	}
+
+	/* Likewise for rendering the map of a savegame. */
+	if (!_map_render.savegame.empty()) {
+		RunMapRender();
+		return;
+	}
+
 	/* If requested, make a save just before exit. The normal exit-flow is
 	 * not triggered from this driver, so we have to do this manually. */
 	if (_settings_client.gui.autosave_on_exit) {
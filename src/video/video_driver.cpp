@@ -14,6 +14,7 @@
 #include "../debug.h"
 #include "../driver.h"
 #include "../fontcache.h"
+#include "../framerate_type.h"
 #include "../gfx_func.h"
 #include "../gfxinit.h"
 #include "../progress.h"
@@ -78,6 +79,35 @@ void VideoDriver::GameLoopPause()
 	this->game_state_mutex.lock();
 }
 
+/**
+ * Let the drawing happen in the middle of a long game-tick, if the draw-tick is
+ * waiting for the game-state lock. Call this only where the game state is
+ * consistent enough to be drawn. The draw-tick does not handle input then, as
+ * changing the game state in the middle of the game-tick would disturb it.
+ */
+void VideoDriver::GameLoopDrawPoint()
+{
+	if (!this->draw_waiting.load(std::memory_order_relaxed)) return;
+
+	/* The time spent drawing is not part of the game loop. */
+	PerformancePause pause_gameloop(PFE_GAMELOOP);
+	PerformancePause pause_economy(PFE_GL_ECONOMY);
+
+	this->draw_only = true;
+	this->GameLoopPause();
+	this->draw_only = false;
+}
+
+/**
+ * Forget that the draw-tick is waiting for the game-state lock. This is for a forked
+ * child process, which only has the thread that forked; the draw-tick that was waiting
+ * in the parent does not exist in the child.
+ */
+void VideoDriver::ForgetDrawTick()
+{
+	this->draw_waiting = false;
+}
+
 /* static */ void VideoDriver::GameThreadThunk(VideoDriver *drv)
 {
 	drv->GameThread();
@@ -124,27 +154,32 @@ void VideoDriver::Tick()
 		{
 			/* Tell the game-thread to stop so we can have a go. */
 			std::lock_guard<std::mutex> lock_wait(this->game_thread_wait_mutex);
+			this->draw_waiting = true;
 			std::lock_guard<std::mutex> lock_state(this->game_state_mutex);
+			this->draw_waiting = false;
 
-			/* Keep the interactive randomizer a bit more random by requesting
-			 * new values when-ever we can. */
-			InteractiveRandom();
+			/* In the middle of a game-tick, only draw; input is handled once the game-tick is done. */
+			if (!this->draw_only) {
+				/* Keep the interactive randomizer a bit more random by requesting
+				 * new values when-ever we can. */
+				InteractiveRandom();
 
-			this->DrainCommandQueue();
+				this->DrainCommandQueue();
 
-			while (this->PollEvent()) {}
-			this->InputLoop();
+				while (this->PollEvent()) {}
+				this->InputLoop();
 
-			/* Check if the fast-forward button is still pressed. */
-			if (fast_forward_key_pressed && !_networking && _game_mode != GM_MENU) {
-				ChangeGameSpeed(true);
-				this->fast_forward_via_key = true;
-			} else if (this->fast_forward_via_key) {
-				ChangeGameSpeed(false);
-				this->fast_forward_via_key = false;
-			}
+				/* Check if the fast-forward button is still pressed. */
+				if (fast_forward_key_pressed && !_networking && _game_mode != GM_MENU) {
+					ChangeGameSpeed(true);
+					this->fast_forward_via_key = true;
+				} else if (this->fast_forward_via_key) {
+					ChangeGameSpeed(false);
+					this->fast_forward_via_key = false;
+				}
 
-			::InputLoop();
+				::InputLoop();
+			}
 
 			/* Prevent drawing when switching mode, as windows can be removed when they should still appear. */
 			if (_game_mode == GM_BOOTSTRAP || _switch_mode == SM_NONE || HasModalProgress()) {
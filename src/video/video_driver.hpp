@@ -194,6 +194,8 @@ public:
 	}
 
 	void GameLoopPause();
+	void GameLoopDrawPoint();
+	void ForgetDrawTick();
 
 	/**
 	 * Get the currently active instance of the video driver.
@@ -361,6 +363,8 @@ protected:
 	std::thread game_thread;
 	std::mutex game_state_mutex;
 	std::mutex game_thread_wait_mutex;
+	std::atomic<bool> draw_waiting = false; ///< Whether the draw-tick is waiting for the game-state lock.
+	bool draw_only = false; ///< Whether the draw-tick may only draw, as it got the game-state lock in the middle of a game-tick.
 
 	bool uses_hardware_acceleration;
 
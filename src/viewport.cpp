@@ -90,9 +90,14 @@
 #include "network/network_func.h"
 #include "framerate_type.h"
 #include "viewport_cmd.h"
+#include "newgrf_debug.h"
+#include "spritecache.h"
+#include "worker_pool.h"
 
+#include <deque>
 #include <forward_list>
 #include <stack>
+#include <unordered_map>
 
 #include "table/strings.h"
 #include "table/string_colours.h"
@@ -164,6 +169,146 @@ typedef std::vector<ChildScreenSpriteToDraw> ChildScreenSpriteToDrawVector;
 constexpr int LAST_CHILD_NONE = -1; ///< There is no last_child to fill.
 constexpr int LAST_CHILD_PARENT = -2; ///< Fill last_child of the most recent parent sprite.
 
+/** Calls a tile makes to add its sprites to a viewport. */
+enum class TileDrawCall : uint8_t {
+	GroundSprite,       ///< #DrawGroundSpriteAt
+	OffsetGroundSprite, ///< #OffsetGroundSprite
+	SortableSprite,     ///< #AddSortableSpriteToDraw
+	ChildSprite,        ///< #AddChildSpriteScreen
+	StartSpriteCombine, ///< #StartSpriteCombine
+	EndSpriteCombine,   ///< #EndSpriteCombine
+};
+
+/** A call a tile made to add its sprites to a viewport, as kept in the tile draw cache to repeat it. */
+struct TileDrawCommand {
+	TileDrawCall call = TileDrawCall::GroundSprite; ///< The call that was made.
+	bool transparent = false;       ///< Whether the sprite is drawn transparently.
+	bool scale = false;             ///< Whether the offsets of a child sprite are scaled to the base zoom level.
+	bool relative = false;          ///< Whether a child sprite is drawn relative to the parent sprite offsets.
+	SpriteID image = 0;
+	PaletteID pal = 0;
+	const SubSprite *sub = nullptr; ///< only draw a rectangular part of the sprite
+	int32_t x = 0;                  ///< X position of the sprite, or X offset of the ground sprites.
+	int32_t y = 0;                  ///< Y position of the sprite, or Y offset of the ground sprites.
+	int32_t z = 0;                  ///< Z position of the sprite.
+	int32_t w = 0;                  ///< Bounding box extent towards positive X, or pixel X offset of a ground sprite.
+	int32_t h = 0;                  ///< Bounding box extent towards positive Y, or pixel Y offset of a ground sprite.
+	int32_t dz = 0;                 ///< Bounding box extent towards positive Z.
+	int32_t bb_offset_x = 0;        ///< Bounding box extent towards negative X.
+	int32_t bb_offset_y = 0;        ///< Bounding box extent towards negative Y.
+	int32_t bb_offset_z = 0;        ///< Bounding box extent towards negative Z.
+};
+
+typedef std::vector<TileDrawCommand> TileDrawCommandVector;
+
+/**
+ * The calls map tiles made to add their sprites to viewports, until the tiles are marked dirty.
+ * Tiles are kept for every zoom level they are drawn at, so viewports at different zoom levels
+ * do not replace each other's tiles. When the cache is full, the tile that was added the longest
+ * time ago is forgotten for every tile that is added, so it never has to be cleared at once.
+ */
+class TileDrawCache {
+public:
+	static const size_t MAX_TILES = 1 << 18; ///< Number of tiles, over all zoom levels, at which tiles are forgotten, to bound the memory use.
+
+	/**
+	 * Find the calls a tile made when it was drawn before.
+	 * @param zoom The zoom level the tile is drawn at.
+	 * @param tile The tile.
+	 * @param transparency The transparency options the tile is drawn with.
+	 * @return The calls, or nullptr when the tile has to be resolved.
+	 */
+	const TileDrawCommandVector *Find(ZoomLevel zoom, uint32_t tile, TransparencyOptionBits transparency) const
+	{
+		auto it = this->tiles[zoom].find(tile);
+		if (it == this->tiles[zoom].end() || it->second.transparency != transparency) return nullptr;
+		return &it->second.commands;
+	}
+
+	/**
+	 * Keep the calls a tile made when it was drawn.
+	 * @param zoom The zoom level the tile was drawn at.
+	 * @param tile The tile.
+	 * @param transparency The transparency options the tile was drawn with.
+	 * @param commands The calls.
+	 */
+	void Insert(ZoomLevel zoom, uint32_t tile, TransparencyOptionBits transparency, const TileDrawCommandVector &commands)
+	{
+		/* The order also has records of tiles that were forgotten or added again since; those are skipped, but bounded as well. */
+		while (this->size >= MAX_TILES || this->order.size() >= 2 * MAX_TILES) {
+			const Added &oldest = this->order.front();
+			auto it = this->tiles[oldest.zoom].find(oldest.tile);
+			if (it != this->tiles[oldest.zoom].end() && it->second.added == oldest.added) {
+				this->tiles[oldest.zoom].erase(it);
+				this->size--;
+			}
+			this->order.pop_front();
+		}
+
+		auto [it, inserted] = this->tiles[zoom].try_emplace(tile);
+		if (inserted) this->size++;
+		it->second.transparency = transparency;
+		it->second.commands = commands;
+		it->second.added = ++this->last_added;
+		this->order.push_back({ zoom, tile, this->last_added });
+	}
+
+	/**
+	 * Forget a tile at all zoom levels.
+	 * @param tile The tile.
+	 */
+	void Erase(uint32_t tile)
+	{
+		for (auto &tiles : this->tiles) {
+			if (!tiles.empty()) this->size -= tiles.erase(tile);
+		}
+	}
+
+	/** Forget all tiles. */
+	void Clear()
+	{
+		for (auto &tiles : this->tiles) tiles.clear();
+		this->order.clear();
+		this->size = 0;
+	}
+
+	/**
+	 * Check whether there are no tiles in the cache.
+	 * @return True iff no tile is kept.
+	 */
+	bool IsEmpty() const
+	{
+		return this->size == 0;
+	}
+
+private:
+	/** The calls a tile made to add its sprites to a viewport, and the state besides the map they depend on. */
+	struct Entry {
+		TransparencyOptionBits transparency; ///< Transparency options the tile was drawn with.
+		TileDrawCommandVector commands;      ///< The calls, in the order they were made.
+		uint64_t added;                      ///< When the tile was added, see #last_added.
+	};
+
+	/** Record of adding a tile, to forget the tiles in the order they were added. */
+	struct Added {
+		ZoomLevel zoom; ///< Zoom level of the tile.
+		uint32_t tile;  ///< The tile.
+		uint64_t added; ///< When the tile was added, to know whether the tile was added again since.
+	};
+
+	std::array<std::unordered_map<uint32_t, Entry>, ZOOM_LVL_END> tiles; ///< The tiles by their index, for every zoom level.
+	std::deque<Added> order; ///< The tiles in the order they were added.
+	size_t size = 0;         ///< Number of tiles, over all zoom levels.
+	uint64_t last_added = 0; ///< Number of tiles that have been added so far.
+};
+
+/** How a drawer deals with sprites that are not in the sprite cache. */
+enum class ViewportSpriteLoading : uint8_t {
+	Wait,       ///< Load the sprites, and wait for them.
+	Background, ///< Load the sprites in the background, and leave them out until they are loaded.
+	Prefetch,   ///< Load the sprites in the background, as nothing is drawn.
+};
+
 /** Data structure storing rendering information */
 struct ViewportDrawer {
 	DrawPixelInfo dpi;
@@ -182,11 +327,19 @@ struct ViewportDrawer {
 	FoundationPart foundation_part;                  ///< Currently active foundation for ground sprite drawing.
 	int last_foundation_child[FOUNDATION_PART_END];  ///< Tail of ChildSprite list of the foundations. (index into child_screen_sprites_to_draw)
 	Point foundation_offset[FOUNDATION_PART_END];    ///< Pixel offset for ground sprites on the foundations.
+
+	ViewportSpriteLoading sprite_loading;            ///< How to deal with sprites that are not in the sprite cache.
+	bool sprites_left_out;                           ///< Whether sprites were left out, as they are still being loaded.
+
+	TileDrawCommandVector tile_draw_commands;        ///< The calls the tile being drawn made, to keep them in the tile draw cache.
+	bool record_tile_draw_commands;                  ///< Whether the calls of the tile being drawn are recorded in #tile_draw_commands.
 };
 
 static bool MarkViewportDirty(const Viewport *vp, int left, int top, int right, int bottom);
 
-static ViewportDrawer _vd;
+static ViewportDrawer *_vd = nullptr; ///< The drawer sprites are currently being added to.
+static std::vector<ViewportDrawer> _viewport_drawers; ///< Drawers of the tiles of the area being drawn, kept around to reuse their memory.
+static TileDrawCache _tile_draw_cache; ///< The calls map tiles made to add their sprites to viewports, until the tiles are marked dirty.
 
 TileHighlightData _thd;
 static TileInfo _cur_ti;
@@ -195,6 +348,12 @@ bool _draw_dirty_blocks = false;
 uint _dirty_block_colour = 0;
 static VpSpriteSorter _vp_sprite_sorter = nullptr;
 
+static const int VIEWPORT_DRAW_TILE_WIDTH = 256; ///< Width in pixels of the tiles large areas of viewports are split into for drawing them in parallel.
+static const int VIEWPORT_DRAW_TILE_HEIGHT = 128; ///< Height in pixels of the tiles large areas of viewports are split into for drawing them in parallel.
+static const int VIEWPORT_PREFETCH_FRACTION = 4; ///< Part of the size of a viewport that the sprites are prefetched for beyond its edge when it scrolls.
+
+static std::vector<Rect> _viewport_sprites_left_out; ///< Areas of the screen that were drawn without some of their sprites, as they were still being loaded.
+
 static Point MapXYZToViewport(const Viewport *vp, int x, int y, int z)
 {
 	Point p = RemapCoords(x, y, z);
@@ -516,7 +675,7 @@ static void AddTileSpriteToDraw(SpriteID image, PaletteID pal, int32_t x, int32_
 {
 	assert((image & SPRITE_MASK) < MAX_SPRITES);
 
-	TileSpriteToDraw &ts = _vd.tile_sprites_to_draw.emplace_back();
+	TileSpriteToDraw &ts = _vd->tile_sprites_to_draw.emplace_back();
 	ts.image = image;
 	ts.pal = pal;
 	ts.sub = sub;
@@ -540,11 +699,12 @@ static void AddTileSpriteToDraw(SpriteID image, PaletteID pal, int32_t x, int32_
 static void AddChildSpriteToFoundation(SpriteID image, PaletteID pal, const SubSprite *sub, FoundationPart foundation_part, int extra_offs_x, int extra_offs_y)
 {
 	assert(IsInsideMM(foundation_part, 0, FOUNDATION_PART_END));
-	assert(_vd.foundation[foundation_part] != -1);
-	Point offs = _vd.foundation_offset[foundation_part];
+	assert(_vd->foundation[foundation_part] != -1);
+	Point offs = _vd->foundation_offset[foundation_part];
 
 	/* Change the active ChildSprite list to the one of the foundation */
-	AutoRestoreBackup backup(_vd.last_child, _vd.last_foundation_child[foundation_part]);
+	AutoRestoreBackup backup(_vd->last_child, _vd->last_foundation_child[foundation_part]);
+	AutoRestoreBackup record_backup(_vd->record_tile_draw_commands, false);
 	AddChildSpriteScreen(image, pal, offs.x + extra_offs_x, offs.y + extra_offs_y, false, sub, false, false);
 }
 
@@ -563,12 +723,16 @@ static void AddChildSpriteToFoundation(SpriteID image, PaletteID pal, const SubS
  */
 void DrawGroundSpriteAt(SpriteID image, PaletteID pal, int32_t x, int32_t y, int z, const SubSprite *sub, int extra_offs_x, int extra_offs_y)
 {
+	if (_vd->record_tile_draw_commands) {
+		_vd->tile_draw_commands.push_back({ .call = TileDrawCall::GroundSprite, .image = image, .pal = pal, .sub = sub, .x = x, .y = y, .z = z, .w = extra_offs_x, .h = extra_offs_y });
+	}
+
 	/* Switch to first foundation part, if no foundation was drawn */
-	if (_vd.foundation_part == FOUNDATION_PART_NONE) _vd.foundation_part = FOUNDATION_PART_NORMAL;
+	if (_vd->foundation_part == FOUNDATION_PART_NONE) _vd->foundation_part = FOUNDATION_PART_NORMAL;
 
-	if (_vd.foundation[_vd.foundation_part] != -1) {
+	if (_vd->foundation[_vd->foundation_part] != -1) {
 		Point pt = RemapCoords(x, y, z);
-		AddChildSpriteToFoundation(image, pal, sub, _vd.foundation_part, pt.x + extra_offs_x * ZOOM_BASE, pt.y + extra_offs_y * ZOOM_BASE);
+		AddChildSpriteToFoundation(image, pal, sub, _vd->foundation_part, pt.x + extra_offs_x * ZOOM_BASE, pt.y + extra_offs_y * ZOOM_BASE);
 	} else {
 		AddTileSpriteToDraw(image, pal, _cur_ti.x + x, _cur_ti.y + y, _cur_ti.z + z, sub, extra_offs_x * ZOOM_BASE, extra_offs_y * ZOOM_BASE);
 	}
@@ -598,23 +762,54 @@ void DrawGroundSprite(SpriteID image, PaletteID pal, const SubSprite *sub, int e
  */
 void OffsetGroundSprite(int x, int y)
 {
+	if (_vd->record_tile_draw_commands) {
+		_vd->tile_draw_commands.push_back({ .call = TileDrawCall::OffsetGroundSprite, .x = x, .y = y });
+	}
+
 	/* Switch to next foundation part */
-	switch (_vd.foundation_part) {
+	switch (_vd->foundation_part) {
 		case FOUNDATION_PART_NONE:
-			_vd.foundation_part = FOUNDATION_PART_NORMAL;
+			_vd->foundation_part = FOUNDATION_PART_NORMAL;
 			break;
 		case FOUNDATION_PART_NORMAL:
-			_vd.foundation_part = FOUNDATION_PART_HALFTILE;
+			_vd->foundation_part = FOUNDATION_PART_HALFTILE;
 			break;
 		default: NOT_REACHED();
 	}
 
-	/* _vd.last_child is LAST_CHILD_NONE if foundation sprite was clipped by the viewport bounds */
-	if (_vd.last_child != LAST_CHILD_NONE) _vd.foundation[_vd.foundation_part] = static_cast<uint>(_vd.parent_sprites_to_draw.size()) - 1;
+	/* _vd->last_child is LAST_CHILD_NONE if foundation sprite was clipped by the viewport bounds */
+	if (_vd->last_child != LAST_CHILD_NONE) _vd->foundation[_vd->foundation_part] = static_cast<uint>(_vd->parent_sprites_to_draw.size()) - 1;
 
-	_vd.foundation_offset[_vd.foundation_part].x = x * ZOOM_BASE;
-	_vd.foundation_offset[_vd.foundation_part].y = y * ZOOM_BASE;
-	_vd.last_foundation_child[_vd.foundation_part] = _vd.last_child;
+	_vd->foundation_offset[_vd->foundation_part].x = x * ZOOM_BASE;
+	_vd->foundation_offset[_vd->foundation_part].y = y * ZOOM_BASE;
+	_vd->last_foundation_child[_vd->foundation_part] = _vd->last_child;
+}
+
+/**
+ * Request a sprite the current drawer needs to know the size of, as it is going to draw it.
+ * Depending on how the drawer deals with sprites that are not in the sprite cache, it is loaded
+ * right away, or in the background.
+ * @param image The image of the sprite.
+ * @return True iff the sprite is in the sprite cache.
+ */
+static bool RequestViewportSprite(SpriteID image)
+{
+	SpriteID sprite = image & SPRITE_MASK;
+	switch (_vd->sprite_loading) {
+		case ViewportSpriteLoading::Wait:
+			return true;
+
+		case ViewportSpriteLoading::Background:
+			if (RequestSprite(sprite, SpriteType::Normal)) return true;
+			_vd->sprites_left_out = true;
+			return false;
+
+		case ViewportSpriteLoading::Prefetch:
+			PrefetchSprite(sprite);
+			return IsSpriteCached(sprite, SpriteType::Normal);
+
+		default: NOT_REACHED();
+	}
 }
 
 /**
@@ -631,15 +826,22 @@ void OffsetGroundSprite(int x, int y)
 static void AddCombinedSprite(SpriteID image, PaletteID pal, int x, int y, int z, const SubSprite *sub)
 {
 	Point pt = RemapCoords(x, y, z);
-	const Sprite *spr = GetSprite(image & SPRITE_MASK, SpriteType::Normal);
+	const ParentSpriteToDraw &pstd = _vd->parent_sprites_to_draw.back();
+	AutoRestoreBackup record_backup(_vd->record_tile_draw_commands, false);
 
-	if (pt.x + spr->x_offs >= _vd.dpi.left + _vd.dpi.width ||
-			pt.x + spr->x_offs + spr->width <= _vd.dpi.left ||
-			pt.y + spr->y_offs >= _vd.dpi.top + _vd.dpi.height ||
-			pt.y + spr->y_offs + spr->height <= _vd.dpi.top)
+	/* Without the sprite it is unknown whether it is visible; it is left out later on when it is not loaded by then. */
+	if (!RequestViewportSprite(image)) {
+		AddChildSpriteScreen(image, pal, pt.x - pstd.left, pt.y - pstd.top, false, sub, false);
+		return;
+	}
+
+	const Sprite *spr = GetSprite(image & SPRITE_MASK, SpriteType::Normal);
+	if (pt.x + spr->x_offs >= _vd->dpi.left + _vd->dpi.width ||
+			pt.x + spr->x_offs + spr->width <= _vd->dpi.left ||
+			pt.y + spr->y_offs >= _vd->dpi.top + _vd->dpi.height ||
+			pt.y + spr->y_offs + spr->height <= _vd->dpi.top)
 		return;
 
-	const ParentSpriteToDraw &pstd = _vd.parent_sprites_to_draw.back();
 	AddChildSpriteScreen(image, pal, pt.x - pstd.left, pt.y - pstd.top, false, sub, false);
 }
 
@@ -674,24 +876,29 @@ void AddSortableSpriteToDraw(SpriteID image, PaletteID pal, int x, int y, int w,
 
 	assert((image & SPRITE_MASK) < MAX_SPRITES);
 
+	if (_vd->record_tile_draw_commands) {
+		_vd->tile_draw_commands.push_back({ .call = TileDrawCall::SortableSprite, .transparent = transparent, .image = image, .pal = pal, .sub = sub,
+				.x = x, .y = y, .z = z, .w = w, .h = h, .dz = dz, .bb_offset_x = bb_offset_x, .bb_offset_y = bb_offset_y, .bb_offset_z = bb_offset_z });
+	}
+
 	/* make the sprites transparent with the right palette */
 	if (transparent) {
 		SetBit(image, PALETTE_MODIFIER_TRANSPARENT);
 		pal = PALETTE_TO_TRANSPARENT;
 	}
 
-	if (_vd.combine_sprites == SPRITE_COMBINE_ACTIVE) {
+	if (_vd->combine_sprites == SPRITE_COMBINE_ACTIVE) {
 		AddCombinedSprite(image, pal, x, y, z, sub);
 		return;
 	}
 
-	_vd.last_child = LAST_CHILD_NONE;
+	_vd->last_child = LAST_CHILD_NONE;
 
 	Point pt = RemapCoords(x, y, z);
 	int tmp_left, tmp_top, tmp_x = pt.x, tmp_y = pt.y;
 
-	/* Compute screen extents of sprite */
-	if (image == SPR_EMPTY_BOUNDING_BOX) {
+	/* Compute screen extents of sprite; without the sprite, e.g. while it is being loaded, only the bounding box is known. */
+	if (image == SPR_EMPTY_BOUNDING_BOX || !RequestViewportSprite(image)) {
 		left = tmp_left = RemapCoords(x + w          , y + bb_offset_y, z + bb_offset_z).x;
 		right           = RemapCoords(x + bb_offset_x, y + h          , z + bb_offset_z).x + 1;
 		top  = tmp_top  = RemapCoords(x + bb_offset_x, y + bb_offset_y, z + dz         ).y;
@@ -713,14 +920,14 @@ void AddSortableSpriteToDraw(SpriteID image, PaletteID pal, int x, int y, int w,
 	}
 
 	/* Do not add the sprite to the viewport, if it is outside */
-	if (left   >= _vd.dpi.left + _vd.dpi.width ||
-	    right  <= _vd.dpi.left                 ||
-	    top    >= _vd.dpi.top + _vd.dpi.height ||
-	    bottom <= _vd.dpi.top) {
+	if (left   >= _vd->dpi.left + _vd->dpi.width ||
+	    right  <= _vd->dpi.left                 ||
+	    top    >= _vd->dpi.top + _vd->dpi.height ||
+	    bottom <= _vd->dpi.top) {
 		return;
 	}
 
-	ParentSpriteToDraw &ps = _vd.parent_sprites_to_draw.emplace_back();
+	ParentSpriteToDraw &ps = _vd->parent_sprites_to_draw.emplace_back();
 	ps.x = tmp_x;
 	ps.y = tmp_y;
 
@@ -741,9 +948,9 @@ void AddSortableSpriteToDraw(SpriteID image, PaletteID pal, int x, int y, int w,
 
 	ps.first_child = LAST_CHILD_NONE;
 
-	_vd.last_child = LAST_CHILD_PARENT;
+	_vd->last_child = LAST_CHILD_PARENT;
 
-	if (_vd.combine_sprites == SPRITE_COMBINE_PENDING) _vd.combine_sprites = SPRITE_COMBINE_ACTIVE;
+	if (_vd->combine_sprites == SPRITE_COMBINE_PENDING) _vd->combine_sprites = SPRITE_COMBINE_ACTIVE;
 }
 
 /**
@@ -766,8 +973,10 @@ void AddSortableSpriteToDraw(SpriteID image, PaletteID pal, int x, int y, int w,
  */
 void StartSpriteCombine()
 {
-	assert(_vd.combine_sprites == SPRITE_COMBINE_NONE);
-	_vd.combine_sprites = SPRITE_COMBINE_PENDING;
+	if (_vd->record_tile_draw_commands) _vd->tile_draw_commands.push_back({ .call = TileDrawCall::StartSpriteCombine });
+
+	assert(_vd->combine_sprites == SPRITE_COMBINE_NONE);
+	_vd->combine_sprites = SPRITE_COMBINE_PENDING;
 }
 
 /**
@@ -776,8 +985,10 @@ void StartSpriteCombine()
  */
 void EndSpriteCombine()
 {
-	assert(_vd.combine_sprites != SPRITE_COMBINE_NONE);
-	_vd.combine_sprites = SPRITE_COMBINE_NONE;
+	if (_vd->record_tile_draw_commands) _vd->tile_draw_commands.push_back({ .call = TileDrawCall::EndSpriteCombine });
+
+	assert(_vd->combine_sprites != SPRITE_COMBINE_NONE);
+	_vd->combine_sprites = SPRITE_COMBINE_NONE;
 }
 
 /**
@@ -828,8 +1039,12 @@ void AddChildSpriteScreen(SpriteID image, PaletteID pal, int x, int y, bool tran
 {
 	assert((image & SPRITE_MASK) < MAX_SPRITES);
 
+	if (_vd->record_tile_draw_commands) {
+		_vd->tile_draw_commands.push_back({ .call = TileDrawCall::ChildSprite, .transparent = transparent, .scale = scale, .relative = relative, .image = image, .pal = pal, .sub = sub, .x = x, .y = y });
+	}
+
 	/* If the ParentSprite was clipped by the viewport bounds, do not draw the ChildSprites either */
-	if (_vd.last_child == LAST_CHILD_NONE) return;
+	if (_vd->last_child == LAST_CHILD_NONE) return;
 
 	/* make the sprites transparent with the right palette */
 	if (transparent) {
@@ -837,14 +1052,14 @@ void AddChildSpriteScreen(SpriteID image, PaletteID pal, int x, int y, bool tran
 		pal = PALETTE_TO_TRANSPARENT;
 	}
 
-	int32_t child_id = static_cast<int32_t>(_vd.child_screen_sprites_to_draw.size());
-	if (_vd.last_child != LAST_CHILD_PARENT) {
-		_vd.child_screen_sprites_to_draw[_vd.last_child].next = child_id;
+	int32_t child_id = static_cast<int32_t>(_vd->child_screen_sprites_to_draw.size());
+	if (_vd->last_child != LAST_CHILD_PARENT) {
+		_vd->child_screen_sprites_to_draw[_vd->last_child].next = child_id;
 	} else {
-		_vd.parent_sprites_to_draw.back().first_child = child_id;
+		_vd->parent_sprites_to_draw.back().first_child = child_id;
 	}
 
-	ChildScreenSpriteToDraw &cs = _vd.child_screen_sprites_to_draw.emplace_back();
+	ChildScreenSpriteToDraw &cs = _vd->child_screen_sprites_to_draw.emplace_back();
 	cs.image = image;
 	cs.pal = pal;
 	cs.sub = sub;
@@ -856,15 +1071,15 @@ void AddChildSpriteScreen(SpriteID image, PaletteID pal, int x, int y, bool tran
 	/* Append the sprite to the active ChildSprite list.
 	 * If the active ParentSprite is a foundation, update last_foundation_child as well.
 	 * Note: ChildSprites of foundations are NOT sequential in the vector, as selection sprites are added at last. */
-	if (_vd.last_foundation_child[0] == _vd.last_child) _vd.last_foundation_child[0] = child_id;
-	if (_vd.last_foundation_child[1] == _vd.last_child) _vd.last_foundation_child[1] = child_id;
-	_vd.last_child = child_id;
+	if (_vd->last_foundation_child[0] == _vd->last_child) _vd->last_foundation_child[0] = child_id;
+	if (_vd->last_foundation_child[1] == _vd->last_child) _vd->last_foundation_child[1] = child_id;
+	_vd->last_child = child_id;
 }
 
 static void AddStringToDraw(int x, int y, StringID string, Colours colour, uint16_t width)
 {
 	assert(width != 0);
-	StringSpriteToDraw &ss = _vd.string_sprites_to_draw.emplace_back();
+	StringSpriteToDraw &ss = _vd->string_sprites_to_draw.emplace_back();
 	ss.string = GetString(string);
 	ss.string_id = string;
 	ss.x = x;
@@ -890,7 +1105,7 @@ static void AddStringToDraw(int x, int y, StringID string, Colours colour, uint1
 static void DrawSelectionSprite(SpriteID image, PaletteID pal, const TileInfo *ti, int z_offset, FoundationPart foundation_part, int extra_offs_x = 0, int extra_offs_y = 0)
 {
 	/* FIXME: This is not totally valid for some autorail highlights that extend over the edges of the tile. */
-	if (_vd.foundation[foundation_part] == -1) {
+	if (_vd->foundation[foundation_part] == -1) {
 		/* draw on real ground */
 		AddTileSpriteToDraw(image, pal, ti->x, ti->y, ti->z + z_offset, nullptr, extra_offs_x, extra_offs_y);
 	} else {
@@ -1183,16 +1398,93 @@ static int GetViewportY(Point tile)
 	return (tile.y * (int)(TILE_PIXELS / 2) + tile.x * (int)(TILE_PIXELS / 2) - TilePixelHeightOutsideMap(tile.x, tile.y)) << ZOOM_BASE_SHIFT;
 }
 
+/**
+ * Repeat the calls a tile made to add its sprites to the viewport.
+ * @param commands The calls.
+ */
+static void ViewportReplayTileDrawCommands(const TileDrawCommandVector &commands)
+{
+	for (const TileDrawCommand &cmd : commands) {
+		switch (cmd.call) {
+			case TileDrawCall::GroundSprite:
+				DrawGroundSpriteAt(cmd.image, cmd.pal, cmd.x, cmd.y, cmd.z, cmd.sub, cmd.w, cmd.h);
+				break;
+
+			case TileDrawCall::OffsetGroundSprite:
+				OffsetGroundSprite(cmd.x, cmd.y);
+				break;
+
+			case TileDrawCall::SortableSprite:
+				AddSortableSpriteToDraw(cmd.image, cmd.pal, cmd.x, cmd.y, cmd.w, cmd.h, cmd.dz, cmd.z, cmd.transparent, cmd.bb_offset_x, cmd.bb_offset_y, cmd.bb_offset_z, cmd.sub);
+				break;
+
+			case TileDrawCall::ChildSprite:
+				AddChildSpriteScreen(cmd.image, cmd.pal, cmd.x, cmd.y, cmd.transparent, cmd.sub, cmd.scale, cmd.relative);
+				break;
+
+			case TileDrawCall::StartSpriteCombine:
+				StartSpriteCombine();
+				break;
+
+			case TileDrawCall::EndSpriteCombine:
+				EndSpriteCombine();
+				break;
+
+			default: NOT_REACHED();
+		}
+	}
+}
+
+/**
+ * Callback to find any vehicle on a tile.
+ * @param v The vehicle.
+ * @return The vehicle.
+ */
+static Vehicle *FindVehicleOnTileProc(Vehicle *v, void *)
+{
+	return v;
+}
+
+/**
+ * Add the sprites of the current tile, #_cur_ti, to the viewport.
+ * Resolving the sprites of a tile can be costly, e.g. for foundations and NewGRF sprite groups,
+ * so the calls the tile makes to add its sprites are kept in the tile draw cache and repeated
+ * instead, until the tile is marked dirty. Tiles with vehicles on them are resolved every time,
+ * as their sprites might depend on the vehicles.
+ * @param tile_type The type of the current tile.
+ */
+static void ViewportAddTile(TileType tile_type)
+{
+	DrawTileProc *draw_tile_proc = _tile_type_procs[tile_type]->draw_tile_proc;
+	if (_cur_ti.tile == INVALID_TILE || HasVehicleOnPos(_cur_ti.tile, nullptr, &FindVehicleOnTileProc)) {
+		draw_tile_proc(&_cur_ti);
+		return;
+	}
+
+	const TileDrawCommandVector *commands = _tile_draw_cache.Find(_vd->dpi.zoom, _cur_ti.tile.base(), _transparency_opt);
+	if (commands != nullptr) {
+		ViewportReplayTileDrawCommands(*commands);
+		return;
+	}
+
+	_vd->tile_draw_commands.clear();
+	_vd->record_tile_draw_commands = true;
+	draw_tile_proc(&_cur_ti);
+	_vd->record_tile_draw_commands = false;
+
+	_tile_draw_cache.Insert(_vd->dpi.zoom, _cur_ti.tile.base(), _transparency_opt, _vd->tile_draw_commands);
+}
+
 /**
  * Add the landscape to the viewport, i.e. all ground tiles and buildings.
  */
 static void ViewportAddLandscape()
 {
-	assert(_vd.dpi.top <= _vd.dpi.top + _vd.dpi.height);
-	assert(_vd.dpi.left <= _vd.dpi.left + _vd.dpi.width);
+	assert(_vd->dpi.top <= _vd->dpi.top + _vd->dpi.height);
+	assert(_vd->dpi.left <= _vd->dpi.left + _vd->dpi.width);
 
-	Point upper_left = InverseRemapCoords(_vd.dpi.left, _vd.dpi.top);
-	Point upper_right = InverseRemapCoords(_vd.dpi.left + _vd.dpi.width, _vd.dpi.top);
+	Point upper_left = InverseRemapCoords(_vd->dpi.left, _vd->dpi.top);
+	Point upper_right = InverseRemapCoords(_vd->dpi.left + _vd->dpi.width, _vd->dpi.top);
 
 	/* Transformations between tile coordinates and viewport rows/columns: See vp_column_row
 	 *   column = y - x
@@ -1253,14 +1545,14 @@ static void ViewportAddLandscape()
 
 			int viewport_y = GetViewportY(tilecoord);
 
-			if (viewport_y + MAX_TILE_EXTENT_BOTTOM < _vd.dpi.top) {
+			if (viewport_y + MAX_TILE_EXTENT_BOTTOM < _vd->dpi.top) {
 				/* The tile in this column is not visible yet.
 				 * Tiles in other columns may be visible, but we need more rows in any case. */
 				last_row = false;
 				continue;
 			}
 
-			int min_visible_height = viewport_y - (_vd.dpi.top + _vd.dpi.height);
+			int min_visible_height = viewport_y - (_vd->dpi.top + _vd->dpi.height);
 			bool tile_visible = min_visible_height <= 0;
 
 			if (tile_type != MP_VOID) {
@@ -1285,13 +1577,13 @@ static void ViewportAddLandscape()
 
 			if (tile_visible) {
 				last_row = false;
-				_vd.foundation_part = FOUNDATION_PART_NONE;
-				_vd.foundation[0] = -1;
-				_vd.foundation[1] = -1;
-				_vd.last_foundation_child[0] = LAST_CHILD_NONE;
-				_vd.last_foundation_child[1] = LAST_CHILD_NONE;
+				_vd->foundation_part = FOUNDATION_PART_NONE;
+				_vd->foundation[0] = -1;
+				_vd->foundation[1] = -1;
+				_vd->last_foundation_child[0] = LAST_CHILD_NONE;
+				_vd->last_foundation_child[1] = LAST_CHILD_NONE;
 
-				_tile_type_procs[tile_type]->draw_tile_proc(&_cur_ti);
+				ViewportAddTile(tile_type);
 				if (_cur_ti.tile != INVALID_TILE) DrawTileSelection(&_cur_ti);
 			}
 		}
@@ -1517,7 +1809,7 @@ void ViewportSign::MarkDirty(ZoomLevel maxzoom) const
 static void ViewportDrawTileSprites(const TileSpriteToDrawVector *tstdv)
 {
 	for (const TileSpriteToDraw &ts : *tstdv) {
-		DrawSpriteViewport(ts.image, ts.pal, ts.x, ts.y, ts.sub);
+		if (ts.image != SPR_EMPTY_BOUNDING_BOX) DrawSpriteViewport(ts.image, ts.pal, ts.x, ts.y, ts.sub);
 	}
 }
 
@@ -1657,6 +1949,7 @@ static void ViewportDrawParentSprites(const ParentSpriteToSortVector *psd, const
 		while (child_idx >= 0) {
 			const ChildScreenSpriteToDraw *cs = csstdv->data() + child_idx;
 			child_idx = cs->next;
+			if (cs->image == SPR_EMPTY_BOUNDING_BOX) continue;
 			if (cs->relative) {
 				DrawSpriteViewport(cs->image, cs->pal, ps->left + cs->x, ps->top + cs->y, cs->sub);
 			} else {
@@ -1737,71 +2030,250 @@ static void ViewportDrawStrings(ZoomLevel zoom, const StringSpriteToDrawVector *
 	}
 }
 
-void ViewportDoDraw(const Viewport *vp, int left, int top, int right, int bottom)
+/**
+ * Prepare a drawer for drawing a part of a viewport.
+ * @param vd The drawer.
+ * @param vp The viewport to draw.
+ * @param left Left edge of the part to draw, in virtual coordinates and aligned to the zoom level of the viewport.
+ * @param top Top edge of the part to draw, in virtual coordinates and aligned to the zoom level of the viewport.
+ * @param width Width of the part to draw, in virtual coordinates and aligned to the zoom level of the viewport.
+ * @param height Height of the part to draw, in virtual coordinates and aligned to the zoom level of the viewport.
+ * @param sprite_loading How to deal with sprites that are not in the sprite cache.
+ * @return The top left of the part to draw, in coordinates of the current #_cur_dpi.
+ */
+static Point ViewportInitDrawer(ViewportDrawer &vd, const Viewport *vp, int left, int top, int width, int height, ViewportSpriteLoading sprite_loading)
 {
-	_vd.dpi.zoom = vp->zoom;
 	int mask = ScaleByZoom(-1, vp->zoom);
 
-	_vd.combine_sprites = SPRITE_COMBINE_NONE;
+	vd.dpi.zoom = vp->zoom;
+	vd.dpi.width = width;
+	vd.dpi.height = height;
+	vd.dpi.left = left;
+	vd.dpi.top = top;
+	vd.dpi.pitch = _cur_dpi->pitch;
+	vd.combine_sprites = SPRITE_COMBINE_NONE;
+	vd.last_child = LAST_CHILD_NONE;
+	vd.sprite_loading = sprite_loading;
+	vd.sprites_left_out = false;
+
+	int x = UnScaleByZoom(left - (vp->virtual_left & mask), vp->zoom) + vp->left;
+	int y = UnScaleByZoom(top - (vp->virtual_top & mask), vp->zoom) + vp->top;
+
+	vd.dpi.dst_ptr = BlitterFactory::GetCurrentBlitter()->MoveTo(_cur_dpi->dst_ptr, x - _cur_dpi->left, y - _cur_dpi->top);
+	return { x, y };
+}
 
-	_vd.dpi.width = (right - left) & mask;
-	_vd.dpi.height = (bottom - top) & mask;
-	_vd.dpi.left = left & mask;
-	_vd.dpi.top = top & mask;
-	_vd.dpi.pitch = _cur_dpi->pitch;
-	_vd.last_child = LAST_CHILD_NONE;
+/**
+ * Collect all sprites and strings within the area of a drawer.
+ * @param vd The drawer.
+ */
+static void ViewportCollectSprites(ViewportDrawer &vd)
+{
+	AutoRestoreBackup vd_backup(_vd, &vd);
+	AutoRestoreBackup dpi_backup(_cur_dpi, &vd.dpi);
 
-	int x = UnScaleByZoom(_vd.dpi.left - (vp->virtual_left & mask), vp->zoom) + vp->left;
-	int y = UnScaleByZoom(_vd.dpi.top - (vp->virtual_top & mask), vp->zoom) + vp->top;
+	ViewportAddLandscape();
+	ViewportAddVehicles(&vd.dpi);
 
-	_vd.dpi.dst_ptr = BlitterFactory::GetCurrentBlitter()->MoveTo(_cur_dpi->dst_ptr, x - _cur_dpi->left, y - _cur_dpi->top);
-	AutoRestoreBackup dpi_backup(_cur_dpi, &_vd.dpi);
+	ViewportAddKdtreeSigns(&vd.dpi);
 
-	ViewportAddLandscape();
-	ViewportAddVehicles(&_vd.dpi);
+	DrawTextEffects(&vd.dpi);
 
-	ViewportAddKdtreeSigns(&_vd.dpi);
+	for (auto &psd : vd.parent_sprites_to_draw) {
+		vd.parent_sprites_to_sort.push_back(&psd);
+	}
+}
+
+/**
+ * Sort and draw the sprites collected by a drawer.
+ * This does not change any state besides the pixels of the area of the drawer, so drawers
+ * of different areas can be drawn at the same time, as long as the sprite cache does not change.
+ * @param vd The drawer.
+ */
+static void ViewportDrawSprites(ViewportDrawer &vd)
+{
+	AutoRestoreBackup dpi_backup(_cur_dpi, &vd.dpi);
+
+	if (!vd.tile_sprites_to_draw.empty()) ViewportDrawTileSprites(&vd.tile_sprites_to_draw);
+
+	_vp_sprite_sorter(&vd.parent_sprites_to_sort);
+	ViewportDrawParentSprites(&vd.parent_sprites_to_sort, &vd.child_screen_sprites_to_draw);
+}
+
+/**
+ * Request the sprites the drawers are going to draw, and leave out the ones that are still being loaded in the background.
+ * @param drawers The drawers.
+ * @return True iff sprites were left out.
+ */
+static bool ViewportRequestSprites(std::span<ViewportDrawer> drawers)
+{
+	bool left_out = false;
+	for (ViewportDrawer &vd : drawers) {
+		auto request = [&vd](SpriteID &image, PaletteID pal) {
+			if (image == SPR_EMPTY_BOUNDING_BOX || RequestSpriteViewport(image, pal)) return true;
+			image = SPR_EMPTY_BOUNDING_BOX;
+			vd.sprites_left_out = true;
+			return false;
+		};
+
+		for (TileSpriteToDraw &ts : vd.tile_sprites_to_draw) request(ts.image, ts.pal);
+		for (ChildScreenSpriteToDraw &cs : vd.child_screen_sprites_to_draw) request(cs.image, cs.pal);
+		for (ParentSpriteToDraw &ps : vd.parent_sprites_to_draw) {
+			if (request(ps.image, ps.pal)) continue;
+
+			/* Children might be positioned relative to the sprite, which is not known without it, so leave them out too. */
+			for (int i = ps.first_child; i >= 0; i = vd.child_screen_sprites_to_draw[i].next) {
+				vd.child_screen_sprites_to_draw[i].image = SPR_EMPTY_BOUNDING_BOX;
+			}
+		}
 
-	DrawTextEffects(&_vd.dpi);
+		left_out |= vd.sprites_left_out;
+	}
+	return left_out;
+}
 
-	if (!_vd.tile_sprites_to_draw.empty()) ViewportDrawTileSprites(&_vd.tile_sprites_to_draw);
+/**
+ * Make sure all sprites the drawers are going to draw are in the sprite cache.
+ * @param drawers The drawers.
+ * @return True iff all sprites are in the sprite cache, so the sprite cache can be made read-only while drawing.
+ */
+static bool ViewportPreloadSprites(std::span<ViewportDrawer> drawers)
+{
+	/* Loading sprites might remove other sprites from the cache, so only check once all are loaded. */
+	for (int pass = 0; pass < 2; pass++) {
+		auto sprite = [pass](SpriteID image, PaletteID pal) {
+			if (pass == 0) {
+				PreloadSpriteViewport(image, pal);
+				return true;
+			}
+			return IsSpriteViewportCached(image, pal);
+		};
 
-	for (auto &psd : _vd.parent_sprites_to_draw) {
-		_vd.parent_sprites_to_sort.push_back(&psd);
+		for (const ViewportDrawer &vd : drawers) {
+			for (const TileSpriteToDraw &ts : vd.tile_sprites_to_draw) {
+				if (!sprite(ts.image, ts.pal)) return false;
+			}
+			for (const ParentSpriteToDraw &ps : vd.parent_sprites_to_draw) {
+				if (!sprite(ps.image, ps.pal)) return false;
+			}
+			for (const ChildScreenSpriteToDraw &cs : vd.child_screen_sprites_to_draw) {
+				if (!sprite(cs.image, cs.pal)) return false;
+			}
+		}
 	}
+	return true;
+}
 
-	_vp_sprite_sorter(&_vd.parent_sprites_to_sort);
-	ViewportDrawParentSprites(&_vd.parent_sprites_to_sort, &_vd.child_screen_sprites_to_draw);
+/**
+ * Forget the sprites and strings a drawer collected, keeping the memory around for the next time.
+ * @param vd The drawer.
+ */
+static void ViewportClearDrawer(ViewportDrawer &vd)
+{
+	vd.string_sprites_to_draw.clear();
+	vd.tile_sprites_to_draw.clear();
+	vd.parent_sprites_to_draw.clear();
+	vd.parent_sprites_to_sort.clear();
+	vd.child_screen_sprites_to_draw.clear();
+}
 
-	if (_draw_bounding_boxes) ViewportDrawBoundingBoxes(&_vd.parent_sprites_to_sort);
-	if (_draw_dirty_blocks) ViewportDrawDirtyBlocks();
+/**
+ * Draw a part of a viewport.
+ * Large parts are split into tiles, each with its own drawer. The sprites of all tiles
+ * are collected first, after which the sorting and drawing of the sprites is done for
+ * all tiles at the same time. Everything else is drawn afterwards, one tile at a time.
+ * @param vp The viewport to draw.
+ * @param left Left edge of the part to draw, in virtual coordinates.
+ * @param top Top edge of the part to draw, in virtual coordinates.
+ * @param right Right edge of the part to draw, in virtual coordinates.
+ * @param bottom Bottom edge of the part to draw, in virtual coordinates.
+ * @param load_in_background Whether to leave out sprites that are not in the sprite cache while they are loaded in the background, instead of waiting for them.
+ * @return True iff sprites were left out, so the part has to be drawn again once they are loaded.
+ */
+bool ViewportDoDraw(const Viewport *vp, int left, int top, int right, int bottom, bool load_in_background)
+{
+	static WorkerPool pool("ottd:viewport");
+
+	ZoomLevel zoom = vp->zoom;
+	int mask = ScaleByZoom(-1, zoom);
+
+	int width = (right - left) & mask;
+	int height = (bottom - top) & mask;
+	left &= mask;
+	top &= mask;
+
+	/* Only split the area in tiles when there are other threads to draw them. */
+	int tile_width = std::max(width, 1);
+	int tile_height = std::max(height, 1);
+	/* The sprite picker has to see all sprites. */
+	ViewportSpriteLoading sprite_loading = ViewportSpriteLoading::Wait;
+	if (load_in_background && _newgrf_debug_sprite_picker.mode != SPM_REDRAW) sprite_loading = ViewportSpriteLoading::Background;
+
+	if (pool.GetThreadCount() > 1 && _newgrf_debug_sprite_picker.mode != SPM_REDRAW) {
+		tile_width = std::max(ScaleByZoom(VIEWPORT_DRAW_TILE_WIDTH, zoom), 1);
+		tile_height = std::max(ScaleByZoom(VIEWPORT_DRAW_TILE_HEIGHT, zoom), 1);
+	}
+	uint columns = std::max<uint>(CeilDiv(width, tile_width), 1);
+	uint rows = std::max<uint>(CeilDiv(height, tile_height), 1);
+
+	if (_viewport_drawers.size() < columns * rows) _viewport_drawers.resize(columns * rows);
+	std::span<ViewportDrawer> drawers = std::span(_viewport_drawers).first(columns * rows);
+
+	Point pt{};
+	for (uint i = 0; i < drawers.size(); i++) {
+		int tile_left = (i % columns) * tile_width;
+		int tile_top = (i / columns) * tile_height;
+		Point tile_pt = ViewportInitDrawer(drawers[i], vp, left + tile_left, top + tile_top, std::min(tile_width, width - tile_left), std::min(tile_height, height - tile_top), sprite_loading);
+		if (i == 0) pt = tile_pt;
+		ViewportCollectSprites(drawers[i]);
+	}
 
-	DrawPixelInfo dp = _vd.dpi;
-	ZoomLevel zoom = _vd.dpi.zoom;
-	dp.zoom = ZOOM_LVL_MIN;
-	dp.width = UnScaleByZoom(dp.width, zoom);
-	dp.height = UnScaleByZoom(dp.height, zoom);
-	_cur_dpi = &dp;
+	bool left_out = sprite_loading == ViewportSpriteLoading::Background && ViewportRequestSprites(drawers);
+
+	if (drawers.size() > 1 && ViewportPreloadSprites(drawers)) {
+		SetSpriteCacheReadOnly(true);
+		pool.Run(drawers.size(), [drawers](size_t i) { ViewportDrawSprites(drawers[i]); });
+		SetSpriteCacheReadOnly(false);
+	} else {
+		for (ViewportDrawer &vd : drawers) ViewportDrawSprites(vd);
+	}
+
+	for (ViewportDrawer &vd : drawers) {
+		AutoRestoreBackup dpi_backup(_cur_dpi, &vd.dpi);
+		if (_draw_bounding_boxes) ViewportDrawBoundingBoxes(&vd.parent_sprites_to_sort);
+		if (_draw_dirty_blocks) ViewportDrawDirtyBlocks();
+	}
+
+	DrawPixelInfo dp{};
+	AutoRestoreBackup dpi_backup(_cur_dpi, &dp);
 
 	if (vp->overlay != nullptr && vp->overlay->GetCargoMask() != 0 && vp->overlay->GetCompanyMask() != 0) {
 		/* translate to window coordinates */
-		dp.left = x;
-		dp.top = y;
+		dp = drawers[0].dpi;
+		dp.zoom = ZOOM_LVL_MIN;
+		dp.left = pt.x;
+		dp.top = pt.y;
+		dp.width = UnScaleByZoom(width, zoom);
+		dp.height = UnScaleByZoom(height, zoom);
 		vp->overlay->Draw(&dp);
 	}
 
-	if (!_vd.string_sprites_to_draw.empty()) {
-		/* translate to world coordinates */
-		dp.left = UnScaleByZoom(_vd.dpi.left, zoom);
-		dp.top = UnScaleByZoom(_vd.dpi.top, zoom);
-		ViewportDrawStrings(zoom, &_vd.string_sprites_to_draw);
+	for (ViewportDrawer &vd : drawers) {
+		if (!vd.string_sprites_to_draw.empty()) {
+			/* translate to world coordinates */
+			dp = vd.dpi;
+			dp.zoom = ZOOM_LVL_MIN;
+			dp.left = UnScaleByZoom(vd.dpi.left, zoom);
+			dp.top = UnScaleByZoom(vd.dpi.top, zoom);
+			dp.width = UnScaleByZoom(vd.dpi.width, zoom);
+			dp.height = UnScaleByZoom(vd.dpi.height, zoom);
+			ViewportDrawStrings(zoom, &vd.string_sprites_to_draw);
+		}
+
+		ViewportClearDrawer(vd);
 	}
 
-	_vd.string_sprites_to_draw.clear();
-	_vd.tile_sprites_to_draw.clear();
-	_vd.parent_sprites_to_draw.clear();
-	_vd.parent_sprites_to_sort.clear();
-	_vd.child_screen_sprites_to_draw.clear();
+	return left_out;
 }
 
 static inline void ViewportDraw(const Viewport *vp, int left, int top, int right, int bottom)
@@ -1818,12 +2290,32 @@ static inline void ViewportDraw(const Viewport *vp, int left, int top, int right
 	if (top < vp->top) top = vp->top;
 	if (bottom > vp->top + vp->height) bottom = vp->top + vp->height;
 
-	ViewportDoDraw(vp,
+	bool left_out = ViewportDoDraw(vp,
 		ScaleByZoom(left - vp->left, vp->zoom) + vp->virtual_left,
 		ScaleByZoom(top - vp->top, vp->zoom) + vp->virtual_top,
 		ScaleByZoom(right - vp->left, vp->zoom) + vp->virtual_left,
-		ScaleByZoom(bottom - vp->top, vp->zoom) + vp->virtual_top
+		ScaleByZoom(bottom - vp->top, vp->zoom) + vp->virtual_top,
+		true
 	);
+
+	if (left_out) _viewport_sprites_left_out.push_back({left, top, right, bottom});
+}
+
+/**
+ * Add the sprites that have been loaded in the background to the sprite cache, bring the
+ * cache back within its budget, and redraw the parts of viewports that were drawn without them.
+ */
+void UpdateViewportSpriteLoads()
+{
+	bool loaded = ProcessLoadedSprites() > 0;
+	TrimSpriteCache();
+	if (_viewport_sprites_left_out.empty()) return;
+
+	/* Do not redraw the same areas every frame while waiting for the sprites. */
+	if (!loaded && IsLoadingSprites()) return;
+
+	for (const Rect &r : _viewport_sprites_left_out) AddDirtyBlock(r.left, r.top, r.right, r.bottom);
+	_viewport_sprites_left_out.clear();
 }
 
 /**
@@ -1909,6 +2401,71 @@ static void ClampSmoothScroll(uint32_t delta_ms, int64_t delta_hi, int64_t delta
 	}
 }
 
+/**
+ * Request the sprites of a part of a viewport to be loaded in the background.
+ * @param vp The viewport.
+ * @param left Left edge of the part, in virtual coordinates.
+ * @param top Top edge of the part, in virtual coordinates.
+ * @param width Width of the part, in virtual coordinates.
+ * @param height Height of the part, in virtual coordinates.
+ */
+static void ViewportPrefetchSprites(const Viewport *vp, int left, int top, int width, int height)
+{
+	static ViewportDrawer vd;
+
+	/* Nothing is drawn, so there is no need for a place to draw into. */
+	int mask = ScaleByZoom(-1, vp->zoom);
+	vd.dpi = {};
+	vd.dpi.zoom = vp->zoom;
+	vd.dpi.left = left & mask;
+	vd.dpi.top = top & mask;
+	vd.dpi.width = width & mask;
+	vd.dpi.height = height & mask;
+	vd.combine_sprites = SPRITE_COMBINE_NONE;
+	vd.last_child = LAST_CHILD_NONE;
+	vd.sprite_loading = ViewportSpriteLoading::Prefetch;
+	vd.sprites_left_out = false;
+
+	ViewportCollectSprites(vd);
+
+	for (const TileSpriteToDraw &ts : vd.tile_sprites_to_draw) PrefetchSprite(GB(ts.image, 0, SPRITE_WIDTH));
+	for (const ParentSpriteToDraw &ps : vd.parent_sprites_to_draw) PrefetchSprite(GB(ps.image, 0, SPRITE_WIDTH));
+	for (const ChildScreenSpriteToDraw &cs : vd.child_screen_sprites_to_draw) PrefetchSprite(GB(cs.image, 0, SPRITE_WIDTH));
+
+	ViewportClearDrawer(vd);
+}
+
+/**
+ * When a viewport scrolls, request the sprites just beyond its edges in the direction it scrolls
+ * to be loaded in the background, so they are likely loaded by the time they come into view.
+ * @param vp The viewport.
+ */
+static void PrefetchViewportSprites(ViewportData *vp)
+{
+	int delta_x = vp->virtual_left - vp->prefetch_left;
+	int delta_y = vp->virtual_top - vp->prefetch_top;
+	int margin_x = vp->virtual_width / VIEWPORT_PREFETCH_FRACTION;
+	int margin_y = vp->virtual_height / VIEWPORT_PREFETCH_FRACTION;
+
+	/* Wait until half of the previously prefetched part came into view. */
+	if (abs(delta_x) <= margin_x / 2 && abs(delta_y) <= margin_y / 2) return;
+
+	vp->prefetch_left = vp->virtual_left;
+	vp->prefetch_top = vp->virtual_top;
+
+	/* The viewport jumped instead of scrolled, e.g. because it was zoomed, so there is no direction to prefetch in. */
+	if (abs(delta_x) >= vp->virtual_width || abs(delta_y) >= vp->virtual_height) return;
+
+	if (delta_x != 0) {
+		int left = delta_x > 0 ? vp->virtual_left + vp->virtual_width : vp->virtual_left - margin_x;
+		ViewportPrefetchSprites(vp, left, vp->virtual_top, margin_x, vp->virtual_height);
+	}
+	if (delta_y != 0) {
+		int top = delta_y > 0 ? vp->virtual_top + vp->virtual_height : vp->virtual_top - margin_y;
+		ViewportPrefetchSprites(vp, vp->virtual_left, top, vp->virtual_width, margin_y);
+	}
+}
+
 /**
  * Update the viewport position being displayed.
  * @param w %Window owning the viewport.
@@ -1968,6 +2525,8 @@ void UpdateViewportPosition(Window *w, uint32_t delta_ms)
 		SetViewportPosition(w, w->viewport->scrollpos_x, w->viewport->scrollpos_y);
 		if (update_overlay) RebuildViewportOverlay(w);
 	}
+
+	PrefetchViewportSprites(w->viewport);
 }
 
 /**
@@ -2056,6 +2615,17 @@ void ConstrainAllViewportsZoom()
  */
 void MarkTileDirtyByTile(TileIndex tile, int bridge_level_offset, int tile_height_override)
 {
+	/* The sprites of a tile often depend on its neighbours, e.g. for foundations, fences and catenary. */
+	if (!_tile_draw_cache.IsEmpty()) {
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				uint x = TileX(tile) + dx;
+				uint y = TileY(tile) + dy;
+				if (x < Map::SizeX() && y < Map::SizeY()) InvalidateTileDrawCache(TileXY(x, y));
+			}
+		}
+	}
+
 	Point pt = RemapCoords(TileX(tile) * TILE_SIZE, TileY(tile) * TILE_SIZE, tile_height_override * TILE_HEIGHT);
 	MarkAllViewportsDirty(
 			pt.x - MAX_TILE_EXTENT_LEFT,
@@ -2064,6 +2634,24 @@ void MarkTileDirtyByTile(TileIndex tile, int bridge_level_offset, int tile_heigh
 			pt.y + MAX_TILE_EXTENT_BOTTOM);
 }
 
+/**
+ * Forget the sprites of a tile in the tile draw cache, so they are resolved again the next time the tile is drawn.
+ * Use this when the tile is going to look different without marking it dirty, e.g. for NewGRF random bits.
+ * @param tile The tile.
+ */
+void InvalidateTileDrawCache(TileIndex tile)
+{
+	_tile_draw_cache.Erase(tile.base());
+}
+
+/**
+ * Forget the sprites of all tiles in the tile draw cache, e.g. as the map or what is shown of it changed.
+ */
+void ClearTileDrawCache()
+{
+	_tile_draw_cache.Clear();
+}
+
 /**
  * Marks the selected tiles as dirty.
  *
@@ -65,7 +65,8 @@ void SetRedErrorSquare(TileIndex tile);
 void SetTileSelectSize(int w, int h);
 void SetTileSelectBigSize(int ox, int oy, int sx, int sy);
 
-void ViewportDoDraw(const Viewport *vp, int left, int top, int right, int bottom);
+bool ViewportDoDraw(const Viewport *vp, int left, int top, int right, int bottom, bool load_in_background = false);
+void UpdateViewportSpriteLoads();
 
 bool ScrollWindowToTile(TileIndex tile, Window *w, bool instant = false);
 bool ScrollWindowTo(int x, int y, int z, Window *w, bool instant = false);
@@ -81,6 +82,8 @@ void ClearAllCachedNames();
 extern Point _tile_fract_coords;
 
 void MarkTileDirtyByTile(TileIndex tile, int bridge_level_offset, int tile_height_override);
+void InvalidateTileDrawCache(TileIndex tile);
+void ClearTileDrawCache();
 
 /**
  * Mark a tile given by its index dirty for repaint.
@@ -3074,6 +3074,7 @@ void UpdateWindows()
 	 * But still empty the invalidation queues above. */
 	if (_network_dedicated) return;
 
+	UpdateViewportSpriteLoads();
 	DrawDirtyBlocks();
 
 	for (Window *w : Window::Iterate()) {
@@ -0,0 +1,119 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file worker_pool.cpp Implementation of the pool of threads that stay around to do work in parallel. */
+
+#include "stdafx.h"
+#include "thread.h"
+#include "worker_pool.h"
+
+#include "safeguards.h"
+
+/**
+ * Create a pool; the helper threads are only started when the first job is run.
+ * @param name Name of the helper threads.
+ * @param max_threads Maximum number of threads to do a job with, including the calling thread; 0 for the number of cores.
+ */
+WorkerPool::WorkerPool(const char *name, uint max_threads) : name(name), max_threads(max_threads)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->exit = true;
+	}
+	this->job_start.notify_all();
+
+	for (std::thread &thread : this->threads) thread.join();
+}
+
+/** Start the helper threads, if that has not been done yet. */
+void WorkerPool::StartThreads()
+{
+	if (this->started) return;
+	this->started = true;
+
+	uint threads = std::max(1U, std::thread::hardware_concurrency());
+	if (this->max_threads != 0) threads = std::min(threads, this->max_threads);
+
+	for (uint i = 1; i < threads; i++) {
+		std::thread thread;
+		if (!StartNewThread(&thread, this->name, [this]() { this->HelperThread(); })) break;
+		this->threads.push_back(std::move(thread));
+	}
+}
+
+/**
+ * Get the number of threads jobs are done with, including the calling thread.
+ * This starts the helper threads when they are not running yet.
+ * @return The number of threads.
+ */
+uint WorkerPool::GetThreadCount()
+{
+	this->StartThreads();
+	return static_cast<uint>(this->threads.size()) + 1;
+}
+
+/** Do items of the current job, until all of them are taken. */
+void WorkerPool::DoItems()
+{
+	for (size_t i = this->next++; i < this->count; i = this->next++) (*this->job)(i);
+}
+
+/** Main loop of the helper threads: wait for a job, and help with it. */
+void WorkerPool::HelperThread()
+{
+	uint generation = 0;
+
+	std::unique_lock<std::mutex> lock(this->mutex);
+	for (;;) {
+		this->job_start.wait(lock, [this, generation]() { return this->exit || this->generation != generation; });
+		if (this->exit) return;
+		generation = this->generation;
+
+		lock.unlock();
+		this->DoItems();
+		lock.lock();
+
+		if (--this->busy == 0) this->job_done.notify_one();
+	}
+}
+
+/**
+ * Do a job, spread over the threads of the pool. The calling thread does its share
+ * of the work as well, and this returns once all items are done.
+ * @param count The number of items of the job.
+ * @param job Function to call with the index of each of the items.
+ */
+void WorkerPool::Run(size_t count, const Job &job)
+{
+	if (count == 0) return;
+
+	this->StartThreads();
+	if (this->threads.empty() || count == 1) {
+		for (size_t i = 0; i < count; i++) job(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->job = &job;
+		this->count = count;
+		this->next = 0;
+		this->busy = static_cast<uint>(this->threads.size());
+		this->generation++;
+	}
+	this->job_start.notify_all();
+
+	this->DoItems();
+
+	std::unique_lock<std::mutex> lock(this->mutex);
+	this->job_done.wait(lock, [this]() { return this->busy == 0; });
+	this->job = nullptr;
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file worker_pool.h A pool of threads that stay around to do work in parallel. */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * A pool of helper threads for work that is split into items that can be done in
+ * parallel, and that is done often, e.g. every frame. Unlike #RunInParallel the
+ * threads are started once and then wait for the next job, so the cost of starting
+ * threads is not paid for every job.
+ * The pool may only be used by one thread at a time.
+ */
+class WorkerPool {
+public:
+	/** Function doing a single item of a job; it is called with the index of the item, and may not throw. */
+	using Job = std::function<void(size_t)>;
+
+	WorkerPool(const char *name, uint max_threads = 0);
+	~WorkerPool();
+
+	void Run(size_t count, const Job &job);
+	uint GetThreadCount();
+
+private:
+	const char *name;  ///< Name of the helper threads.
+	uint max_threads;  ///< Maximum number of threads to do a job with, including the calling thread; 0 for the number of cores.
+	bool started = false; ///< Whether the helper threads have been started.
+	std::vector<std::thread> threads; ///< The helper threads.
+
+	std::mutex mutex;                  ///< Mutex protecting the state of the current job.
+	std::condition_variable job_start; ///< Signalled when there is a new job, or when the helper threads have to exit.
+	std::condition_variable job_done;  ///< Signalled when the last helper thread is done with the current job.
+	const Job *job = nullptr;          ///< The current job.
+	size_t count = 0;                  ///< Number of items of the current job.
+	std::atomic<size_t> next = 0;      ///< The next item of the current job to do.
+	uint busy = 0;                     ///< Number of helper threads still working on the current job.
+	uint generation = 0;               ///< Number of the current job, so helper threads know a new job has been started.
+	bool exit = false;                 ///< Whether the helper threads have to exit.
+
+	void StartThreads();
+	void HelperThread();
+	void DoItems();
+};
+
+#endif /* WORKER_POOL_H */